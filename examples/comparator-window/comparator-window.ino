@@ -0,0 +1,56 @@
+#include "ADS1X15.h"
+#include <Arduino.h>
+#include <Wire.h>
+
+using namespace ADS1X15;
+
+ADS1015<TwoWire> ads(Wire); /* Use this for the 12-bit version */
+// ADS1115<TwoWire> ads(Wire); /* Use this for the 16-bit version */
+
+// Pin connected to the ALERT/RDY signal.
+constexpr int ALERT_PIN = 3;
+
+// This is required on ESP32 to put the ISR in IRAM. Define as
+// empty for other platforms. Be careful - other platforms may have
+// other requirements.
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+volatile bool alerted = false;
+void IRAM_ATTR AlertISR() { alerted = true; }
+
+void setup(void) {
+  Serial.begin(9600);
+  Serial.println("Hello!");
+
+  Serial.println("Watching AIN0 for readings outside 1.0V to 2.0V");
+
+  ads.begin();
+  ads.setGain(Gain::ONE_4096MV);
+  ads.setDataRate(Rate::ADS1015_250SPS);
+
+  pinMode(ALERT_PIN, INPUT_PULLUP);
+  // ALERT/RDY is active low: it falls when the input leaves the window.
+  attachInterrupt(digitalPinToInterrupt(ALERT_PIN), AlertISR, FALLING);
+
+  // Window comparator, latching, asserting after two successive out-of-window conversions so single spikes are
+  // ignored. The chip checks every conversion; the sketch only hears about it when something happens.
+  ComparatorConfig window = ComparatorConfig::singleEnded(0, ads.computeCount(1.0), ads.computeCount(2.0))
+                                .withMode(ComparatorMode::WINDOW)
+                                .withQueue(ComparatorQueue::TWO_CONVERSIONS);
+  if (ads.startComparator(window) != Status::OK) { Serial.println("Failed to start comparator"); }
+}
+
+void loop(void) {
+  if (!alerted) { return; }
+  alerted = false;
+
+  // Reading the conversion releases the latched pin and tells us what tripped it.
+  ReadResult result = ads.acknowledgeAlert();
+  if (result.status != Status::OK) { return; }
+
+  Serial.print("Out of window: ");
+  Serial.print(ads.computeVolts(result.value));
+  Serial.println("V");
+}
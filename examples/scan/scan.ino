@@ -0,0 +1,52 @@
+#include "ADS1X15.h"
+#include "ADS1X15ScanSequencer.h"
+#include <Arduino.h>
+#include <Wire.h>
+
+using namespace ADS1X15;
+
+ADS1015<TwoWire> ads(Wire); /* Use this for the 12-bit version */
+// ADS1115<TwoWire> ads(Wire); /* Use this for the 16-bit version */
+
+// Each entry has its own input, gain and rate. As the list is constexpr, the
+// CONFIG words are computed at compile time.
+constexpr ScanEntry SCAN_LIST[] = {
+    ScanEntry::singleEnded(0, Gain::TWOTHIRDS_6144MV, Rate::ADS1015_1600SPS),
+    ScanEntry::singleEnded(1, Gain::TWOTHIRDS_6144MV, Rate::ADS1015_1600SPS),
+    ScanEntry::singleEnded(2, Gain::ONE_4096MV, Rate::ADS1015_1600SPS),
+    ScanEntry::singleEnded(3, Gain::ONE_4096MV, Rate::ADS1015_1600SPS),
+    ScanEntry::differential(DifferentialPair::PAIR_01, Gain::SIXTEEN_256MV, Rate::ADS1015_250SPS),
+};
+
+ScanSequencer<ADS1015<TwoWire>, 5> scan(ads, SCAN_LIST);
+
+unsigned long lastPrint = 0;
+
+void setup(void) {
+  Serial.begin(9600);
+  Serial.println("Hello!");
+
+  Serial.println("Scanning AIN0..3 and AIN0-AIN1 without blocking");
+
+  ads.begin();
+  scan.start();
+}
+
+void loop(void) {
+  // poll() never waits for a conversion; the rest of loop() keeps running.
+  scan.poll();
+
+  if (millis() - lastPrint < 1000) { return; }
+  lastPrint = millis();
+
+  Serial.println("-----------------------------------------------------------");
+  for (size_t i = 0; i < scan.size(); i++) {
+    Serial.print("Entry ");
+    Serial.print(i);
+    Serial.print(": ");
+    Serial.print(scan.result(i));
+    Serial.print("  ");
+    Serial.print(scan.resultVolts(i), 4);
+    Serial.println("V");
+  }
+}
@@ -0,0 +1,75 @@
+#include "ADS1X15.h"
+#include "ADS1X15StreamReader.h"
+#include <Arduino.h>
+#include <Wire.h>
+
+using namespace ADS1X15;
+
+ADS1015<TwoWire> ads(Wire); /* Use this for the 12-bit version */
+// ADS1115<TwoWire> ads(Wire); /* Use this for the 16-bit version */
+
+// Buffer up to 64 timestamped samples between prints.
+StreamReader<ADS1015<TwoWire>, 64> reader(ads);
+
+// Pin connected to the ALERT/RDY signal for new sample notification.
+constexpr int READY_PIN = 3;
+
+// This is required on ESP32 to put the ISR in IRAM. Define as
+// empty for other platforms. Be careful - other platforms may have
+// other requirements.
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+// The Arduino Wire library can't be used inside an ISR, so the ISR only
+// records when the sample became ready. Where the I2C driver is interrupt
+// safe (or from an RTOS task woken by the ISR), call reader.onDataReady()
+// directly instead.
+volatile bool ready              = false;
+volatile uint32_t readyTimestamp = 0;
+void IRAM_ATTR NewDataReadyISR() {
+  readyTimestamp = micros();
+  ready          = true;
+}
+
+Sample samples[16];
+
+void setup(void) {
+  Serial.begin(115200);
+  Serial.println("Hello!");
+
+  Serial.println("Streaming continuous readings from AIN0");
+
+  ads.begin();
+  ads.setGain(Gain::TWOTHIRDS_6144MV);
+  ads.setDataRate(Rate::ADS1015_1600SPS);
+
+  pinMode(READY_PIN, INPUT);
+  // We get a falling edge every time a new sample is ready.
+  attachInterrupt(digitalPinToInterrupt(READY_PIN), NewDataReadyISR, FALLING);
+
+  reader.start(0);
+}
+
+void loop(void) {
+  // Producer: move the new conversion into the buffer as soon as it is ready.
+  if (ready) {
+    noInterrupts();
+    uint32_t timestamp = readyTimestamp;
+    ready              = false;
+    interrupts();
+    reader.onDataReady(timestamp);
+  }
+
+  // Consumer: take samples out in batches once enough have built up.
+  if (reader.available() < 16) { return; }
+
+  size_t n = reader.drain(samples, 16);
+  for (size_t i = 0; i < n; i++) {
+    Serial.print(samples[i].timestamp);
+    Serial.print(",");
+    Serial.println(samples[i].value);
+  }
+  Serial.print("Overruns: ");
+  Serial.println(reader.overruns());
+}
@@ -7,30 +7,267 @@
 #ifndef ADS1X15_H
 #define ADS1X15_H
 
+#include <stddef.h>
 #include <stdint.h>
 
+// Explicit SIMD paths for the batch conversions on host builds. Define ADS1X15_NO_SIMD to use the portable loops.
+#if !defined(ADS1X15_NO_SIMD) && defined(__SSE2__)
+#define ADS1X15_SIMD_SSE2
+#include <emmintrin.h>
+#elif !defined(ADS1X15_NO_SIMD) && defined(__ARM_NEON)
+#define ADS1X15_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
 namespace ADS1X15 {
 
+namespace detail {
+
+template <typename T> T&& declval();
+
+template <bool B> struct BoolTag {};
+
+/** \brief Detects whether a WIRE type supports endTransmission(false) (repeated start). */
+template <typename W> struct SupportsRepeatedStart {
+  template <typename U> static char test(decltype(declval<U&>().endTransmission(false))*);
+  template <typename U> static long test(...);
+  static constexpr bool value = sizeof(test<W>(nullptr)) == sizeof(char); ///< true if supported
+};
+
+/** \brief Detects whether a WIRE type supports buffered write(const uint8_t*, size_t). */
+template <typename W> struct SupportsBufferedWrite {
+  template <typename U>
+  static char test(decltype(declval<U&>().write(static_cast<const uint8_t*>(nullptr), static_cast<size_t>(0)))*);
+  template <typename U> static long test(...);
+  static constexpr bool value = sizeof(test<W>(nullptr)) == sizeof(char); ///< true if supported
+};
+
+template <typename T> struct IsVoid {
+  static constexpr bool value = false; ///< false for non-void types
+};
+template <> struct IsVoid<void> {
+  static constexpr bool value = true; ///< true for void
+};
+
+/** \brief Detects whether a WIRE type's endTransmission() returns a status code (Arduino TwoWire does). */
+template <typename W> struct EndTransmissionReturnsStatus {
+  static constexpr bool value = !IsVoid<decltype(declval<W&>().endTransmission())>::value; ///< true if it does
+};
+
+/** \brief Detects whether a WIRE type's requestFrom() returns the number of bytes received. */
+template <typename W> struct RequestFromReturnsCount {
+  static constexpr bool value =
+      !IsVoid<decltype(declval<W&>().requestFrom(uint8_t(), uint8_t()))>::value; ///< true if it does
+};
+
+} // namespace detail
+
+/** \brief Outcome of a bus transaction or a bounded read. */
+enum class Status : uint8_t {
+  OK,               ///< Transaction completed
+  TIMEOUT,          ///< Conversion did not complete before the deadline, or the bus timed out
+  NAK,              ///< Device did not acknowledge its address or data
+  SHORT_READ,       ///< Fewer bytes were received than requested
+  BUS_ERROR,        ///< Other I2C error reported by the WIRE implementation
+  INVALID_ARGUMENT  ///< Invalid channel; nothing was sent
+};
+
+/** \brief Result of a bounded read: a status and, when the status is OK, the conversion result. */
+struct ReadResult {
+  Status status; ///< Outcome of the read
+  int16_t value; ///< Conversion result (0 unless status is OK)
+
+  /** \brief Checks whether the read succeeded.
+   *  \return true if status is Status::OK */
+  bool ok() const { return status == Status::OK; }
+};
+
+/** \brief Maps an Arduino endTransmission() return code to a Status.
+ *  \param code 0 success, 2 address NAK, 3 data NAK, 5 timeout, anything else an error
+ *  \return Equivalent Status */
+constexpr Status statusFromEndTransmission(uint8_t code) {
+  return code == 0 ? Status::OK
+         : (code == 2 || code == 3) ? Status::NAK
+         : code == 5 ? Status::TIMEOUT
+                     : Status::BUS_ERROR;
+}
+
 constexpr int ADS1X15_ADDRESS = 0x48;
 
-enum class Rate : uint16_t {
-  ADS1015_128SPS  = 0x0000,
-  ADS1015_250SPS  = 0x0020,
-  ADS1015_490SPS  = 0x0040,
-  ADS1015_920SPS  = 0x0060,
-  ADS1015_1600SPS = 0x0080,
-  ADS1015_2400SPS = 0x00A0,
-  ADS1015_3300SPS = 0x00C0,
-  ADS1115_8SPS    = 0x0000,
-  ADS1115_16SPS   = 0x0020,
-  ADS1115_32SPS   = 0x0040,
-  ADS1115_64SPS   = 0x0060,
-  ADS1115_128SPS  = 0x0080,
-  ADS1115_250SPS  = 0x00A0,
-  ADS1115_475SPS  = 0x00C0,
-  ADS1115_860SPS  = 0x00E0
+constexpr uint32_t ADS1015_PERIOD_US[] = {
+    7813, ///< 128 SPS
+    4000, ///< 250 SPS
+    2041, ///< 490 SPS
+    1087, ///< 920 SPS
+    625,  ///< 1600 SPS
+    417,  ///< 2400 SPS
+    303,  ///< 3300 SPS
+    303   ///< 3300 SPS (DR = 111)
+}; ///< Nominal ADS1015 conversion period in microseconds, indexed by the DR bits
+
+constexpr uint32_t ADS1115_PERIOD_US[] = {
+    125000, ///< 8 SPS
+    62500,  ///< 16 SPS
+    31250,  ///< 32 SPS
+    15625,  ///< 64 SPS
+    7813,   ///< 128 SPS
+    4000,   ///< 250 SPS
+    2105,   ///< 475 SPS
+    1163    ///< 860 SPS
+}; ///< Nominal ADS1115 conversion period in microseconds, indexed by the DR bits
+
+constexpr uint32_t ADS1X15_WAKEUP_US = 25; ///< Time to power up from single-shot power-down before converting
+
+/** \brief Compile-time constants derived from a chip's resolution.
+ *  \tparam Bits ADC resolution in bits */
+template <uint8_t Bits> struct ChipResolution {
+  /** \brief ADC resolution.
+   *  \return Resolution in bits */
+  static constexpr uint8_t resolutionBits() { return Bits; }
+
+  /** \brief Right shift from the 16-bit CONVERSION register to a count.
+   *  \return Shift in bits */
+  static constexpr uint8_t shift() { return 16 - Bits; }
+
+  /** \brief Number of counts per polarity, i.e. the count equal to the PGA full-scale range.
+   *  \return 2^(Bits-1) */
+  static constexpr int32_t fullScaleCounts() { return static_cast<int32_t>(1) << (Bits - 1); }
+
+  /** \brief Largest count the chip can report.
+   *  \return Maximum count */
+  static constexpr int16_t countMax() { return static_cast<int16_t>(fullScaleCounts() - 1); }
+
+  /** \brief Smallest count the chip can report.
+   *  \return Minimum count */
+  static constexpr int16_t countMin() { return static_cast<int16_t>(-fullScaleCounts()); }
+
+  /** \brief Converts a raw CONVERSION/threshold register value to a count.
+   *
+   *  Shifts and sign-extends in straight-line code: (v ^ sign) - sign extends any width without a branch.
+   *  \param raw Register value
+   *  \return Signed count */
+  static constexpr int16_t countFromRegister(uint16_t raw) {
+    return static_cast<int16_t>(static_cast<int32_t>((raw >> shift()) ^ fullScaleCounts()) - fullScaleCounts());
+  }
+};
+
+/** \brief Chip traits for the 12-bit ADS1015. */
+struct ADS1015Traits : ChipResolution<12> {
+  /** \brief Nominal conversion period for a DR setting.
+   *  \param rateBits DR bits of the CONFIG register
+   *  \return Period in microseconds */
+  static constexpr uint32_t periodMicros(uint16_t rateBits) { return ADS1015_PERIOD_US[(rateBits >> 5) & 0x07]; }
+};
+
+/** \brief Chip traits for the 16-bit ADS1115. */
+struct ADS1115Traits : ChipResolution<16> {
+  /** \brief Nominal conversion period for a DR setting.
+   *  \param rateBits DR bits of the CONFIG register
+   *  \return Period in microseconds */
+  static constexpr uint32_t periodMicros(uint16_t rateBits) { return ADS1115_PERIOD_US[(rateBits >> 5) & 0x07]; }
 };
 
+/**
+ * \brief A data rate for a specific chip.
+ *
+ * The ADS1015 and ADS1115 use the same DR bits for different rates, so each chip has its own rate type. Giving a
+ * driver a rate meant for the other chip is a compile error.
+ *
+ * \tparam Chip Chip traits (ADS1015Traits or ADS1115Traits)
+ */
+template <typename Chip> struct ChipRate {
+  uint16_t bits; ///< DR bits of the CONFIG register
+
+  /** \brief Compares two rates.
+   *  \param other Rate to compare with
+   *  \return true if equal */
+  constexpr bool operator==(const ChipRate& other) const { return bits == other.bits; }
+
+  /** \brief Compares two rates.
+   *  \param other Rate to compare with
+   *  \return true if different */
+  constexpr bool operator!=(const ChipRate& other) const { return bits != other.bits; }
+};
+
+using ADS1015Rate = ChipRate<ADS1015Traits>; ///< Data rate of an ADS1015
+using ADS1115Rate = ChipRate<ADS1115Traits>; ///< Data rate of an ADS1115
+
+/** \brief Data rate constants, used as Rate::ADS1015_1600SPS etc.
+ *
+ *  A class template only so the constants can be defined in this header; use it through the Rate alias. */
+template <typename Unused = void> struct RateConstants {
+  static constexpr ADS1015Rate ADS1015_128SPS{0x0000};  ///< ADS1015 128 SPS
+  static constexpr ADS1015Rate ADS1015_250SPS{0x0020};  ///< ADS1015 250 SPS
+  static constexpr ADS1015Rate ADS1015_490SPS{0x0040};  ///< ADS1015 490 SPS
+  static constexpr ADS1015Rate ADS1015_920SPS{0x0060};  ///< ADS1015 920 SPS
+  static constexpr ADS1015Rate ADS1015_1600SPS{0x0080}; ///< ADS1015 1600 SPS
+  static constexpr ADS1015Rate ADS1015_2400SPS{0x00A0}; ///< ADS1015 2400 SPS
+  static constexpr ADS1015Rate ADS1015_3300SPS{0x00C0}; ///< ADS1015 3300 SPS
+  static constexpr ADS1115Rate ADS1115_8SPS{0x0000};    ///< ADS1115 8 SPS
+  static constexpr ADS1115Rate ADS1115_16SPS{0x0020};   ///< ADS1115 16 SPS
+  static constexpr ADS1115Rate ADS1115_32SPS{0x0040};   ///< ADS1115 32 SPS
+  static constexpr ADS1115Rate ADS1115_64SPS{0x0060};   ///< ADS1115 64 SPS
+  static constexpr ADS1115Rate ADS1115_128SPS{0x0080};  ///< ADS1115 128 SPS
+  static constexpr ADS1115Rate ADS1115_250SPS{0x00A0};  ///< ADS1115 250 SPS
+  static constexpr ADS1115Rate ADS1115_475SPS{0x00C0};  ///< ADS1115 475 SPS
+  static constexpr ADS1115Rate ADS1115_860SPS{0x00E0};  ///< ADS1115 860 SPS
+};
+
+/// \cond
+template <typename U> constexpr ADS1015Rate RateConstants<U>::ADS1015_128SPS;
+template <typename U> constexpr ADS1015Rate RateConstants<U>::ADS1015_250SPS;
+template <typename U> constexpr ADS1015Rate RateConstants<U>::ADS1015_490SPS;
+template <typename U> constexpr ADS1015Rate RateConstants<U>::ADS1015_920SPS;
+template <typename U> constexpr ADS1015Rate RateConstants<U>::ADS1015_1600SPS;
+template <typename U> constexpr ADS1015Rate RateConstants<U>::ADS1015_2400SPS;
+template <typename U> constexpr ADS1015Rate RateConstants<U>::ADS1015_3300SPS;
+template <typename U> constexpr ADS1115Rate RateConstants<U>::ADS1115_8SPS;
+template <typename U> constexpr ADS1115Rate RateConstants<U>::ADS1115_16SPS;
+template <typename U> constexpr ADS1115Rate RateConstants<U>::ADS1115_32SPS;
+template <typename U> constexpr ADS1115Rate RateConstants<U>::ADS1115_64SPS;
+template <typename U> constexpr ADS1115Rate RateConstants<U>::ADS1115_128SPS;
+template <typename U> constexpr ADS1115Rate RateConstants<U>::ADS1115_250SPS;
+template <typename U> constexpr ADS1115Rate RateConstants<U>::ADS1115_475SPS;
+template <typename U> constexpr ADS1115Rate RateConstants<U>::ADS1115_860SPS;
+/// \endcond
+
+using Rate = RateConstants<>; ///< Data rate constants for both chips
+
+/** \brief Gets the nominal conversion period for a data rate.
+ *  \param rate Data rate setting
+ *  \return Nominal conversion period in microseconds */
+template <typename Chip> constexpr uint32_t conversionPeriodMicros(ChipRate<Chip> rate) {
+  return Chip::periodMicros(rate.bits);
+}
+
+/** \brief Gets the shortest time a conversion can take, allowing for the oscillator running 10% fast.
+ *  \param rate Data rate setting
+ *  \return Minimum conversion time in microseconds */
+template <typename Chip> constexpr uint32_t conversionTimeMinMicros(ChipRate<Chip> rate) {
+  return conversionPeriodMicros(rate) * 10 / 11;
+}
+
+/** \brief Gets the longest time a single-shot conversion can take, allowing for the oscillator running 10% slow
+ *  and the wake-up from power-down.
+ *  \param rate Data rate setting
+ *  \return Maximum conversion time in microseconds */
+template <typename Chip> constexpr uint32_t conversionTimeMaxMicros(ChipRate<Chip> rate) {
+  return conversionPeriodMicros(rate) * 10 / 9 + ADS1X15_WAKEUP_US;
+}
+
+/** \brief User-supplied function used to sleep or yield while a conversion is in progress.
+ *
+ *  Receives the suggested wait in microseconds. It may sleep for that long (e.g. vTaskDelay, usleep) or simply
+ *  yield; the driver re-polls the device afterwards either way. */
+using DelayFunction = void (*)(uint32_t micros);
+
+/** \brief User-supplied monotonic microsecond clock (e.g. Arduino micros()) used for read deadlines.
+ *
+ *  Only differences between readings are used, so wrap-around is harmless. */
+using ClockFunction = uint32_t (*)();
+
+constexpr uint32_t ADS1X15_POLL_ESTIMATE_US = 100; ///< Assumed cost of one status poll when no clock is set
+
 enum class Gain : uint16_t {
   TWOTHIRDS_6144MV = 0x0000,
   ONE_4096MV       = 0x0200,
@@ -40,6 +277,188 @@ enum class Gain : uint16_t {
   SIXTEEN_256MV    = 0x0A00
 };
 
+constexpr uint32_t ADS1X15_RANGE_MICROVOLTS[] = {
+    6144000, ///< Gain::TWOTHIRDS_6144MV
+    4096000, ///< Gain::ONE_4096MV
+    2048000, ///< Gain::TWO_2048MV
+    1024000, ///< Gain::FOUR_1024MV
+    512000,  ///< Gain::EIGHT_512MV
+    256000,  ///< Gain::SIXTEEN_256MV
+    256000,  ///< PGA = 110
+    256000   ///< PGA = 111
+}; ///< PGA full-scale range in microvolts, indexed by the PGA bits
+
+constexpr uint8_t ADS1X15_LSB_FRACTION_BITS = 4; ///< Fractional bits of microvoltsPerLsbQ4()
+
+/** \brief Gets the size of one count, in 1/16 microvolt units.
+ *
+ *  Every range is a multiple of 256 mV = 125 * 2^11 uV, so the LSB is an exact integer in this unit for both chips:
+ *  e.g. 187.5 uV = 3000 for an ADS1115 at +/-6.144 V, and 7.8125 uV = 125 at +/-0.256 V.
+ *  \tparam Chip Chip traits
+ *  \param gain Gain setting
+ *  \return LSB size in units of 2^-ADS1X15_LSB_FRACTION_BITS microvolts */
+template <typename Chip> constexpr uint32_t microvoltsPerLsbQ4(Gain gain) {
+  return ADS1X15_RANGE_MICROVOLTS[(static_cast<uint16_t>(gain) >> 9) & 0x07] >>
+         (Chip::resolutionBits() - 1 - ADS1X15_LSB_FRACTION_BITS);
+}
+
+namespace detail {
+
+// Shifts right by ADS1X15_LSB_FRACTION_BITS, rounding halves away from zero. Branch-free so loops over it vectorize.
+inline int32_t roundQ4(int32_t scaled) {
+  return (scaled + (static_cast<int32_t>(1) << (ADS1X15_LSB_FRACTION_BITS - 1)) - (scaled < 0)) >>
+         ADS1X15_LSB_FRACTION_BITS;
+}
+
+// out[i] = in[i] * scale. Each element is the same single float multiply as the scalar conversion, so results are
+// bit-identical whichever path runs.
+inline void scaleCounts(const int16_t* in, float* out, size_t n, float scale) {
+  size_t i = 0;
+#if defined(ADS1X15_SIMD_SSE2)
+  const __m128 vscale = _mm_set1_ps(scale);
+  for (; i + 8 <= n; i += 8) {
+    __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+    __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), vscale));
+    _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), vscale));
+  }
+#elif defined(ADS1X15_SIMD_NEON)
+  for (; i + 8 <= n; i += 8) {
+    int16x8_t v = vld1q_s16(in + i);
+    vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+    vst1q_f32(out + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+  }
+#endif
+  for (; i < n; i++) { out[i] = in[i] * scale; }
+}
+
+// values[i] = round(values[i] * lsbQ4 / 16), in place. Plain loop; compilers vectorize it as written.
+inline void scaleCountsMicrovolts(int32_t* values, size_t n, int32_t lsbQ4) {
+  for (size_t i = 0; i < n; i++) { values[i] = roundQ4(values[i] * lsbQ4); }
+}
+
+} // namespace detail
+
+/**
+ * \brief Count-to-microvolt conversion for one input and gain, with offset and gain correction folded in.
+ *
+ * A conversion is one multiply, one add and one shift: (count * scale + bias) >> shift. scale is normalised to 15
+ * significant bits, so the product and the sum always fit in 32 bits. The nominal coefficients are exact for both
+ * chips at every gain. See CalibrationTable in ADS1X15Calibration.h to keep one per input and gain.
+ */
+struct Calibration {
+  int32_t bias;  ///< Rounding half minus offset * scale
+  int16_t scale; ///< Microvolts per count, times 2^shift
+  uint8_t shift; ///< Fractional bits of scale
+
+  /** \brief Converts a count to calibrated microvolts.
+   *  \param count ADC count value to convert
+   *  \return Voltage in microvolts, rounded to nearest */
+  int32_t microvolts(int16_t count) const { return (static_cast<int32_t>(count) * scale + bias) >> shift; }
+
+  /** \brief Converts a buffer of counts to calibrated microvolts in place.
+   *  \param values ADC count values on entry, microvolts on return
+   *  \param n Number of values */
+  void microvolts(int32_t* values, size_t n) const {
+    for (size_t i = 0; i < n; i++) { values[i] = (values[i] * scale + bias) >> shift; }
+  }
+
+  /** \brief Gets the offset the coefficients subtract.
+   *  \return Offset in counts, rounded to nearest */
+  int16_t offsetCounts() const {
+    int32_t half = shift > 0 ? static_cast<int32_t>(1) << (shift - 1) : 0;
+    int32_t num  = half - bias;
+    return static_cast<int16_t>((num >= 0 ? num + scale / 2 : num - scale / 2) / scale);
+  }
+
+  /** \brief Creates uncorrected coefficients: the same result as computeMicrovolts(), except that negative halves
+   *  round up rather than away from zero.
+   *  \tparam Chip Chip traits
+   *  \param gain Gain setting
+   *  \return Coefficients */
+  template <typename Chip> static Calibration nominal(Gain gain) {
+    // Every LSB is an even number of 1/16 uV units, so halving or doubling it to 15 bits is exact.
+    int32_t scale = static_cast<int32_t>(microvoltsPerLsbQ4<Chip>(gain));
+    uint8_t shift = ADS1X15_LSB_FRACTION_BITS;
+    while (scale > 32767) {
+      scale >>= 1;
+      shift--;
+    }
+    while (scale * 2 <= 32767) {
+      scale <<= 1;
+      shift++;
+    }
+    return Calibration{static_cast<int32_t>(1) << (shift - 1), static_cast<int16_t>(scale), shift};
+  }
+
+  /** \brief Gets a copy with a different offset and the same scale.
+   *  \param offsetCounts Count reported for a zero input
+   *  \return Coefficients */
+  Calibration withOffset(int16_t offsetCounts) const {
+    int32_t half = shift > 0 ? static_cast<int32_t>(1) << (shift - 1) : 0;
+    return Calibration{half - static_cast<int32_t>(offsetCounts) * scale, scale, shift};
+  }
+
+  /** \brief Creates coefficients from an offset and a gain correction factor.
+   *  \tparam Chip Chip traits
+   *  \param gain Gain setting
+   *  \param offsetCounts Count reported for a zero input
+   *  \param gainCorrection True voltage divided by the offset-corrected nominal voltage (1.0 for none)
+   *  \return Coefficients */
+  template <typename Chip> static Calibration corrected(Gain gain, int16_t offsetCounts, float gainCorrection) {
+    float lsb = static_cast<float>(microvoltsPerLsbQ4<Chip>(gain)) / (1 << ADS1X15_LSB_FRACTION_BITS);
+    return fromLsb(lsb * gainCorrection, offsetCounts);
+  }
+
+  /** \brief Creates coefficients from two measured points: a zero input and a known reference.
+   *  \param zeroCount Count reported for a zero input
+   *  \param referenceCount Count reported for the reference
+   *  \param referenceMicrovolts Reference voltage in microvolts
+   *  \return Coefficients, or a unit scale if the two counts are equal */
+  static Calibration twoPoint(int16_t zeroCount, int16_t referenceCount, int32_t referenceMicrovolts) {
+    int32_t span = static_cast<int32_t>(referenceCount) - zeroCount;
+    if (span == 0) { return fromLsb(1.0f, zeroCount); }
+    return fromLsb(static_cast<float>(referenceMicrovolts) / static_cast<float>(span), zeroCount);
+  }
+
+  /** \brief Creates coefficients from a count size and an offset.
+   *
+   *  The scale is rounded to 15 significant bits (at most 31 ppm error). Sizes outside (0, 32767] uV are clamped.
+   *  \param microvoltsPerCount Size of one count in microvolts
+   *  \param offsetCounts Count reported for a zero input
+   *  \return Coefficients */
+  static Calibration fromLsb(float microvoltsPerCount, int16_t offsetCounts) {
+    float scaled  = microvoltsPerCount;
+    uint8_t shift = 0;
+    while (shift < 24 && scaled * 2 < 32767.5f) {
+      scaled *= 2; // exact in float
+      shift++;
+    }
+    int32_t scale = static_cast<int32_t>(scaled + 0.5f);
+    if (scale < 1) { scale = 1; }
+    if (scale > 32767) { scale = 32767; }
+    return Calibration{0, static_cast<int16_t>(scale), shift}.withOffset(offsetCounts);
+  }
+};
+
+/** \brief Updates a CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) with a buffer.
+ *
+ *  Bitwise, so no lookup table is needed.
+ *  \param crc CRC so far (0xFFFF to start)
+ *  \param data Bytes to add
+ *  \param n Number of bytes
+ *  \return Updated CRC */
+inline uint16_t crc16Ccitt(uint16_t crc, const uint8_t* data, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    crc ^= static_cast<uint16_t>(data[i]) << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) != 0 ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+
 // registers
 enum class RegisterAddress : uint8_t {
   CONVERSION = 0x00,
@@ -77,6 +496,8 @@ enum class DifferentialPair : uint16_t {
   PAIR_23 = ADS1X15_REG_CONFIG_MUX_DIFF_2_3  ///< Differential P = AIN2, N = AIN3
 };
 
+constexpr uint16_t ADS1X15_REG_CONFIG_PGA_MASK = 0x0E00; ///< PGA (gain) Mask
+
 constexpr uint16_t ADS1X15_REG_CONFIG_MODE_MASK   = 0x0100; ///< Mode Mask
 constexpr uint16_t ADS1X15_REG_CONFIG_MODE_CONTIN = 0x0000; ///< Continuous conversion mode
 constexpr uint16_t ADS1X15_REG_CONFIG_MODE_SINGLE = 0x0100; ///< Power-down single-shot mode (default)
@@ -102,6 +523,247 @@ constexpr uint16_t ADS1X15_REG_CONFIG_CQUE_4CONV = 0x0002; ///< Assert ALERT/RDY
 constexpr uint16_t ADS1X15_REG_CONFIG_CQUE_NONE =
     0x0003; ///< Disable the comparator and put ALERT/RDY in high state (default)
 
+/** \brief Builds the CONFIG word that starts a conversion with ALERT/RDY in data-ready mode.
+ *  \param mux MUX bits selecting the input (e.g. ADS1X15_REG_CONFIG_MUX_SINGLE_0)
+ *  \param gain Gain setting
+ *  \param rate Data rate setting
+ *  \param continuous If true, continuous conversion mode; if false, single-shot mode
+ *  \return CONFIG register value, including the OS bit */
+template <typename Chip>
+constexpr uint16_t makeReadingConfig(uint16_t mux, Gain gain, ChipRate<Chip> rate, bool continuous) {
+  return static_cast<uint16_t>(
+      ADS1X15_REG_CONFIG_CQUE_1CONV |   // Set CQUE to any value other than
+                                        // None so we can use it in RDY mode
+      ADS1X15_REG_CONFIG_CLAT_NONLAT |  // Non-latching (default val)
+      ADS1X15_REG_CONFIG_CPOL_ACTVLOW | // Alert/Rdy active low   (default val)
+      ADS1X15_REG_CONFIG_CMODE_TRAD |   // Traditional comparator (default val)
+      (continuous ? ADS1X15_REG_CONFIG_MODE_CONTIN : ADS1X15_REG_CONFIG_MODE_SINGLE) |
+      static_cast<uint16_t>(gain) |                // PGA/voltage range
+      (rate.bits & ADS1X15_REG_CONFIG_RATE_MASK) | // Data rate
+      (mux & ADS1X15_REG_CONFIG_MUX_MASK) |        // Channels
+      ADS1X15_REG_CONFIG_OS_SINGLE);               // 'Start single-conversion' bit
+}
+
+/**
+ * \brief A precomputed conversion request: input, gain and data rate folded into one CONFIG word.
+ *
+ * Entries are constexpr-constructible, so a scan list declared constexpr has its CONFIG words computed at compile
+ * time and no per-conversion bit assembly is needed.
+ */
+struct ScanEntry {
+  uint16_t config; ///< CONFIG register value written to start the conversion
+
+  /** \brief Creates an entry for a single-ended channel.
+   *  \param channel ADC channel (0-3)
+   *  \param gain Gain setting
+   *  \param rate Data rate setting
+   *  \param continuous If true, continuous conversion mode; if false, single-shot mode
+   *  \return Scan entry */
+  template <typename Chip>
+  static constexpr ScanEntry singleEnded(uint8_t channel, Gain gain, ChipRate<Chip> rate, bool continuous = false) {
+    return ScanEntry{makeReadingConfig(MUX_BY_CHANNEL[channel & 0x03], gain, rate, continuous)};
+  }
+
+  /** \brief Creates an entry for a differential pair.
+   *  \param pair Differential input pair
+   *  \param gain Gain setting
+   *  \param rate Data rate setting
+   *  \param continuous If true, continuous conversion mode; if false, single-shot mode
+   *  \return Scan entry */
+  template <typename Chip>
+  static constexpr ScanEntry
+  differential(DifferentialPair pair, Gain gain, ChipRate<Chip> rate, bool continuous = false) {
+    return ScanEntry{makeReadingConfig(static_cast<uint16_t>(pair), gain, rate, continuous)};
+  }
+
+  /** \brief Gets the MUX bits of this entry.
+   *  \return MUX bits (ADS1X15_REG_CONFIG_MUX_*) */
+  constexpr uint16_t mux() const { return config & ADS1X15_REG_CONFIG_MUX_MASK; }
+
+  /** \brief Gets the gain of this entry.
+   *  \return Gain setting */
+  constexpr Gain gain() const { return static_cast<Gain>(config & ADS1X15_REG_CONFIG_PGA_MASK); }
+
+  /** \brief Gets a copy of this entry with a different gain.
+   *  \param newGain Gain setting
+   *  \return Entry with the PGA bits replaced */
+  constexpr ScanEntry withGain(Gain newGain) const {
+    return ScanEntry{static_cast<uint16_t>((config & ~ADS1X15_REG_CONFIG_PGA_MASK) | static_cast<uint16_t>(newGain))};
+  }
+
+  /** \brief Gets the data rate of this entry.
+   *  \tparam Chip Chip traits the entry was built for (the DR bits are interpreted per chip)
+   *  \return Rate setting */
+  template <typename Chip> constexpr ChipRate<Chip> rate() const {
+    return ChipRate<Chip>{static_cast<uint16_t>(config & ADS1X15_REG_CONFIG_RATE_MASK)};
+  }
+};
+
+/** \brief Comparator behaviour. */
+enum class ComparatorMode : uint16_t {
+  TRADITIONAL = ADS1X15_REG_CONFIG_CMODE_TRAD,  ///< Asserts above the high threshold, releases below the low one
+  WINDOW      = ADS1X15_REG_CONFIG_CMODE_WINDOW ///< Asserts above the high threshold or below the low one
+};
+
+/** \brief Active level of the ALERT/RDY pin. */
+enum class AlertPolarity : uint16_t {
+  ACTIVE_LOW  = ADS1X15_REG_CONFIG_CPOL_ACTVLOW, ///< Pin is low when active (default)
+  ACTIVE_HIGH = ADS1X15_REG_CONFIG_CPOL_ACTVHI   ///< Pin is high when active
+};
+
+/** \brief Number of successive out-of-range conversions needed to assert ALERT/RDY. */
+enum class ComparatorQueue : uint16_t {
+  ONE_CONVERSION   = ADS1X15_REG_CONFIG_CQUE_1CONV, ///< Assert after one conversion
+  TWO_CONVERSIONS  = ADS1X15_REG_CONFIG_CQUE_2CONV, ///< Assert after two conversions
+  FOUR_CONVERSIONS = ADS1X15_REG_CONFIG_CQUE_4CONV  ///< Assert after four conversions
+};
+
+/**
+ * \brief A comparator setup: input, thresholds and ALERT/RDY behaviour.
+ *
+ * Built like a ScanEntry, from singleEnded() or differential() and then adjusted with the with*() functions, all of
+ * which are constexpr. The defaults match startComparatorSingleEnded(): traditional mode, active low, latching, and
+ * asserting after one conversion. Thresholds are in counts at the gain the comparator will run at; use
+ * computeCount() or setComparatorThresholdsVolts() to work in volts.
+ */
+struct ComparatorConfig {
+  uint16_t config; ///< CONFIG bits other than PGA and DR (always continuous mode)
+  int16_t low;     ///< Low threshold in counts
+  int16_t high;    ///< High threshold in counts
+
+  /** \brief Creates a comparator on a single-ended channel.
+   *  \param channel ADC channel (0-3)
+   *  \param low Low threshold in counts
+   *  \param high High threshold in counts
+   *  \return Comparator setup */
+  static constexpr ComparatorConfig singleEnded(uint8_t channel, int16_t low, int16_t high) {
+    return ComparatorConfig{defaults(MUX_BY_CHANNEL[channel & 0x03]), low, high};
+  }
+
+  /** \brief Creates a comparator on a differential pair.
+   *  \param pair Differential input pair
+   *  \param low Low threshold in counts
+   *  \param high High threshold in counts
+   *  \return Comparator setup */
+  static constexpr ComparatorConfig differential(DifferentialPair pair, int16_t low, int16_t high) {
+    return ComparatorConfig{defaults(static_cast<uint16_t>(pair)), low, high};
+  }
+
+  /** \brief Gets a copy with a different comparator mode.
+   *  \param mode Traditional or window
+   *  \return Comparator setup */
+  constexpr ComparatorConfig withMode(ComparatorMode mode) const {
+    return with(ADS1X15_REG_CONFIG_CMODE_MASK, static_cast<uint16_t>(mode));
+  }
+
+  /** \brief Gets a copy with a different ALERT/RDY polarity.
+   *  \param polarity Active level of the pin
+   *  \return Comparator setup */
+  constexpr ComparatorConfig withPolarity(AlertPolarity polarity) const {
+    return with(ADS1X15_REG_CONFIG_CPOL_MASK, static_cast<uint16_t>(polarity));
+  }
+
+  /** \brief Gets a copy with latching turned on or off.
+   *  \param latching If true, ALERT/RDY stays asserted until the conversion register is read
+   *  \return Comparator setup */
+  constexpr ComparatorConfig withLatch(bool latching) const {
+    return with(ADS1X15_REG_CONFIG_CLAT_MASK,
+                latching ? ADS1X15_REG_CONFIG_CLAT_LATCH : ADS1X15_REG_CONFIG_CLAT_NONLAT);
+  }
+
+  /** \brief Gets a copy with a different assertion queue.
+   *  \param queue Successive out-of-range conversions needed to assert
+   *  \return Comparator setup */
+  constexpr ComparatorConfig withQueue(ComparatorQueue queue) const {
+    return with(ADS1X15_REG_CONFIG_CQUE_MASK, static_cast<uint16_t>(queue));
+  }
+
+  /** \brief Gets a copy with different thresholds.
+   *  \param newLow Low threshold in counts
+   *  \param newHigh High threshold in counts
+   *  \return Comparator setup */
+  constexpr ComparatorConfig withThresholds(int16_t newLow, int16_t newHigh) const {
+    return ComparatorConfig{config, newLow, newHigh};
+  }
+
+  /** \brief Gets the MUX bits of this setup.
+   *  \return MUX bits (ADS1X15_REG_CONFIG_MUX_*) */
+  constexpr uint16_t mux() const { return config & ADS1X15_REG_CONFIG_MUX_MASK; }
+
+  /** \brief Checks whether this setup latches.
+   *  \return true if ALERT/RDY stays asserted until acknowledged */
+  constexpr bool latching() const { return (config & ADS1X15_REG_CONFIG_CLAT_MASK) == ADS1X15_REG_CONFIG_CLAT_LATCH; }
+
+  private:
+  static constexpr uint16_t defaults(uint16_t mux) {
+    return static_cast<uint16_t>(ADS1X15_REG_CONFIG_CQUE_1CONV | ADS1X15_REG_CONFIG_CLAT_LATCH |
+                                 ADS1X15_REG_CONFIG_CPOL_ACTVLOW | ADS1X15_REG_CONFIG_CMODE_TRAD |
+                                 ADS1X15_REG_CONFIG_MODE_CONTIN | (mux & ADS1X15_REG_CONFIG_MUX_MASK));
+  }
+
+  constexpr ComparatorConfig with(uint16_t mask, uint16_t bits) const {
+    return ComparatorConfig{static_cast<uint16_t>((config & ~mask) | bits), low, high};
+  }
+};
+
+/**
+ * \brief Default instrumentation policy: every hook is an empty inline function, so instrumentation compiles out.
+ *
+ * An instrumentation policy is a class with these members. The driver inherits from it privately, so an empty policy
+ * adds no storage. See CountingInstrumentation in ADS1X15Instrumentation.h for one that records counters.
+ */
+struct NoInstrumentation {
+  /** \brief Whether the driver should read the clock to timestamp conversion events.
+   *  \return false, so no clock reads are made */
+  static constexpr bool enabled() { return false; }
+
+  /** \brief Called after each register write transaction.
+   *  \param bytes Bytes written after the address byte
+   *  \param status Outcome of the write */
+  void onRegisterWrite(uint8_t bytes, Status status) {
+    (void)bytes;
+    (void)status;
+  }
+
+  /** \brief Called after each register read, including any pointer write it needed.
+   *  \param bytesWritten Pointer bytes written (0 if the pointer was already set)
+   *  \param bytesRead Data bytes requested
+   *  \param status Outcome of the read */
+  void onRegisterRead(uint8_t bytesWritten, uint8_t bytesRead, Status status) {
+    (void)bytesWritten;
+    (void)bytesRead;
+    (void)status;
+  }
+
+  /** \brief Called when a CONFIG write has started a conversion.
+   *  \param now Clock time in microseconds (0 if no clock is set) */
+  void onConversionStart(uint32_t now) { (void)now; }
+
+  /** \brief Called after each successful check of the OS bit.
+   *  \param complete Whether the conversion had finished
+   *  \param now Clock time in microseconds (0 if no clock is set) */
+  void onConversionPoll(bool complete, uint32_t now) {
+    (void)complete;
+    (void)now;
+  }
+};
+
+/**
+ * \brief Default bus-lock policy: lock() and unlock() are empty inline functions, so locking compiles out.
+ *
+ * A bus-lock policy is a class with these two members. The driver inherits from it privately and holds the lock for
+ * each register transaction: a register write, or a pointer write with the read that follows it. Drivers of
+ * different chips on one bus can then be used from different threads or tasks, as long as their policies lock the
+ * same mutex. See MutexBusLock in ADS1X15BusLock.h.
+ */
+struct NoBusLock {
+  /** \brief Called before each register transaction. */
+  void lock() {}
+
+  /** \brief Called after each register transaction. */
+  void unlock() {}
+};
+
 /**
  * \brief Base class for ADS1015 and ADS1115 ADC chips.
  *
@@ -109,15 +771,46 @@ constexpr uint16_t ADS1X15_REG_CONFIG_CQUE_NONE =
  * This class provides all core functionality for reading ADC values, configuring gain and data rate,
  * and managing comparator operations.
  *
+ * The chip variant is a traits parameter, so resolution, sign extension, scaling and the valid data rates are all
+ * known at compile time.
+ *
  * \tparam WIRE I2C interface type (e.g., TwoWire, AceWire, SoftwareWire)
+ * \tparam Chip Chip traits (ADS1015Traits or ADS1115Traits)
+ * \tparam Instrumentation Instrumentation policy (NoInstrumentation compiles out)
+ * \tparam BusLock Bus-lock policy (NoBusLock compiles out)
  */
-template <typename WIRE> class ADS1X15 {
+template <typename WIRE, typename Chip, typename Instrumentation = NoInstrumentation, typename BusLock = NoBusLock>
+class ADS1X15 : private Instrumentation, private BusLock {
   public:
+  using Wire     = WIRE;           ///< I2C interface type
+  using Traits   = Chip;           ///< Chip traits
+  using RateType = ChipRate<Chip>; ///< Data rate type accepted by this chip
   /** \brief Initialises the ADS1X15 given its HW address.
    *  \param address I2C address of ADS1X15 (default: 0x48) */
   void begin(uint8_t address = ADS1X15_ADDRESS) {
     _i2caddr = address;
     mWire.begin();
+    invalidateRegisterCache();
+  }
+
+  /** \brief Forgets the cached CONFIG/LOTHRESH/HITHRESH values and address pointer.
+   *
+   *  The driver keeps a shadow copy of the registers it has written so that redundant writes can be skipped.
+   *  Call this if the chip may have been reset (e.g. after a brown-out or an I2C general call reset); the next
+   *  conversion will then rewrite every register it depends on. */
+  void invalidateRegisterCache() {
+    _shadowValid = 0;
+    _pointer     = POINTER_UNKNOWN;
+  }
+
+  /** \brief Reloads the cached CONFIG/LOTHRESH/HITHRESH values from the chip.
+   *
+   *  Use this instead of invalidateRegisterCache() when the chip is known to be alive, so the shadow copy matches
+   *  the device exactly and no register is rewritten unnecessarily. */
+  void resyncRegisterCache() {
+    setShadow(RegisterAddress::CONFIG, readRegister(RegisterAddress::CONFIG));
+    setShadow(RegisterAddress::LOTHRESH, readRegister(RegisterAddress::LOTHRESH));
+    setShadow(RegisterAddress::HITHRESH, readRegister(RegisterAddress::HITHRESH));
   }
 
   /** \brief Sets the programmable gain amplifier (PGA) gain.
@@ -129,12 +822,32 @@ template <typename WIRE> class ADS1X15 {
   Gain getGain() const { return _gain; }
 
   /** \brief Sets the data rate (samples per second).
-   *  \param rate Data rate setting */
-  void setDataRate(Rate rate) { _rate = rate; }
+   *  \param rate Data rate setting; must be one of this chip's Rate constants */
+  void setDataRate(RateType rate) { _rate = rate; }
 
   /** \brief Gets the current data rate setting.
    *  \return Current Rate value */
-  Rate getDataRate() const { return _rate; }
+  RateType getDataRate() const { return _rate; }
+
+  /** \brief Sets the function used to sleep or yield while blocking reads wait for a conversion.
+   *
+   *  Without a delay function (the default), blocking reads poll the device back-to-back. With one, they wait for
+   *  the minimum conversion time for the current data rate and then poll with a bounded, growing back-off, which
+   *  keeps the bus free for other devices. On Arduino AVR note that delayMicroseconds() only accepts values up to
+   *  16383, so slow ADS1115 rates need a wrapper that also calls delay().
+   *  \param delayFn Delay/yield function, or nullptr to busy-poll */
+  void setDelayFunction(DelayFunction delayFn) { _delayFn = delayFn; }
+
+  /** \brief Gets the nominal conversion period for the current data rate.
+   *  \return Conversion period in microseconds */
+  uint32_t getConversionPeriodMicros() const { return conversionPeriodMicros(_rate); }
+
+  /** \brief Sets the clock used to measure deadlines in the tryRead*() functions.
+   *
+   *  Without a clock, elapsed time is estimated from the delays requested via setDelayFunction() plus
+   *  ADS1X15_POLL_ESTIMATE_US per status poll. The deadline is then approximate, but a read still always returns.
+   *  \param clockFn Microsecond clock, or nullptr to estimate */
+  void setClockFunction(ClockFunction clockFn) { _clockFn = clockFn; }
 
   /** \brief Reads a single-ended ADC channel (blocking).
    *  \param channel ADC channel to read (0-3)
@@ -145,12 +858,24 @@ template <typename WIRE> class ADS1X15 {
     startSingleEndedReading(channel, /*continuous=*/false);
 
     // Wait for the conversion to complete
-    while (!conversionComplete());
+    waitForConversion();
 
     // Read the conversion results
     return getLastConversionResults();
   }
 
+  /** \brief Reads a single-ended ADC channel, giving up after a deadline.
+   *
+   *  Unlike readADCSingleEnded(), bus errors are reported rather than ignored, and a device that never finishes
+   *  its conversion results in Status::TIMEOUT instead of a hang.
+   *  \param channel ADC channel to read (0-3)
+   *  \param timeoutMicros Time allowed for the conversion to complete, in microseconds
+   *  \return Status and conversion result */
+  ReadResult tryReadADCSingleEnded(uint8_t channel, uint32_t timeoutMicros) {
+    if (channel > 3) { return ReadResult{Status::INVALID_ARGUMENT, 0}; }
+    return tryRead(MUX_BY_CHANNEL[channel], timeoutMicros);
+  }
+
   /** \brief Starts a single-ended ADC reading (non-blocking).
    *  \param channel ADC channel to read (0-3)
    *  \param continuous If true, enables continuous conversion mode; if false, single-shot mode */
@@ -166,12 +891,20 @@ template <typename WIRE> class ADS1X15 {
     startDifferentialReading(pair, /*continuous=*/false);
 
     // Wait for the conversion to complete
-    while (!conversionComplete());
+    waitForConversion();
 
     // Read the conversion results
     return getLastConversionResults();
   }
 
+  /** \brief Reads a differential ADC pair, giving up after a deadline.
+   *  \param pair Differential input pair (e.g., PAIR_01 for AIN0-AIN1)
+   *  \param timeoutMicros Time allowed for the conversion to complete, in microseconds
+   *  \return Status and conversion result */
+  ReadResult tryReadADCDifferential(DifferentialPair pair, uint32_t timeoutMicros) {
+    return tryRead(static_cast<uint16_t>(pair), timeoutMicros);
+  }
+
   /** \brief Starts a differential ADC reading (non-blocking).
    *  \param pair Differential input pair (e.g., PAIR_01 for AIN0-AIN1)
    *  \param continuous If true, enables continuous conversion mode; if false, single-shot mode */
@@ -179,101 +912,263 @@ template <typename WIRE> class ADS1X15 {
     startADCReading(static_cast<uint16_t>(pair), continuous);
   }
 
+  /** \brief Starts an ADC reading from a precomputed scan entry (non-blocking).
+   *
+   *  The entry's gain and rate are used instead of the values set with setGain() and setDataRate().
+   *  \param entry Precomputed conversion request
+   *  \return Status of the register writes */
+  Status startReading(const ScanEntry& entry) { return startConversion(entry.config); }
+
   /** \brief Starts the comparator in continuous mode on a single-ended channel.
    *  \param channel ADC channel to monitor (0-3)
    *  \param threshold High threshold value for comparator (in ADC counts) */
   void startComparatorSingleEnded(uint8_t channel, int16_t threshold) {
     if (channel > 3) { return; }
 
-    // Start with default values
-    uint16_t config = ADS1X15_REG_CONFIG_CQUE_1CONV |   // Comparator enabled and asserts on 1 match
-                      ADS1X15_REG_CONFIG_CLAT_LATCH |   // Latching mode
-                      ADS1X15_REG_CONFIG_CPOL_ACTVLOW | // Alert/Rdy active low   (default val)
-                      ADS1X15_REG_CONFIG_CMODE_TRAD |   // Traditional comparator (default val)
-                      ADS1X15_REG_CONFIG_MODE_CONTIN;   // Continuous conversion mode
+    // LOTHRESH = chip default (0x8000); comparator deasserts only via latch clear.
+    writeComparator(ComparatorConfig::singleEnded(channel, Chip::countMin(), threshold));
+  }
 
-    // Set PGA/voltage range
-    config |= static_cast<uint16_t>(_gain);
+  /** \brief Starts the comparator in continuous mode with a full comparator setup.
+   *
+   *  The comparator runs at the current gain and data rate. Once started, ALERT/RDY can drive an event loop: with a
+   *  latching setup, call acknowledgeAlert() after each alert to release the pin.
+   *  \param comparator Input, thresholds and ALERT/RDY behaviour
+   *  \return Status::INVALID_ARGUMENT (nothing sent) unless the low threshold is below the high one after clamping
+   *  to the chip's range, else the status of the register writes */
+  Status startComparator(const ComparatorConfig& comparator) {
+    if (!thresholdsOrdered(comparator.low, comparator.high)) { return Status::INVALID_ARGUMENT; }
+    return writeComparator(comparator);
+  }
 
-    // Set data rate
-    config |= static_cast<uint16_t>(_rate);
+  /** \brief Changes the thresholds of a running comparator without restarting it.
+   *
+   *  Only thresholds that differ from the cached values are written.
+   *  \param low Low threshold in counts
+   *  \param high High threshold in counts
+   *  \return Status::INVALID_ARGUMENT (nothing sent) unless low is below high, else the status of the writes */
+  Status setComparatorThresholds(int16_t low, int16_t high) {
+    if (!thresholdsOrdered(low, high)) { return Status::INVALID_ARGUMENT; }
+    Status status = writeRegisterCached(RegisterAddress::LOTHRESH, countToRegister(low));
+    if (status != Status::OK) { return status; }
+    return writeRegisterCached(RegisterAddress::HITHRESH, countToRegister(high));
+  }
 
-    config |= MUX_BY_CHANNEL[channel];
+  /** \brief Changes the thresholds of a running comparator, in volts at the current gain.
+   *  \param low Low threshold in volts
+   *  \param high High threshold in volts
+   *  \return Status::INVALID_ARGUMENT (nothing sent) unless low is below high, else the status of the writes */
+  Status setComparatorThresholdsVolts(float low, float high) {
+    return setComparatorThresholds(computeCount(low), computeCount(high));
+  }
 
-    // Set threshold registers before starting conversion.
-    // LOTHRESH = chip default (0x8000); comparator deasserts only via latch clear.
-    // Shift 12-bit results left 4 bits for the ADS1015.
-    writeRegister(RegisterAddress::LOTHRESH, 0x8000);
-    int16_t maxThreshold = static_cast<int16_t>(32767 >> _bitshift);
-    int16_t minThreshold = static_cast<int16_t>(-(32768 >> _bitshift));
-    if (threshold > maxThreshold) { threshold = maxThreshold; }
-    if (threshold < minThreshold) { threshold = minThreshold; }
-    writeRegister(RegisterAddress::HITHRESH, static_cast<uint16_t>(threshold) << _bitshift);
+  /** \brief Releases a latched ALERT/RDY pin by reading the conversion register.
+   *
+   *  The read also returns the conversion that caused the alert. It is a single 2-byte read when the address
+   *  pointer is already on the conversion register, i.e. on every acknowledge after the first.
+   *  \return Status and conversion result */
+  ReadResult acknowledgeAlert() { return tryGetLastConversionResults(); }
 
-    // Write config register to the ADC
-    writeRegister(RegisterAddress::CONFIG, config);
-  }
+  /** \brief Waits for the last started conversion to complete (blocking).
+   *
+   *  Timing follows the data rate that conversion was started with. Uses the delay function set with
+   *  setDelayFunction() if there is one, otherwise polls back-to-back. */
+  void waitForConversion() { waitUntilComplete(0, /*bounded=*/false); }
+
+  /** \brief Waits for the last started conversion to complete, giving up after a deadline.
+   *  \param timeoutMicros Time allowed for the conversion to complete, in microseconds
+   *  \return Status::OK once complete, Status::TIMEOUT, or the bus error that occurred */
+  Status tryWaitForConversion(uint32_t timeoutMicros) { return waitUntilComplete(timeoutMicros, /*bounded=*/true); }
 
   /** \brief Checks if an ADC conversion has completed.
    *  \return true if conversion is complete, false if still in progress */
-  bool conversionComplete() { return (readRegister(RegisterAddress::CONFIG) & ADS1X15_REG_CONFIG_OS_NOTBUSY) != 0; }
+  bool conversionComplete() {
+    Status status;
+    return readOsBit(status);
+  }
+
+  /** \brief Checks if an ADC conversion has completed, reporting bus errors.
+   *  \param complete Set to true if the conversion is complete (left false on error)
+   *  \return Status of the register read */
+  Status tryConversionComplete(bool& complete) {
+    Status status;
+    complete = readOsBit(status) && status == Status::OK;
+    return status;
+  }
 
   /** \brief Retrieves the last ADC conversion result.
    *  \return ADC conversion result (signed 16-bit value) */
-  int16_t getLastConversionResults() {
-    // Read the conversion results
-    uint16_t res = readRegister(RegisterAddress::CONVERSION) >> _bitshift;
-    if (_bitshift == 0) {
-      return static_cast<int16_t>(res);
-    } else {
-      // Shift 12-bit results right 4 bits for the ADS1015,
-      // making sure we keep the sign bit intact
-      if (res > 0x07FF) {
-        // negative number - extend the sign to 16th bit
-        res |= 0xF000;
-      }
-      return static_cast<int16_t>(res);
-    }
+  int16_t getLastConversionResults() { return rawToCount(readRegister(RegisterAddress::CONVERSION)); }
+
+  /** \brief Retrieves the last ADC conversion result as calibrated microvolts.
+   *  \param calibration Coefficients for the input and gain the conversion was taken at
+   *  \return Voltage in microvolts */
+  int32_t getLastConversionMicrovolts(const Calibration& calibration) {
+    return calibration.microvolts(getLastConversionResults());
   }
 
+  /** \brief Retrieves the last ADC conversion result, reporting bus errors.
+   *  \return Status and conversion result */
+  ReadResult tryGetLastConversionResults() {
+    uint16_t raw  = 0;
+    Status status = readRegister(RegisterAddress::CONVERSION, raw);
+    return ReadResult{status, status == Status::OK ? rawToCount(raw) : static_cast<int16_t>(0)};
+  }
+
+  /** \brief Gets the instrumentation policy object, e.g. to take a snapshot of its counters.
+   *  \return Instrumentation policy */
+  Instrumentation& instrumentation() { return *this; }
+
+  /** \brief Gets the instrumentation policy object.
+   *  \return Instrumentation policy */
+  const Instrumentation& instrumentation() const { return *this; }
+
+  /** \brief Gets the bus-lock policy object, e.g. to attach it to a mutex.
+   *  \return Bus-lock policy */
+  BusLock& busLock() { return *this; }
+
   /** \brief Converts ADC count value to volts.
    *  \param count ADC count value to convert
    *  \return Voltage in volts */
-  float computeVolts(int16_t count) const { return count * (gainToRange() / (32768 >> _bitshift)); }
+  float computeVolts(int16_t count) const { return computeVolts(count, _gain); }
 
-  /** \brief Converts volts to ADC count value.
+  /** \brief Converts ADC count value to volts for a given gain.
+   *
+   *  Use this for results taken with a gain other than the current setting, e.g. from a ScanEntry.
+   *  \param count ADC count value to convert
+   *  \param gain Gain the count was measured at
+   *  \return Voltage in volts */
+  float computeVolts(int16_t count, Gain gain) const { return count * voltsPerCount(gain); }
+
+  /** \brief Converts a buffer of ADC counts to volts.
+   *
+   *  The scale factor is computed once for the whole buffer, and the loop uses SSE2/NEON where available. Results
+   *  are identical to calling computeVolts(count) on each element.
+   *  \param counts ADC count values
+   *  \param volts Receives n voltages (may not overlap counts)
+   *  \param n Number of values */
+  void computeVolts(const int16_t* counts, float* volts, size_t n) const { computeVolts(counts, volts, n, _gain); }
+
+  /** \brief Converts a buffer of ADC counts taken at a given gain to volts.
+   *  \param counts ADC count values
+   *  \param volts Receives n voltages (may not overlap counts)
+   *  \param n Number of values
+   *  \param gain Gain the counts were measured at */
+  void computeVolts(const int16_t* counts, float* volts, size_t n, Gain gain) const {
+    detail::scaleCounts(counts, volts, n, voltsPerCount(gain));
+  }
+
+  /** \brief Converts volts to ADC count value, clamped to the chip's range.
    *  \param volts Voltage to convert
    *  \return ADC count value */
   int16_t computeCount(float volts) const {
-    float raw = volts * (32768 >> _bitshift) / gainToRange();
-    if (raw > 32767.0f) { return 32767; }
-    if (raw < -32768.0f) { return -32768; }
+    float raw = volts * Chip::fullScaleCounts() / gainToRange(_gain);
+    if (raw > Chip::countMax()) { return Chip::countMax(); }
+    if (raw < Chip::countMin()) { return Chip::countMin(); }
     return static_cast<int16_t>(raw);
   }
 
+  /** \brief Converts ADC count value to microvolts using integer arithmetic only.
+   *  \param count ADC count value to convert
+   *  \return Voltage in microvolts, rounded to nearest */
+  int32_t computeMicrovolts(int16_t count) const { return computeMicrovolts(count, _gain); }
+
+  /** \brief Converts ADC count value to microvolts for a given gain, using integer arithmetic only.
+   *  \param count ADC count value to convert
+   *  \param gain Gain the count was measured at
+   *  \return Voltage in microvolts, rounded to nearest (halves away from zero) */
+  static int32_t computeMicrovolts(int16_t count, Gain gain) {
+    // |count| * LSB <= 2^15 * 3000 or 2^11 * 48000, so the product fits in 32 bits.
+    return detail::roundQ4(static_cast<int32_t>(count) * static_cast<int32_t>(microvoltsPerLsbQ4<Chip>(gain)));
+  }
+
+  /** \brief Converts a buffer of ADC counts to microvolts in place, using integer arithmetic only.
+   *  \param values ADC count values on entry, microvolts on return
+   *  \param n Number of values */
+  void computeMicrovolts(int32_t* values, size_t n) const { computeMicrovolts(values, n, _gain); }
+
+  /** \brief Converts a buffer of ADC counts taken at a given gain to microvolts in place.
+   *
+   *  Results are identical to calling computeMicrovolts(count, gain) on each element.
+   *  \param values ADC count values on entry, microvolts on return
+   *  \param n Number of values
+   *  \param gain Gain the counts were measured at */
+  static void computeMicrovolts(int32_t* values, size_t n, Gain gain) {
+    detail::scaleCountsMicrovolts(values, n, static_cast<int32_t>(microvoltsPerLsbQ4<Chip>(gain)));
+  }
+
+  /** \brief Converts ADC count value to millivolts using integer arithmetic only.
+   *  \param count ADC count value to convert
+   *  \return Voltage in millivolts, rounded to nearest */
+  int32_t computeMillivolts(int16_t count) const { return computeMillivolts(count, _gain); }
+
+  /** \brief Converts ADC count value to millivolts for a given gain, using integer arithmetic only.
+   *  \param count ADC count value to convert
+   *  \param gain Gain the count was measured at
+   *  \return Voltage in millivolts, rounded to nearest (halves away from zero) */
+  static int32_t computeMillivolts(int16_t count, Gain gain) {
+    int32_t scaled = static_cast<int32_t>(count) * static_cast<int32_t>(microvoltsPerLsbQ4<Chip>(gain));
+    return roundingDivide(scaled, static_cast<int32_t>(1000) << ADS1X15_LSB_FRACTION_BITS);
+  }
+
+  /** \brief Converts microvolts to ADC count value using integer arithmetic only, clamped to the chip's range.
+   *
+   *  The integer counterpart of computeCount(float), for setting comparator thresholds without floating point.
+   *  \param microvolts Voltage to convert
+   *  \return ADC count value, rounded to nearest */
+  int16_t computeCountMicrovolts(int32_t microvolts) const {
+    // Clamp first so the scaled value cannot overflow; anything beyond full scale saturates anyway.
+    const int32_t limit = static_cast<int32_t>(ADS1X15_RANGE_MICROVOLTS[0]) * 2;
+    if (microvolts > limit) { microvolts = limit; }
+    if (microvolts < -limit) { microvolts = -limit; }
+    int32_t count = roundingDivide(microvolts * (static_cast<int32_t>(1) << ADS1X15_LSB_FRACTION_BITS),
+                                   static_cast<int32_t>(microvoltsPerLsbQ4<Chip>(_gain)));
+    if (count > Chip::countMax()) { return Chip::countMax(); }
+    if (count < Chip::countMin()) { return Chip::countMin(); }
+    return static_cast<int16_t>(count);
+  }
+
+  /** \brief Converts a raw CONVERSION/threshold register value to a count.
+   *  \param raw Register value
+   *  \return Signed count */
+  static int16_t rawToCount(uint16_t raw) { return Chip::countFromRegister(raw); }
+
+  /** \brief Converts a count to a threshold register value, clamping it to the chip's range.
+   *  \param count Signed count
+   *  \return Register value */
+  static uint16_t countToRegister(int16_t count) {
+    if (count > Chip::countMax()) { count = Chip::countMax(); }
+    if (count < Chip::countMin()) { count = Chip::countMin(); }
+    return static_cast<uint16_t>(static_cast<uint16_t>(count) << Chip::shift());
+  }
+
   protected:
   /** \brief Protected constructor for derived classes.
    *  \param wire Reference to I2C interface object
-   *  \param bitshift Number of bits to shift (4 for ADS1015, 0 for ADS1115)
    *  \param gain Default gain setting
    *  \param rate Default data rate setting */
-  ADS1X15(WIRE& wire, uint8_t bitshift, Gain gain, Rate rate)
-      : mWire(wire),
-        _bitshift(bitshift),
-        _gain(gain),
-        _rate(rate) {}
-
-  uint8_t _i2caddr = ADS1X15_ADDRESS; ///< I2C address
-  WIRE& mWire;                        ///< Reference to I2C interface
-  uint8_t _bitshift;                  ///< Number of bits to shift raw ADC value
-  Gain _gain;                         ///< Current gain setting
-  Rate _rate;                         ///< Current data rate setting
+  ADS1X15(WIRE& wire, Gain gain, RateType rate) : mWire(wire), _gain(gain), _rate(rate), _conversionRate(rate) {}
+
+  uint8_t _i2caddr = ADS1X15_ADDRESS;       ///< I2C address
+  WIRE& mWire;                              ///< Reference to I2C interface
+  Gain _gain;                               ///< Current gain setting
+  RateType _rate;                           ///< Current data rate setting
+  RateType _conversionRate;                 ///< Data rate of the last conversion started
+  uint16_t _shadow[3]    = {};              ///< Last values written to CONFIG, LOTHRESH and HITHRESH
+  uint8_t _shadowValid   = 0;               ///< Bitmask of _shadow entries known to match the chip
+  uint8_t _pointer       = POINTER_UNKNOWN; ///< Register the chip's address pointer currently selects
+  DelayFunction _delayFn = nullptr;         ///< Sleep/yield hook used while waiting for conversions
+  ClockFunction _clockFn = nullptr;         ///< Clock used for read deadlines
+
+  static constexpr uint8_t POINTER_UNKNOWN = 0xFF; ///< _pointer value when the pointer state is not known
+  static constexpr uint32_t MIN_BACKOFF_US = 20;   ///< Shortest back-off between polls in waitForConversion()
 
   private:
-  /** \brief Returns the PGA full-scale range in volts for the current gain setting.
+  /** \brief Returns the PGA full-scale range in volts for a gain setting.
+   *  \param gain Gain setting
    *  \return Full-scale voltage range */
-  float gainToRange() const {
-    switch (_gain) {
+  static float gainToRange(Gain gain) {
+    switch (gain) {
     case Gain::TWOTHIRDS_6144MV:
       return 6.144;
     case Gain::ONE_4096MV:
@@ -291,87 +1186,293 @@ template <typename WIRE> class ADS1X15 {
     }
   }
 
-  void startADCReading(uint16_t mux, bool continuous) {
-    // Start with default values
-    uint16_t config = ADS1X15_REG_CONFIG_CQUE_1CONV |   // Set CQUE to any value other than
-                                                        // None so we can use it in RDY mode
-                      ADS1X15_REG_CONFIG_CLAT_NONLAT |  // Non-latching (default val)
-                      ADS1X15_REG_CONFIG_CPOL_ACTVLOW | // Alert/Rdy active low   (default val)
-                      ADS1X15_REG_CONFIG_CMODE_TRAD;    // Traditional comparator (default val)
+  /** \brief Divides, rounding to nearest with halves away from zero.
+   *  \param numerator Dividend
+   *  \param denominator Positive divisor
+   *  \return Rounded quotient */
+  static int32_t roundingDivide(int32_t numerator, int32_t denominator) {
+    int32_t half = denominator / 2;
+    return (numerator >= 0 ? numerator + half : numerator - half) / denominator;
+  }
 
-    if (continuous) {
-      config |= ADS1X15_REG_CONFIG_MODE_CONTIN;
-    } else {
-      config |= ADS1X15_REG_CONFIG_MODE_SINGLE;
-    }
+  /** \brief Gets the size of one count in volts.
+   *  \param gain Gain setting
+   *  \return Volts per count */
+  static float voltsPerCount(Gain gain) { return gainToRange(gain) / Chip::fullScaleCounts(); }
 
-    // Set PGA/voltage range
-    config |= static_cast<uint16_t>(_gain);
+  static bool thresholdsOrdered(int16_t low, int16_t high) {
+    return static_cast<int16_t>(countToRegister(low)) < static_cast<int16_t>(countToRegister(high));
+  }
 
-    // Set data rate
-    config |= static_cast<uint16_t>(_rate);
+  Status writeComparator(const ComparatorConfig& comparator) {
+    // Set threshold registers before starting conversion.
+    // Shift 12-bit results left 4 bits for the ADS1015.
+    Status status = writeRegisterCached(RegisterAddress::LOTHRESH, countToRegister(comparator.low));
+    if (status != Status::OK) { return status; }
+    status = writeRegisterCached(RegisterAddress::HITHRESH, countToRegister(comparator.high));
+    if (status != Status::OK) { return status; }
 
-    // Set channels
-    config |= mux & ADS1X15_REG_CONFIG_MUX_MASK;
+    uint16_t config = static_cast<uint16_t>(comparator.config | static_cast<uint16_t>(_gain) | _rate.bits);
+    _conversionRate = _rate;
+    return writeRegister(RegisterAddress::CONFIG, config);
+  }
 
-    // Set 'start single-conversion' bit
-    config |= ADS1X15_REG_CONFIG_OS_SINGLE;
+  Status startADCReading(uint16_t mux, bool continuous) {
+    return startConversion(makeReadingConfig(mux, _gain, _rate, continuous));
+  }
 
+  Status startConversion(uint16_t config) {
     // Set ALERT/RDY to RDY mode (before starting conversion).
-    writeRegister(RegisterAddress::HITHRESH, 0x8000);
-    writeRegister(RegisterAddress::LOTHRESH, 0x0000);
+    // These are skipped when the chip already holds the same values.
+    Status status = writeRegisterCached(RegisterAddress::HITHRESH, 0x8000);
+    if (status != Status::OK) { return status; }
+    status = writeRegisterCached(RegisterAddress::LOTHRESH, 0x0000);
+    if (status != Status::OK) { return status; }
 
     // Write config register to the ADC (starts conversion via OS=1).
-    writeRegister(RegisterAddress::CONFIG, config);
+    // Always written, as the OS bit is what triggers the conversion.
+    _conversionRate = RateType{static_cast<uint16_t>(config & ADS1X15_REG_CONFIG_RATE_MASK)};
+    return writeRegister(RegisterAddress::CONFIG, config);
+  }
+
+  ReadResult tryRead(uint16_t mux, uint32_t timeoutMicros) {
+    Status status = startADCReading(mux, /*continuous=*/false);
+    if (status == Status::OK) { status = waitUntilComplete(timeoutMicros, /*bounded=*/true); }
+    if (status != Status::OK) { return ReadResult{status, 0}; }
+    return tryGetLastConversionResults();
+  }
+
+  // Polls CONFIG until the OS bit is set. When bounded, gives up on a bus
+  // error or once timeoutMicros has elapsed; otherwise polls forever, as the
+  // original blocking API did.
+  Status waitUntilComplete(uint32_t timeoutMicros, bool bounded) {
+    uint32_t start   = _clockFn != nullptr ? _clockFn() : 0;
+    uint32_t elapsed = 0;
+
+    // Sleep through the shortest possible conversion, then poll with a
+    // doubling back-off capped at a quarter period. The slowest conversion
+    // ends ~0.2 periods after the first poll, so only a few polls are needed.
+    // The first sleep is cut short rather than overrun a shorter deadline.
+    uint32_t period  = conversionPeriodMicros(_conversionRate);
+    uint32_t backoff = period / 64;
+    if (backoff < MIN_BACKOFF_US) { backoff = MIN_BACKOFF_US; }
+    if (_delayFn != nullptr) {
+      uint32_t minimum = conversionTimeMinMicros(_conversionRate);
+      if (bounded && timeoutMicros < minimum) { minimum = timeoutMicros; }
+      if (minimum > 0) {
+        _delayFn(minimum);
+        elapsed += minimum;
+      }
+    }
+
+    for (;;) {
+      Status status;
+      bool complete = readOsBit(status);
+      if (bounded && status != Status::OK) { return status; }
+      if (complete) { return Status::OK; }
+
+      if (bounded) {
+        if (_clockFn != nullptr) {
+          elapsed = _clockFn() - start;
+        } else {
+          elapsed += ADS1X15_POLL_ESTIMATE_US;
+        }
+        if (elapsed >= timeoutMicros) { return Status::TIMEOUT; }
+      }
+
+      if (_delayFn != nullptr) {
+        // Don't sleep past the deadline.
+        uint32_t wait = backoff;
+        if (bounded && timeoutMicros - elapsed < wait) { wait = timeoutMicros - elapsed; }
+        _delayFn(wait);
+        elapsed += wait;
+        if (backoff < period / 4) { backoff *= 2; }
+      }
+    }
+  }
+
+  // Reads CONFIG and returns the OS bit. On a bus error the bit comes from whatever was read, as the unchecked
+  // conversionComplete() has always done.
+  bool readOsBit(Status& status) {
+    uint16_t config = 0;
+    status          = readRegister(RegisterAddress::CONFIG, config);
+    bool complete   = (config & ADS1X15_REG_CONFIG_OS_NOTBUSY) != 0;
+    if (status == Status::OK) { Instrumentation::onConversionPoll(complete, instrumentationTime()); }
+    return complete;
+  }
+
+  // Only reads the clock when the instrumentation policy wants timestamps.
+  uint32_t instrumentationTime() const { return Instrumentation::enabled() && _clockFn != nullptr ? _clockFn() : 0; }
+
+  static uint8_t shadowIndex(RegisterAddress reg) { return static_cast<uint8_t>(reg) - 1; }
+
+  void setShadow(RegisterAddress reg, uint16_t value) {
+    if (reg == RegisterAddress::CONVERSION) { return; }
+    // The OS bit reads back differently to how it is written, so it is never cached.
+    if (reg == RegisterAddress::CONFIG) { value &= ~ADS1X15_REG_CONFIG_OS_MASK; }
+    _shadow[shadowIndex(reg)] = value;
+    _shadowValid |= static_cast<uint8_t>(1 << shadowIndex(reg));
+  }
+
+  bool shadowMatches(RegisterAddress reg, uint16_t value) const {
+    uint8_t idx = shadowIndex(reg);
+    return (_shadowValid & (1 << idx)) && _shadow[idx] == value;
   }
 
-  void writeRegister(RegisterAddress reg, uint16_t value) {
+  Status writeRegisterCached(RegisterAddress reg, uint16_t value) {
+    if (shadowMatches(reg, value)) { return Status::OK; }
+    return writeRegister(reg, value);
+  }
+
+  // Holds the bus lock for the lifetime of one register transaction.
+  class BusGuard {
+    public:
+    explicit BusGuard(BusLock& lock) : _lock(lock) { _lock.lock(); }
+    ~BusGuard() { _lock.unlock(); }
+
+    private:
+    BusLock& _lock;
+  };
+
+  Status writeRegister(RegisterAddress reg, uint16_t value) {
+    BusGuard guard(*this);
     mWire.beginTransmission(_i2caddr);
+    writeBytes(reg, value, detail::BoolTag<detail::SupportsBufferedWrite<WIRE>::value>());
+    uint8_t err = endTransmission(detail::BoolTag<detail::EndTransmissionReturnsStatus<WIRE>::value>());
+    if (err != 0) {
+      // Whether the write landed is unknown, so forget what the chip holds.
+      _pointer = POINTER_UNKNOWN;
+      if (reg != RegisterAddress::CONVERSION) { _shadowValid &= static_cast<uint8_t>(~(1 << shadowIndex(reg))); }
+      Status status = statusFromEndTransmission(err);
+      Instrumentation::onRegisterWrite(3, status);
+      return status;
+    }
+    // Any register write also moves the chip's address pointer.
+    _pointer = static_cast<uint8_t>(reg);
+    setShadow(reg, value);
+    Instrumentation::onRegisterWrite(3, Status::OK);
+    // Every CONFIG write starts a conversion: OS = 1 in single-shot mode, or a restart in continuous mode.
+    if (reg == RegisterAddress::CONFIG) { Instrumentation::onConversionStart(instrumentationTime()); }
+    return Status::OK;
+  }
+
+  void writeBytes(RegisterAddress reg, uint16_t value, detail::BoolTag<true>) {
+    const uint8_t buf[3] = {static_cast<uint8_t>(reg), static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)};
+    mWire.write(buf, sizeof(buf));
+  }
+
+  void writeBytes(RegisterAddress reg, uint16_t value, detail::BoolTag<false>) {
     mWire.write(static_cast<uint8_t>(reg));
     mWire.write(value >> 8);
     mWire.write(value & 0xFF);
+  }
+
+  // WIRE types whose endTransmission()/requestFrom() return void are
+  // assumed to always succeed.
+  uint8_t endTransmission(detail::BoolTag<true>) { return static_cast<uint8_t>(mWire.endTransmission()); }
+  uint8_t endTransmission(detail::BoolTag<false>) {
     mWire.endTransmission();
+    return 0;
+  }
+
+  // Hold the bus after the pointer write so the following read is a repeated start.
+  uint8_t endPointerWrite(detail::BoolTag<true>) {
+    return endRepeatedStart(detail::BoolTag<detail::EndTransmissionReturnsStatus<WIRE>::value>());
+  }
+  uint8_t endPointerWrite(detail::BoolTag<false>) {
+    return endTransmission(detail::BoolTag<detail::EndTransmissionReturnsStatus<WIRE>::value>());
+  }
+  uint8_t endRepeatedStart(detail::BoolTag<true>) { return static_cast<uint8_t>(mWire.endTransmission(false)); }
+  uint8_t endRepeatedStart(detail::BoolTag<false>) {
+    mWire.endTransmission(false);
+    return 0;
+  }
+
+  uint8_t requestFrom(uint8_t count, detail::BoolTag<true>) {
+    return static_cast<uint8_t>(mWire.requestFrom(_i2caddr, count));
+  }
+  uint8_t requestFrom(uint8_t count, detail::BoolTag<false>) {
+    mWire.requestFrom(_i2caddr, count);
+    return count;
   }
 
   uint16_t readRegister(RegisterAddress reg) {
-    mWire.beginTransmission(_i2caddr);
-    mWire.write(static_cast<uint8_t>(reg));
-    mWire.endTransmission();
-    mWire.requestFrom(_i2caddr, static_cast<uint8_t>(2));
+    uint16_t value = 0;
+    readRegister(reg, value);
+    return value;
+  }
+
+  Status readRegister(RegisterAddress reg, uint16_t& value) {
+    // The pointer write and the read are one transaction: no other chip's traffic may come between them.
+    BusGuard guard(*this);
+    // The pointer only needs writing when it selects a different register,
+    // e.g. back-to-back CONVERSION reads in continuous mode are a bare 2-byte read.
+    uint8_t pointerBytes = 0;
+    if (_pointer != static_cast<uint8_t>(reg)) {
+      mWire.beginTransmission(_i2caddr);
+      mWire.write(static_cast<uint8_t>(reg));
+      uint8_t err = endPointerWrite(detail::BoolTag<detail::SupportsRepeatedStart<WIRE>::value>());
+      if (err != 0) {
+        _pointer      = POINTER_UNKNOWN;
+        Status status = statusFromEndTransmission(err);
+        Instrumentation::onRegisterRead(1, 0, status);
+        return status;
+      }
+      _pointer     = static_cast<uint8_t>(reg);
+      pointerBytes = 1;
+    }
+    uint8_t received = requestFrom(2, detail::BoolTag<detail::RequestFromReturnsCount<WIRE>::value>());
+    // Always consume two bytes so the unchecked readRegister() overload
+    // returns exactly what it always has, even on a failed read.
     uint8_t hi = mWire.read();
     uint8_t lo = mWire.read();
-    return static_cast<uint16_t>(static_cast<uint16_t>(hi) << 8 | lo);
+    value      = static_cast<uint16_t>(static_cast<uint16_t>(hi) << 8 | lo);
+    if (received < 2) {
+      _pointer = POINTER_UNKNOWN;
+      Instrumentation::onRegisterRead(pointerBytes, 2, Status::SHORT_READ);
+      return Status::SHORT_READ;
+    }
+    Instrumentation::onRegisterRead(pointerBytes, 2, Status::OK);
+    return Status::OK;
   }
 };
 
 /**
  * \brief Driver for the ADS1015 12-bit ADC.
  *
- * The ADS1015 is a 12-bit precision ADC with an I2C interface. This class sets
- * the appropriate bit shift (4) and default data rate (1600 SPS) for the ADS1015.
+ * The ADS1015 is a 12-bit precision ADC with an I2C interface. This class selects
+ * the ADS1015 traits and default data rate (1600 SPS).
  *
  * \tparam WIRE I2C interface type (e.g., TwoWire, AceWire, SoftwareWire)
+ * \tparam Instrumentation Instrumentation policy (NoInstrumentation compiles out)
+ * \tparam BusLock Bus-lock policy (NoBusLock compiles out)
  */
-template <typename WIRE> class ADS1015 : public ADS1X15<WIRE> {
+template <typename WIRE, typename Instrumentation = NoInstrumentation, typename BusLock = NoBusLock>
+class ADS1015 : public ADS1X15<WIRE, ADS1015Traits, Instrumentation, BusLock> {
   public:
   /** \brief Constructs an ADS1015 instance.
    *  \param wire Reference to I2C interface object */
-  ADS1015(WIRE& wire) : ADS1X15<WIRE>(wire, 4, Gain::TWOTHIRDS_6144MV, Rate::ADS1015_1600SPS) {}
+  ADS1015(WIRE& wire)
+      : ADS1X15<WIRE, ADS1015Traits, Instrumentation, BusLock>(wire, Gain::TWOTHIRDS_6144MV, Rate::ADS1015_1600SPS) {}
 };
 
 /**
  * \brief Driver for the ADS1115 16-bit ADC.
  *
- * The ADS1115 is a 16-bit precision ADC with an I2C interface. This class sets
- * the appropriate bit shift (0) and default data rate (128 SPS) for the ADS1115.
+ * The ADS1115 is a 16-bit precision ADC with an I2C interface. This class selects
+ * the ADS1115 traits and default data rate (128 SPS).
  *
  * \tparam WIRE I2C interface type (e.g., TwoWire, AceWire, SoftwareWire)
+ * \tparam Instrumentation Instrumentation policy (NoInstrumentation compiles out)
+ * \tparam BusLock Bus-lock policy (NoBusLock compiles out)
  */
-template <typename WIRE> class ADS1115 : public ADS1X15<WIRE> {
+template <typename WIRE, typename Instrumentation = NoInstrumentation, typename BusLock = NoBusLock>
+class ADS1115 : public ADS1X15<WIRE, ADS1115Traits, Instrumentation, BusLock> {
   public:
   /** \brief Constructs an ADS1115 instance.
    *  \param wire Reference to I2C interface object */
-  ADS1115(WIRE& wire) : ADS1X15<WIRE>(wire, 0, Gain::TWOTHIRDS_6144MV, Rate::ADS1115_128SPS) {}
+  ADS1115(WIRE& wire)
+      : ADS1X15<WIRE, ADS1115Traits, Instrumentation, BusLock>(wire, Gain::TWOTHIRDS_6144MV, Rate::ADS1115_128SPS) {}
 };
 
 } // namespace ADS1X15
@@ -0,0 +1,358 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_ACQUISITION_H
+#define ADS1X15_ACQUISITION_H
+
+// Host-only: uses the C++ standard library. Not for use on microcontrollers.
+
+#include <atomic>
+#include <thread>
+
+#include "ADS1X15.h"
+#include "ADS1X15RingBuffer.h"
+
+namespace ADS1X15 {
+
+/** \brief A conversion result from an AcquisitionEngine, tagged with where and when it was taken. */
+struct AcquiredSample {
+  uint32_t timestamp; ///< Time the result was seen, from the engine's clock
+  uint8_t bus;        ///< Bus (worker) index
+  uint8_t device;     ///< Device index on its bus, in the order added
+  int16_t count;      ///< Conversion result
+};
+
+/** \brief What a bus worker does with a result when its queue is full. */
+enum class Backpressure : uint8_t {
+  WAIT, ///< Hold the result in software and don't restart its device until there is room: nothing is lost
+  DROP  ///< Discard the result, count it and keep converting: the sampling rate is kept
+};
+
+/** \brief Counters of one bus worker. */
+struct AcquisitionStats {
+  uint32_t produced;   ///< Samples queued for the consumer
+  uint32_t dropped;    ///< Samples discarded because the queue was full (Backpressure::DROP)
+  uint32_t stalls;     ///< Times a device was held back because the queue was full (Backpressure::WAIT)
+  uint32_t readErrors; ///< Failed starts, polls or reads; the device's conversion is restarted
+};
+
+/**
+ * \brief Samples the devices of one bus from its own thread into a lock-free queue.
+ *
+ * The worker keeps a single-shot conversion running on every device. Each pass checks the devices in turn with
+ * tryConversionComplete(), reads the finished ones, timestamps and queues the results, and starts their next
+ * conversion. Used by AcquisitionEngine, which owns the thread.
+ *
+ * \tparam ADC Driver type (e.g. ADS1115<LinuxI2C>)
+ * \tparam MaxDevices Maximum devices on the bus
+ * \tparam QueueCapacity Samples buffered between the worker and the consumer; a power of two
+ */
+template <typename ADC, size_t MaxDevices, size_t QueueCapacity> class BusWorker {
+  public:
+  /** \brief Adds a device. Not allowed while running.
+   *  \param ads Driver, already initialised with begin(); used only by this worker while running
+   *  \param entry Input, gain and rate to convert
+   *  \return false if MaxDevices devices have been added */
+  bool add(ADC& ads, const ScanEntry& entry) {
+    if (_count == MaxDevices) { return false; }
+    _devices[_count++] = Device{&ads, entry, false, false, AcquiredSample{}};
+    return true;
+  }
+
+  /** \brief Gets the number of devices.
+   *  \return Device count */
+  size_t size() const { return _count; }
+
+  /** \brief Worker thread body: samples until running is cleared.
+   *  \param bus Bus index written into each sample
+   *  \param running Cleared by the engine to stop the worker
+   *  \param clock Timestamp clock, shared by every worker
+   *  \param policy What to do when the queue is full
+   *  \param idle Called with idleMicros after a pass that found nothing to do; nullptr to yield instead
+   *  \param idleMicros Argument for idle */
+  void run(uint8_t bus, const std::atomic<bool>& running, ClockFunction clock, Backpressure policy,
+           DelayFunction idle, uint32_t idleMicros) {
+    for (size_t i = 0; i < _count; i++) { restart(i); }
+    while (running.load(std::memory_order_relaxed)) {
+      bool progressed    = false;
+      uint32_t watermark = clock();
+      for (size_t i = 0; i < _count; i++) {
+        progressed = service(bus, i, clock, policy) || progressed;
+        // A held-back sample is older than anything still to come from the other devices.
+        if (_devices[i].held && before(_devices[i].sample.timestamp, watermark)) {
+          watermark = _devices[i].sample.timestamp;
+        }
+      }
+      // Every sample queued from now on is stamped at or after the watermark.
+      _watermark.store(watermark, std::memory_order_release);
+      if (progressed) { continue; }
+      if (idle != nullptr) {
+        idle(idleMicros);
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  /** \brief Consumer: takes the oldest queued sample.
+   *  \param sample Receives the sample
+   *  \return false if the queue was empty */
+  bool pop(AcquiredSample& sample) { return _queue.pop(sample); }
+
+  /** \brief Consumer: gets the time before which this worker will queue no more samples.
+   *  \return Watermark in clock units */
+  uint32_t watermark() const { return _watermark.load(std::memory_order_acquire); }
+
+  /** \brief Resets the watermark before the worker starts.
+   *  \param now Current clock time */
+  void resetWatermark(uint32_t now) { _watermark.store(now, std::memory_order_release); }
+
+  /** \brief Gets the worker's counters. Safe from any thread.
+   *  \return Counters */
+  AcquisitionStats stats() const {
+    return AcquisitionStats{_produced.load(std::memory_order_relaxed), _dropped.load(std::memory_order_relaxed),
+                            _stalls.load(std::memory_order_relaxed), _readErrors.load(std::memory_order_relaxed)};
+  }
+
+  /** \brief Checks whether a clock time comes before another, allowing for wrap-around.
+   *  \param a First time
+   *  \param b Second time
+   *  \return true if a is earlier than b */
+  static bool before(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b) < 0; }
+
+  private:
+  struct Device {
+    ADC* ads;
+    ScanEntry entry;
+    bool converting;       ///< The last start succeeded
+    bool held;             ///< The result in sample is waiting for room in the queue
+    AcquiredSample sample; ///< Result held back by Backpressure::WAIT
+  };
+
+  // Checks one device and handles its result. Returns true if anything happened.
+  bool service(uint8_t bus, size_t i, ClockFunction clock, Backpressure policy) {
+    Device& d = _devices[i];
+    if (!d.converting) { return restart(i); }
+    if (d.held) {
+      if (!_queue.push(d.sample)) { return false; }
+      d.held = false;
+      _produced.fetch_add(1, std::memory_order_relaxed);
+      restart(i);
+      return true;
+    }
+
+    bool complete = false;
+    if (d.ads->tryConversionComplete(complete) != Status::OK) { return fail(i); }
+    if (!complete) { return false; }
+    uint32_t timestamp = clock();
+    ReadResult r       = d.ads->tryGetLastConversionResults();
+    if (!r.ok()) { return fail(i); }
+
+    AcquiredSample sample{timestamp, bus, static_cast<uint8_t>(i), r.value};
+    if (_queue.push(sample)) {
+      _produced.fetch_add(1, std::memory_order_relaxed);
+    } else if (policy == Backpressure::DROP) {
+      _dropped.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      d.held   = true;
+      d.sample = sample;
+      _stalls.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    restart(i);
+    return true;
+  }
+
+  bool fail(size_t i) {
+    _readErrors.fetch_add(1, std::memory_order_relaxed);
+    restart(i);
+    return true;
+  }
+
+  // Starts the device's next conversion. A failed start is counted and retried on the next pass.
+  bool restart(size_t i) {
+    Device& d    = _devices[i];
+    uint16_t cfg = static_cast<uint16_t>(d.entry.config | ADS1X15_REG_CONFIG_MODE_SINGLE);
+    d.converting = d.ads->startReading(ScanEntry{cfg}) == Status::OK;
+    if (!d.converting) { _readErrors.fetch_add(1, std::memory_order_relaxed); }
+    return d.converting;
+  }
+
+  Device _devices[MaxDevices];
+  size_t _count = 0;
+  SpscRingBuffer<AcquiredSample, QueueCapacity> _queue;
+  std::atomic<uint32_t> _watermark{0};
+  std::atomic<uint32_t> _produced{0};
+  std::atomic<uint32_t> _dropped{0};
+  std::atomic<uint32_t> _stalls{0};
+  std::atomic<uint32_t> _readErrors{0};
+};
+
+/**
+ * \brief Samples several I2C buses in parallel, one worker thread per bus, and merges the results into one
+ * timestamp-ordered stream.
+ *
+ * Add each bus's devices, then start(). Every worker keeps all of its devices converting and queues the results in
+ * its own lock-free SPSC queue, so the buses never wait for each other. The consumer calls next(), which returns the
+ * queued sample with the earliest timestamp once no worker can still produce an earlier one. Each worker publishes a
+ * watermark for this after every pass over its devices.
+ *
+ * When a queue is full because the consumer is behind, the Backpressure policy decides. WAIT keeps the result that
+ * did not fit (one per device, stamped when it was read) and does not restart that device until the queue has room,
+ * so no sample is lost but the rate drops. DROP discards the result, counts it and restarts the device.
+ *
+ * All workers stamp samples with the same clock, which must be monotonic and callable from any thread, e.g. a
+ * wrapper around std::chrono::steady_clock. A device whose start, poll or read fails is counted and restarted.
+ *
+ * \tparam ADC Driver type (e.g. ADS1115<LinuxI2C>); every device needs its own driver instance
+ * \tparam Buses Number of buses (workers)
+ * \tparam MaxDevices Maximum devices per bus
+ * \tparam QueueCapacity Samples buffered per bus; a power of two
+ */
+template <typename ADC, size_t Buses, size_t MaxDevices = 4, size_t QueueCapacity = 1024> class AcquisitionEngine {
+  static_assert(Buses > 0 && Buses <= 256, "Engine handles 1 to 256 buses");
+
+  public:
+  /** \brief Constructs an engine.
+   *  \param clock Timestamp clock (e.g. microseconds since some epoch) */
+  explicit AcquisitionEngine(ClockFunction clock) : _clock(clock) {}
+
+  AcquisitionEngine(const AcquisitionEngine&)            = delete;
+  AcquisitionEngine& operator=(const AcquisitionEngine&) = delete;
+
+  ~AcquisitionEngine() { stop(); }
+
+  /** \brief Adds a device to a bus. Not allowed while running.
+   *  \param bus Bus index (0 to Buses-1); its devices must share no WIRE object with other buses
+   *  \param ads Driver, already initialised with begin()
+   *  \param entry Input, gain and rate to convert
+   *  \return false if the bus index is out of range, the bus is full or the engine is running */
+  bool addDevice(size_t bus, ADC& ads, const ScanEntry& entry) {
+    if (bus >= Buses || _running.load()) { return false; }
+    return _workers[bus].add(ads, entry);
+  }
+
+  /** \brief Sets what workers do when their queue is full. Not allowed while running.
+   *  \param policy Backpressure::WAIT (default) or Backpressure::DROP */
+  void setBackpressure(Backpressure policy) { _policy = policy; }
+
+  /** \brief Sets how workers wait after a pass in which no conversion had finished. Not allowed while running.
+   *  \param idle Sleep function, e.g. one calling std::this_thread::sleep_for; nullptr (default) to yield
+   *  \param micros Argument passed to idle */
+  void setIdleFunction(DelayFunction idle, uint32_t micros) {
+    _idle       = idle;
+    _idleMicros = micros;
+  }
+
+  /** \brief Starts one worker thread per bus that has devices. */
+  void start() {
+    if (_running.exchange(true)) { return; }
+    uint32_t now = _clock();
+    for (size_t b = 0; b < Buses; b++) {
+      _workers[b].resetWatermark(now);
+      if (_workers[b].size() == 0) { continue; }
+      _threads[b] = std::thread([this, b] {
+        _workers[b].run(static_cast<uint8_t>(b), _running, _clock, _policy, _idle, _idleMicros);
+      });
+    }
+  }
+
+  /** \brief Stops and joins the workers. Samples already queued can still be taken with next(). */
+  void stop() {
+    _running.store(false);
+    for (size_t b = 0; b < Buses; b++) {
+      if (_threads[b].joinable()) { _threads[b].join(); }
+    }
+  }
+
+  /** \brief Checks whether the workers are running.
+   *  \return true between start() and stop() */
+  bool running() const { return _running.load(); }
+
+  /** \brief Consumer: takes the next sample of the merged stream.
+   *
+   *  Samples come out in timestamp order across all buses. Call from one thread only.
+   *  \param sample Receives the sample
+   *  \return false if no sample can be released yet */
+  bool next(AcquiredSample& sample) {
+    bool retry = true;
+    while (retry) {
+      size_t first = Buses;
+      for (size_t b = 0; b < Buses; b++) {
+        if (!_hasHead[b]) { _hasHead[b] = _workers[b].pop(_head[b]); }
+        if (_hasHead[b] && (first == Buses || Worker::before(_head[b].timestamp, _head[first].timestamp))) {
+          first = b;
+        }
+      }
+      if (first == Buses) { return false; }
+      if (!_running.load() || released(first, retry)) {
+        sample          = _head[first];
+        _hasHead[first] = false;
+        _merged++;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** \brief Gets the counters of one bus's worker. Safe from any thread.
+   *  \param bus Bus index
+   *  \return Counters (all zero for an out-of-range index) */
+  AcquisitionStats stats(size_t bus) const { return bus < Buses ? _workers[bus].stats() : AcquisitionStats{}; }
+
+  /** \brief Gets the counters summed over all buses. Safe from any thread.
+   *  \return Counters */
+  AcquisitionStats totals() const {
+    AcquisitionStats total{};
+    for (size_t b = 0; b < Buses; b++) {
+      AcquisitionStats s = _workers[b].stats();
+      total.produced += s.produced;
+      total.dropped += s.dropped;
+      total.stalls += s.stalls;
+      total.readErrors += s.readErrors;
+    }
+    return total;
+  }
+
+  /** \brief Gets the number of samples returned by next().
+   *  \return Sample count */
+  uint64_t merged() const { return _merged; }
+
+  private:
+  using Worker = BusWorker<ADC, MaxDevices, QueueCapacity>;
+
+  // Checks that no bus with nothing queued can still produce a sample earlier than the head of bus first. Sets retry
+  // if a sample arrived while checking, as it may be the earlier one.
+  bool released(size_t first, bool& retry) {
+    retry = false;
+    for (size_t b = 0; b < Buses; b++) {
+      if (_hasHead[b] || _workers[b].size() == 0) { continue; }
+      if (Worker::before(_workers[b].watermark(), _head[first].timestamp)) { return false; }
+      // Samples queued before the watermark was published are visible now.
+      if (_workers[b].pop(_head[b])) {
+        _hasHead[b] = true;
+        retry       = true;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  ClockFunction _clock;
+  Backpressure _policy     = Backpressure::WAIT;
+  DelayFunction _idle      = nullptr;
+  uint32_t _idleMicros     = 0;
+  std::atomic<bool> _running{false};
+  Worker _workers[Buses];
+  std::thread _threads[Buses];
+  AcquiredSample _head[Buses] = {}; ///< Oldest sample taken from each queue but not yet released
+  bool _hasHead[Buses]        = {};
+  uint64_t _merged            = 0;
+};
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_ACQUISITION_H
@@ -0,0 +1,298 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_ASYNC_I2C_H
+#define ADS1X15_ASYNC_I2C_H
+
+#include "ADS1X15.h"
+#include "ADS1X15RingBuffer.h"
+
+namespace ADS1X15 {
+
+struct I2CTransaction;
+
+/** \brief Called when a queued transaction has finished, from the context that completed it (e.g. an interrupt).
+ *  \param transaction The finished transaction, with status and data filled in
+ *  \param context Context pointer given with the transaction */
+using TransactionCallback = void (*)(const I2CTransaction& transaction, void* context);
+
+/** \brief Called by an asynchronous backend when the transaction it was given has finished.
+ *  \param context Context pointer given to the backend's start()
+ *  \param status Outcome of the transaction */
+using CompletionFunction = void (*)(void* context, Status status);
+
+constexpr uint8_t I2C_TRANSACTION_DATA_LENGTH = 2; ///< Largest register payload or read, in bytes
+
+/**
+ * \brief Fixed-size descriptor of one register access, executed by an asynchronous I2C backend.
+ *
+ * The backend writes the pointer byte and writeLength payload bytes. If readLength is non-zero it then reads that
+ * many bytes into data after a repeated start. Build descriptors with writeRegister() and readRegister(), or with the
+ * chip-aware helpers of ADS1X15Transactions.
+ */
+struct I2CTransaction {
+  uint8_t address;                              ///< 7-bit device address
+  uint8_t pointer;                              ///< Register pointer byte, always written first
+  uint8_t writeLength;                          ///< Payload bytes written after the pointer
+  uint8_t readLength;                           ///< Bytes read after a repeated start; 0 for a write
+  uint8_t payload[I2C_TRANSACTION_DATA_LENGTH]; ///< Bytes written after the pointer, MSB first
+  uint8_t data[I2C_TRANSACTION_DATA_LENGTH];    ///< Bytes read, MSB first; filled in by the backend
+  Status status;                                ///< Outcome; filled in by the backend
+  TransactionCallback callback;                 ///< Called on completion; may be nullptr
+  void* context;                                ///< Passed to callback
+
+  /** \brief Makes a 16-bit register write.
+   *  \param address Device address
+   *  \param reg Register
+   *  \param value Value to write
+   *  \param callback Completion callback, or nullptr
+   *  \param context Passed to callback
+   *  \return Descriptor */
+  static I2CTransaction writeRegister(uint8_t address, RegisterAddress reg, uint16_t value,
+                                      TransactionCallback callback = nullptr, void* context = nullptr) {
+    return I2CTransaction{address,
+                          static_cast<uint8_t>(reg),
+                          2,
+                          0,
+                          {static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value & 0xFF)},
+                          {0, 0},
+                          Status::OK,
+                          callback,
+                          context};
+  }
+
+  /** \brief Makes a 16-bit register read: pointer write, repeated start, two-byte read.
+   *  \param address Device address
+   *  \param reg Register
+   *  \param callback Completion callback, or nullptr
+   *  \param context Passed to callback
+   *  \return Descriptor */
+  static I2CTransaction readRegister(uint8_t address, RegisterAddress reg, TransactionCallback callback = nullptr,
+                                     void* context = nullptr) {
+    return I2CTransaction{address, static_cast<uint8_t>(reg), 0, 2, {0, 0}, {0, 0}, Status::OK, callback, context};
+  }
+
+  /** \brief Gets the 16-bit value read.
+   *  \return Register value */
+  uint16_t value() const { return static_cast<uint16_t>(static_cast<uint16_t>(data[0]) << 8 | data[1]); }
+
+  /** \brief Checks whether the transaction succeeded.
+   *  \return true if status is Status::OK */
+  bool ok() const { return status == Status::OK; }
+};
+
+/**
+ * \brief Builds the descriptors for one chip's register accesses, for use with a TransactionQueue.
+ *
+ * This is the asynchronous counterpart of the driver's start/poll/read calls. It keeps no state, so results are
+ * decoded from the finished descriptors with count() and conversionComplete().
+ *
+ * \tparam Chip Chip traits (ADS1015Traits or ADS1115Traits)
+ */
+template <typename Chip> class ADS1X15Transactions {
+  public:
+  /** \brief Constructs a builder.
+   *  \param address Device address (0x48-0x4B) */
+  explicit ADS1X15Transactions(uint8_t address = ADS1X15_ADDRESS) : _address(address) {}
+
+  /** \brief Makes the write that starts a conversion (as startReading()).
+   *
+   *  To use the ALERT/RDY pin as a data-ready signal, first queue writeRegister(HITHRESH, 0x8000) and
+   *  writeRegister(LOTHRESH, 0x0000) once.
+   *  \param entry Input, gain, rate and mode
+   *  \param callback Completion callback, or nullptr
+   *  \param context Passed to callback
+   *  \return Descriptor */
+  I2CTransaction startReading(const ScanEntry& entry, TransactionCallback callback = nullptr,
+                              void* context = nullptr) const {
+    return writeRegister(RegisterAddress::CONFIG, entry.config, callback, context);
+  }
+
+  /** \brief Makes a CONFIG read, to check whether a conversion is done with conversionComplete().
+   *  \param callback Completion callback, or nullptr
+   *  \param context Passed to callback
+   *  \return Descriptor */
+  I2CTransaction readConfig(TransactionCallback callback = nullptr, void* context = nullptr) const {
+    return readRegister(RegisterAddress::CONFIG, callback, context);
+  }
+
+  /** \brief Makes a CONVERSION read, to be decoded with count().
+   *  \param callback Completion callback, or nullptr
+   *  \param context Passed to callback
+   *  \return Descriptor */
+  I2CTransaction readConversion(TransactionCallback callback = nullptr, void* context = nullptr) const {
+    return readRegister(RegisterAddress::CONVERSION, callback, context);
+  }
+
+  /** \brief Makes a register write.
+   *  \param reg Register
+   *  \param value Value to write
+   *  \param callback Completion callback, or nullptr
+   *  \param context Passed to callback
+   *  \return Descriptor */
+  I2CTransaction writeRegister(RegisterAddress reg, uint16_t value, TransactionCallback callback = nullptr,
+                               void* context = nullptr) const {
+    return I2CTransaction::writeRegister(_address, reg, value, callback, context);
+  }
+
+  /** \brief Makes a register read.
+   *  \param reg Register
+   *  \param callback Completion callback, or nullptr
+   *  \param context Passed to callback
+   *  \return Descriptor */
+  I2CTransaction readRegister(RegisterAddress reg, TransactionCallback callback = nullptr,
+                              void* context = nullptr) const {
+    return I2CTransaction::readRegister(_address, reg, callback, context);
+  }
+
+  /** \brief Decodes a finished CONVERSION read.
+   *  \param transaction Descriptor from readConversion()
+   *  \return Conversion result in counts */
+  static int16_t count(const I2CTransaction& transaction) { return Chip::countFromRegister(transaction.value()); }
+
+  /** \brief Decodes a finished CONFIG read.
+   *  \param transaction Descriptor from readConfig()
+   *  \return true if no conversion is in progress */
+  static bool conversionComplete(const I2CTransaction& transaction) {
+    return (transaction.value() & ADS1X15_REG_CONFIG_OS_MASK) == ADS1X15_REG_CONFIG_OS_NOTBUSY;
+  }
+
+  /** \brief Gets the device address.
+   *  \return Address */
+  uint8_t address() const { return _address; }
+
+  private:
+  uint8_t _address;
+};
+
+using ADS1015Transactions = ADS1X15Transactions<ADS1015Traits>; ///< Descriptor builder for an ADS1015
+using ADS1115Transactions = ADS1X15Transactions<ADS1115Traits>; ///< Descriptor builder for an ADS1115
+
+/**
+ * \brief Bounded queue of I2C transactions executed one after another by an asynchronous backend, such as an
+ * interrupt- or DMA-driven I2C controller, while the CPU does other work.
+ *
+ * submit() copies a descriptor into the queue and returns at once. The backend is given one transaction at a time.
+ * When it reports completion, the next queued transaction is handed to it straight away, and only then is the
+ * finished transaction's callback run, so the bus does not sit idle while callbacks run. Transactions complete in the
+ * order they were submitted.
+ *
+ * The backend needs one member:
+ * \code
+ * // Begins the transfer and returns; calls done(context, status) later, e.g. from the transfer-complete interrupt.
+ * // The read bytes go into transaction.data, which stays valid until done() is called.
+ * void start(I2CTransaction& transaction, CompletionFunction done, void* context);
+ * \endcode
+ *
+ * submit() and the completion can run in different contexts, e.g. the main loop and an interrupt. The queue's
+ * bookkeeping is then guarded by the Lock policy, which must keep the completion out while it is held. Typically
+ * that means masking the controller's interrupt. The default, NoBusLock, is only right when both run in the same
+ * context. The lock is not held while callbacks run, so a callback may submit the next transaction.
+ *
+ * \tparam Backend Asynchronous I2C backend
+ * \tparam Capacity Transactions that can wait behind the one in progress; a power of two
+ * \tparam Lock Policy with lock() and unlock() around the queue's bookkeeping (see NoBusLock)
+ */
+template <typename Backend, size_t Capacity = 8, typename Lock = NoBusLock> class TransactionQueue {
+  public:
+  /** \brief Constructs a queue.
+   *  \param backend Backend that executes the transactions; must outlive the queue */
+  explicit TransactionQueue(Backend& backend) : mBackend(backend) {}
+
+  TransactionQueue(const TransactionQueue&)            = delete;
+  TransactionQueue& operator=(const TransactionQueue&) = delete;
+
+  /** \brief Queues a transaction. If the backend is idle it is started at once.
+   *  \param transaction Descriptor; copied
+   *  \return false if the queue is full; nothing was queued */
+  bool submit(const I2CTransaction& transaction) {
+    Guard guard(_lock);
+    if (!_queue.push(transaction)) { return false; }
+    _submitted++;
+    if (!_busy) { startNext(); }
+    return true;
+  }
+
+  /** \brief Gets the number of transactions queued or in progress.
+   *  \return Transaction count */
+  size_t pending() {
+    Guard guard(_lock);
+    return _queue.size() + (_busy ? 1 : 0);
+  }
+
+  /** \brief Checks whether the backend is executing a transaction.
+   *  \return true if busy */
+  bool busy() {
+    Guard guard(_lock);
+    return _busy;
+  }
+
+  /** \brief Gets the number of transactions accepted by submit().
+   *  \return Transaction count */
+  uint32_t submitted() const { return _submitted; }
+
+  /** \brief Gets the number of transactions completed, successfully or not.
+   *  \return Transaction count */
+  uint32_t completed() const { return _completed; }
+
+  /** \brief Gets the number of transactions that completed with an error.
+   *  \return Transaction count */
+  uint32_t failed() const { return _failed; }
+
+  /** \brief Gets the lock policy, e.g. to attach it to a mutex.
+   *  \return Lock policy */
+  Lock& lock() { return _lock; }
+
+  /** \brief Gets the maximum number of waiting transactions.
+   *  \return Capacity */
+  static constexpr size_t capacity() { return Capacity; }
+
+  private:
+  class Guard {
+    public:
+    explicit Guard(Lock& lock) : mLock(lock) { mLock.lock(); }
+    ~Guard() { mLock.unlock(); }
+
+    private:
+    Lock& mLock;
+  };
+
+  static void onComplete(void* context, Status status) { static_cast<TransactionQueue*>(context)->finish(status); }
+
+  void finish(Status status) {
+    I2CTransaction done;
+    {
+      Guard guard(_lock);
+      done        = _active;
+      done.status = status;
+      _busy       = false;
+      _completed++;
+      if (status != Status::OK) { _failed++; }
+      startNext();
+    }
+    if (done.callback != nullptr) { done.callback(done, done.context); }
+  }
+
+  // Hands the oldest queued transaction to the backend. Called with the lock held.
+  void startNext() {
+    if (!_queue.pop(_active)) { return; }
+    _busy = true;
+    mBackend.start(_active, &onComplete, this);
+  }
+
+  Backend& mBackend;
+  Lock _lock;
+  SpscRingBuffer<I2CTransaction, Capacity> _queue;
+  I2CTransaction _active = {};
+  bool _busy             = false;
+  uint32_t _submitted    = 0;
+  uint32_t _completed    = 0;
+  uint32_t _failed       = 0;
+};
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_ASYNC_I2C_H
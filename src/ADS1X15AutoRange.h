@@ -0,0 +1,181 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_AUTO_RANGE_H
+#define ADS1X15_AUTO_RANGE_H
+
+#include "ADS1X15.h"
+
+namespace ADS1X15 {
+
+/** \brief A conversion result tagged with the gain it was taken at. */
+struct RangedSample {
+  int16_t count; ///< Conversion result
+  Gain gain;     ///< PGA setting used for the conversion
+};
+
+/**
+ * \brief Chooses the PGA gain for the next conversion from the previous result.
+ *
+ * The gain changes only when a result leaves its hysteresis band. A result above 15/16 of full scale moves to a
+ * wider range. A result that would sit below 12/16 of the next narrower range moves to a narrower one. In both cases
+ * the ranger jumps straight to the narrowest gain that puts the value at or below 12/16 of full scale. So a steady
+ * input settles on one gain, and no result is discarded. Only a saturated result, whose true value is unknown, asks
+ * for a re-conversion, at the widest range.
+ *
+ * All arithmetic is unsigned 32-bit integer.
+ *
+ * \tparam Chip Chip traits (ADS1015Traits or ADS1115Traits)
+ */
+template <typename Chip> class AutoRanger {
+  public:
+  /** \brief Constructs a ranger.
+   *  \param initial Gain for the first conversion */
+  explicit AutoRanger(Gain initial = Gain::TWOTHIRDS_6144MV) : _index(indexOf(initial)) {}
+
+  /** \brief Gets the gain to use for the next conversion.
+   *  \return Gain setting */
+  Gain gain() const { return gainAt(_index); }
+
+  /** \brief Feeds a result and picks the gain for the next conversion.
+   *  \param count Conversion result
+   *  \param measuredAt Gain the result was taken at
+   *  \return true if the result is usable; false if it was saturated and should be re-converted at gain() */
+  bool update(int16_t count, Gain measuredAt) {
+    uint8_t index = indexOf(measuredAt);
+    if (count >= Chip::countMax() || count <= Chip::countMin()) {
+      // Clipped at the widest range is as good as it gets; otherwise redo it there.
+      _index = 0;
+      return index == 0;
+    }
+
+    int32_t value      = count;
+    uint32_t magnitude = static_cast<uint32_t>(value < 0 ? -value : value);
+    // The input in (mV range * counts) units: comparable across gains without division.
+    uint32_t level = magnitude * RANGE_MV[index] * FRACTION;
+    bool tooHigh   = level > HIGH * fullScale() * RANGE_MV[index];
+    bool tooLow    = index < NARROWEST && level < TARGET * fullScale() * RANGE_MV[index + 1];
+    _index         = (tooHigh || tooLow) ? bestIndex(level) : index;
+    return true;
+  }
+
+  private:
+  static constexpr uint32_t FRACTION   = 16; // thresholds are in 1/16ths of full scale
+  static constexpr uint32_t HIGH       = 15; // widen above 15/16
+  static constexpr uint32_t TARGET     = 12; // land at or below 12/16
+  static constexpr uint8_t NARROWEST   = 5;  // Gain::SIXTEEN_256MV
+  static constexpr uint16_t RANGE_MV[] = {6144, 4096, 2048, 1024, 512, 256};
+
+  static uint32_t fullScale() { return static_cast<uint32_t>(Chip::fullScaleCounts()); }
+
+  static uint8_t indexOf(Gain gain) {
+    uint8_t index = static_cast<uint8_t>(static_cast<uint16_t>(gain) >> 9);
+    if (index > NARROWEST) { return NARROWEST; }
+    return index;
+  }
+
+  static Gain gainAt(uint8_t index) { return static_cast<Gain>(static_cast<uint16_t>(index) << 9); }
+
+  static uint8_t bestIndex(uint32_t level) {
+    for (uint8_t i = NARROWEST; i > 0; i--) {
+      if (level <= TARGET * fullScale() * RANGE_MV[i]) { return i; }
+    }
+    return 0;
+  }
+
+  uint8_t _index;
+};
+
+/// \cond
+template <typename Chip> constexpr uint16_t AutoRanger<Chip>::RANGE_MV[];
+/// \endcond
+
+/**
+ * \brief Non-blocking single-input acquisition with automatic gain selection.
+ *
+ * Runs back-to-back single-shot conversions of one input, choosing each conversion's gain with an AutoRanger.
+ * Every poll() that finds a conversion finished starts the next one, so in the steady state each conversion yields
+ * exactly one sample.
+ *
+ * A bus error leaves the gain unchanged: the failed read is retried, or the failed start reissued, on the next poll().
+ *
+ * \tparam ADC Driver type (e.g. ADS1115<TwoWire>)
+ */
+template <typename ADC> class AutoRangeReader {
+  public:
+  /** \brief Constructs a reader.
+   *  \param ads ADC to drive
+   *  \param entry Input and rate to convert; its gain is the starting gain */
+  AutoRangeReader(ADC& ads, const ScanEntry& entry) : mAds(ads), _entry(entry), _ranger(entry.gain()) {}
+
+  /** \brief Starts the first conversion. */
+  void start() { startConversion(); }
+
+  /** \brief Collects a finished conversion without blocking and starts the next.
+   *  \param sample Receives the result and its gain
+   *  \return true if a sample was produced; false if still converting, after a bus error, or if a saturated result
+   *  is being redone */
+  bool poll(RangedSample& sample) {
+    if (_startPending) {
+      startConversion();
+      return false;
+    }
+    bool complete = false;
+    if (!check(mAds.tryConversionComplete(complete)) || !complete) { return false; }
+    ReadResult r = mAds.tryGetLastConversionResults();
+    if (!check(r.status)) { return false; }
+    int16_t count = r.value;
+    bool usable   = _ranger.update(count, _gain);
+    if (usable) {
+      sample = RangedSample{count, _gain};
+    } else {
+      _reconversions++;
+    }
+    startConversion();
+    return usable;
+  }
+
+  /** \brief Gets the gain the next conversion will use.
+   *  \return Gain setting */
+  Gain gain() const { return _ranger.gain(); }
+
+  /** \brief Gets the number of saturated results that were re-converted.
+   *  \return Re-conversion count */
+  uint32_t reconversions() const { return _reconversions; }
+
+  /** \brief Gets the outcome of the most recent bus access made by start() or poll().
+   *  \return Status::OK, or the bus error that occurred */
+  Status status() const { return _status; }
+
+  /** \brief Gets the number of bus errors seen since construction.
+   *  \return Error count */
+  uint32_t busErrors() const { return _busErrors; }
+
+  private:
+  bool check(Status status) {
+    _status = status;
+    if (status != Status::OK) { _busErrors++; }
+    return status == Status::OK;
+  }
+
+  void startConversion() {
+    _gain         = _ranger.gain();
+    _startPending = !check(mAds.startReading(_entry.withGain(_gain)));
+  }
+
+  ADC& mAds;
+  ScanEntry _entry;
+  AutoRanger<typename ADC::Traits> _ranger;
+  Gain _gain              = Gain::TWOTHIRDS_6144MV;
+  uint32_t _reconversions = 0;
+  uint32_t _busErrors     = 0;
+  Status _status          = Status::OK;
+  bool _startPending      = false;
+};
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_AUTO_RANGE_H
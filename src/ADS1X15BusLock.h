@@ -0,0 +1,55 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_BUS_LOCK_H
+#define ADS1X15_BUS_LOCK_H
+
+// Host-only: uses the C++ standard library. Not for use on microcontrollers.
+
+#include <mutex>
+
+#include "ADS1X15.h"
+
+namespace ADS1X15 {
+
+/**
+ * \brief Bus-lock policy that locks a mutex shared by every driver on the same bus.
+ *
+ * Use it as the BusLock parameter of the drivers, e.g. ADS1115<LinuxI2C, NoInstrumentation, MutexBusLock>, and attach
+ * each driver to the bus's mutex before use. Each driver can then run in its own thread: register transactions on the
+ * bus never interleave, and a pointer write always stays with the read it belongs to.
+ *
+ * The lock is taken per transaction, not for a whole conversion, so other chips can use the bus while a conversion
+ * runs. A driver instance itself must still only be used from one thread at a time.
+ *
+ * \tparam Mutex Mutex type with lock() and unlock() (std::mutex, or e.g. a wrapper around an RTOS semaphore)
+ */
+template <typename Mutex = std::mutex> class BasicMutexBusLock {
+  public:
+  /** \brief Attaches the policy to the bus's mutex. Until then, lock() and unlock() do nothing.
+   *  \param mutex Mutex shared by every driver on the bus; must outlive the driver */
+  void attach(Mutex& mutex) { _mutex = &mutex; }
+
+  /** \brief Locks the bus before a register transaction. */
+  void lock() {
+    if (_mutex != nullptr) { _mutex->lock(); }
+  }
+
+  /** \brief Unlocks the bus after a register transaction. */
+  void unlock() {
+    if (_mutex != nullptr) { _mutex->unlock(); }
+  }
+
+  private:
+  Mutex* _mutex = nullptr;
+};
+
+/** \brief Bus-lock policy using std::mutex. */
+using MutexBusLock = BasicMutexBusLock<>;
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_BUS_LOCK_H
@@ -0,0 +1,258 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_CALIBRATION_H
+#define ADS1X15_CALIBRATION_H
+
+#include "ADS1X15.h"
+
+namespace ADS1X15 {
+
+/*
+ * Calibration blob format (all multi-byte fields little-endian):
+ *
+ *   offset  size  field
+ *   0       2     magic "AC"
+ *   2       1     format version (CALIBRATION_VERSION)
+ *   3       1     chip resolution in bits (12 or 16)
+ *   4       1     number of entries
+ *   5       8n    entries: key (mux index * 6 + gain index), shift, scale (16 bits), bias (32 bits)
+ *   5+8n    2     CRC-16/CCITT-FALSE of bytes 0 .. 5+8n-1
+ */
+
+constexpr uint8_t CALIBRATION_VERSION    = 1;    ///< Format version written in every blob
+constexpr uint8_t CALIBRATION_KEYS       = 48;   ///< 8 MUX settings times 6 gains
+constexpr uint8_t CALIBRATION_NO_SLOT    = 0xFF; ///< Slot index of an uncalibrated input and gain
+constexpr size_t CALIBRATION_HEADER_SIZE = 5;    ///< Blob bytes before the entries
+constexpr size_t CALIBRATION_ENTRY_SIZE  = 8;    ///< Blob bytes per entry
+constexpr size_t CALIBRATION_CRC_SIZE    = 2;    ///< Blob bytes after the entries
+
+/**
+ * \brief Calibration coefficients for up to N (input, gain) combinations.
+ *
+ * Each combination holds a Calibration, so a calibrated conversion costs one multiply, one add and one shift.
+ * Combinations without an entry use the nominal coefficients. Lookups index a 48-byte table directly, with no search.
+ *
+ * The table serialises to a compact, CRC-protected blob (see maxBlobSize()) for EEPROM or flash.
+ *
+ * \tparam Chip Chip traits (ADS1015Traits or ADS1115Traits)
+ * \tparam N Maximum number of calibrated combinations (1 to 48)
+ */
+template <typename Chip, uint8_t N> class CalibrationTable {
+  static_assert(N > 0 && N <= CALIBRATION_KEYS, "Table holds 1 to 48 entries");
+
+  public:
+  /** \brief Constructs an empty table: every input uses the nominal coefficients. */
+  CalibrationTable() { clear(); }
+
+  /** \brief Sets the coefficients for an input and gain, replacing any already set.
+   *  \param mux MUX bits (ADS1X15_REG_CONFIG_MUX_*)
+   *  \param gain Gain setting
+   *  \param calibration Coefficients
+   *  \return false if the table is full */
+  bool set(uint16_t mux, Gain gain, const Calibration& calibration) {
+    uint8_t key = keyOf(mux, gain);
+    if (_slotOf[key] == CALIBRATION_NO_SLOT) {
+      if (_size == N) { return false; }
+      _keys[_size] = key;
+      _slotOf[key] = _size++;
+    }
+    _entries[_slotOf[key]] = calibration;
+    return true;
+  }
+
+  /** \brief Sets the coefficients for the input and gain of a scan entry.
+   *  \param entry Input and gain
+   *  \param calibration Coefficients
+   *  \return false if the table is full */
+  bool set(const ScanEntry& entry, const Calibration& calibration) {
+    return set(entry.mux(), entry.gain(), calibration);
+  }
+
+  /** \brief Gets the coefficients for an input and gain.
+   *  \param mux MUX bits (ADS1X15_REG_CONFIG_MUX_*)
+   *  \param gain Gain setting
+   *  \return Coefficients; the nominal ones if none are set */
+  Calibration get(uint16_t mux, Gain gain) const {
+    uint8_t slot = _slotOf[keyOf(mux, gain)];
+    if (slot == CALIBRATION_NO_SLOT) { return Calibration::nominal<Chip>(gain); }
+    return _entries[slot];
+  }
+
+  /** \brief Gets the coefficients for the input and gain of a scan entry.
+   *  \param entry Input and gain
+   *  \return Coefficients; the nominal ones if none are set */
+  Calibration get(const ScanEntry& entry) const { return get(entry.mux(), entry.gain()); }
+
+  /** \brief Checks whether an input and gain has coefficients set.
+   *  \param mux MUX bits (ADS1X15_REG_CONFIG_MUX_*)
+   *  \param gain Gain setting
+   *  \return true if set */
+  bool contains(uint16_t mux, Gain gain) const { return _slotOf[keyOf(mux, gain)] != CALIBRATION_NO_SLOT; }
+
+  /** \brief Converts a count to calibrated microvolts.
+   *  \param mux MUX bits of the input the count was taken from
+   *  \param gain Gain the count was taken at
+   *  \param count ADC count value to convert
+   *  \return Voltage in microvolts */
+  int32_t microvolts(uint16_t mux, Gain gain, int16_t count) const { return get(mux, gain).microvolts(count); }
+
+  /** \brief Gets the number of calibrated combinations.
+   *  \return Entry count */
+  uint8_t size() const { return _size; }
+
+  /** \brief Removes every entry. */
+  void clear() {
+    for (uint8_t i = 0; i < CALIBRATION_KEYS; i++) { _slotOf[i] = CALIBRATION_NO_SLOT; }
+    _size = 0;
+  }
+
+  /** \brief Gets the blob size of a full table.
+   *  \return Bytes */
+  static constexpr size_t maxBlobSize() {
+    return CALIBRATION_HEADER_SIZE + N * CALIBRATION_ENTRY_SIZE + CALIBRATION_CRC_SIZE;
+  }
+
+  /** \brief Writes the table as a blob.
+   *  \param out Destination
+   *  \param capacity Size of out in bytes (maxBlobSize() is always enough)
+   *  \return Bytes written, or 0 if capacity is too small */
+  size_t serialize(uint8_t* out, size_t capacity) const {
+    size_t length = CALIBRATION_HEADER_SIZE + _size * CALIBRATION_ENTRY_SIZE + CALIBRATION_CRC_SIZE;
+    if (capacity < length) { return 0; }
+    size_t pos = 0;
+    out[pos++] = 'A';
+    out[pos++] = 'C';
+    out[pos++] = CALIBRATION_VERSION;
+    out[pos++] = Chip::resolutionBits();
+    out[pos++] = _size;
+    for (uint8_t i = 0; i < _size; i++) {
+      const Calibration& c = _entries[i];
+      out[pos++]           = _keys[i];
+      out[pos++]           = c.shift;
+      putBytes(out + pos, static_cast<uint16_t>(c.scale), 2);
+      putBytes(out + pos + 2, static_cast<uint32_t>(c.bias), 4);
+      pos += 6;
+    }
+    putBytes(out + pos, crc16Ccitt(0xFFFF, out, pos), 2);
+    return length;
+  }
+
+  /** \brief Replaces the table with the contents of a blob.
+   *  \param data Blob written by serialize()
+   *  \param n Size of data in bytes (may include trailing bytes, e.g. the rest of an EEPROM area)
+   *  \return false (table unchanged) if the blob is damaged, from the other chip or has too many entries */
+  bool deserialize(const uint8_t* data, size_t n) {
+    if (n < CALIBRATION_HEADER_SIZE + CALIBRATION_CRC_SIZE) { return false; }
+    if (data[0] != 'A' || data[1] != 'C' || data[2] != CALIBRATION_VERSION || data[3] != Chip::resolutionBits()) {
+      return false;
+    }
+    uint8_t count = data[4];
+    size_t end    = CALIBRATION_HEADER_SIZE + count * CALIBRATION_ENTRY_SIZE;
+    if (count > N || n < end + CALIBRATION_CRC_SIZE) { return false; }
+    if (crc16Ccitt(0xFFFF, data, end) != getBytes(data + end, 2)) { return false; }
+
+    bool seen[CALIBRATION_KEYS] = {};
+    for (const uint8_t* e = data + CALIBRATION_HEADER_SIZE; e < data + end; e += CALIBRATION_ENTRY_SIZE) {
+      int16_t scale = static_cast<int16_t>(getBytes(e + 2, 2));
+      if (e[0] >= CALIBRATION_KEYS || seen[e[0]] || e[1] > 24 || scale <= 0) { return false; }
+      seen[e[0]] = true;
+    }
+
+    clear();
+    for (const uint8_t* e = data + CALIBRATION_HEADER_SIZE; e < data + end; e += CALIBRATION_ENTRY_SIZE) {
+      _keys[_size]      = e[0];
+      _slotOf[e[0]]     = _size;
+      int32_t bias      = static_cast<int32_t>(getBytes(e + 4, 4));
+      _entries[_size++] = Calibration{bias, static_cast<int16_t>(getBytes(e + 2, 2)), e[1]};
+    }
+    return true;
+  }
+
+  private:
+  static uint8_t keyOf(uint16_t mux, Gain gain) {
+    uint8_t gainIndex = static_cast<uint8_t>(static_cast<uint16_t>(gain) >> 9);
+    if (gainIndex > 5) { gainIndex = 5; } // PGA 110 and 111 are also +/-0.256 V
+    return static_cast<uint8_t>(((mux & ADS1X15_REG_CONFIG_MUX_MASK) >> 12) * 6 + gainIndex);
+  }
+
+  static void putBytes(uint8_t* out, uint32_t value, uint8_t n) {
+    for (uint8_t i = 0; i < n; i++) { out[i] = static_cast<uint8_t>(value >> (8 * i)); }
+  }
+
+  static uint32_t getBytes(const uint8_t* in, uint8_t n) {
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < n; i++) { value |= static_cast<uint32_t>(in[i]) << (8 * i); }
+    return value;
+  }
+
+  uint8_t _slotOf[CALIBRATION_KEYS]; ///< Entry index by key, or CALIBRATION_NO_SLOT
+  uint8_t _keys[N];                  ///< Key of each entry
+  Calibration _entries[N];           ///< Coefficients of each entry
+  uint8_t _size;                     ///< Number of entries in use
+};
+
+/** \brief Averages single-shot conversions of one input, e.g. to measure an offset or a reference.
+ *  \param ads ADC to read
+ *  \param entry Input, gain and rate to convert
+ *  \param samples Number of conversions to average (at least 1)
+ *  \return Status of the first failed read, or OK and the average count rounded to nearest */
+template <typename ADC> ReadResult measureAverage(ADC& ads, const ScanEntry& entry, uint8_t samples) {
+  using Chip       = typename ADC::Traits;
+  // Twice the longest conversion, as without a clock function each poll only counts ADS1X15_POLL_ESTIMATE_US.
+  uint32_t timeout = 2 * conversionTimeMaxMicros(entry.rate<Chip>());
+  if (samples == 0) { samples = 1; }
+
+  int32_t sum = 0;
+  for (uint8_t i = 0; i < samples; i++) {
+    Status status = ads.startReading(entry);
+    if (status == Status::OK) { status = ads.tryWaitForConversion(timeout); }
+    if (status != Status::OK) { return ReadResult{status, 0}; }
+    ReadResult r = ads.tryGetLastConversionResults();
+    if (!r.ok()) { return r; }
+    sum += r.value;
+  }
+  int32_t half = samples / 2;
+  return ReadResult{Status::OK, static_cast<int16_t>((sum >= 0 ? sum + half : sum - half) / samples)};
+}
+
+/** \brief Measures and stores the offset of an input and gain. The input must be at zero volts while this runs:
+ *  a grounded pin for a single-ended input, or both pins tied together for a differential pair.
+ *
+ *  Any gain correction already in the table for the entry is kept.
+ *  \param ads ADC to read
+ *  \param table Table to update
+ *  \param entry Input, gain and rate to measure
+ *  \param samples Number of conversions to average
+ *  \return Status of the reads, or Status::INVALID_ARGUMENT if the table is full */
+template <typename ADC, typename Table>
+Status calibrateOffset(ADC& ads, Table& table, const ScanEntry& entry, uint8_t samples = 16) {
+  ReadResult r = measureAverage(ads, entry, samples);
+  if (!r.ok()) { return r.status; }
+  return table.set(entry, table.get(entry).withOffset(r.value)) ? Status::OK : Status::INVALID_ARGUMENT;
+}
+
+/** \brief Measures a known reference voltage and stores the gain correction of an input and gain.
+ *
+ *  Run calibrateOffset() first; the offset already in the table is kept.
+ *  \param ads ADC to read
+ *  \param table Table to update
+ *  \param entry Input, gain and rate to measure
+ *  \param referenceMicrovolts Voltage applied to the input, in microvolts (ideally near full scale)
+ *  \param samples Number of conversions to average
+ *  \return Status of the reads, or Status::INVALID_ARGUMENT if the table is full */
+template <typename ADC, typename Table>
+Status calibrateGain(ADC& ads, Table& table, const ScanEntry& entry, int32_t referenceMicrovolts,
+                     uint8_t samples = 16) {
+  ReadResult r = measureAverage(ads, entry, samples);
+  if (!r.ok()) { return r.status; }
+  Calibration calibration = Calibration::twoPoint(table.get(entry).offsetCounts(), r.value, referenceMicrovolts);
+  return table.set(entry, calibration) ? Status::OK : Status::INVALID_ARGUMENT;
+}
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_CALIBRATION_H
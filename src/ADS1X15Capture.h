@@ -0,0 +1,193 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_CAPTURE_H
+#define ADS1X15_CAPTURE_H
+
+#include "ADS1X15.h"
+
+namespace ADS1X15 {
+
+/*
+ * Capture block format (all multi-byte fields little-endian):
+ *
+ *   offset  size  field
+ *   0       4     magic "ADSX"
+ *   4       1     format version (CAPTURE_VERSION)
+ *   5       1     reserved (0)
+ *   6       2     payload length in bytes
+ *   8       2     number of samples
+ *   10      4     block sequence number
+ *   14      4     base timestamp (timestamp of the first sample)
+ *   18      n     payload
+ *   18+n    2     CRC-16/CCITT-FALSE of bytes 4 .. 18+n-1
+ *
+ * Each sample in the payload is:
+ *   tag      1 byte: bits 0-2 channel id, bit 3 set if a channel descriptor follows
+ *   [desc]   3 bytes: I2C address, then the CONFIG bits (MUX | PGA | DR) as a 16-bit word
+ *   dt       zigzag varint: timestamp minus the previous sample's (the base timestamp for the first)
+ *   dcount   zigzag varint: count minus the previous count of the same channel (0 at the start of a block)
+ *
+ * A channel's descriptor is sent with its first sample in every block, and deltas restart in every block. So each
+ * block decodes on its own, and a reader can resynchronise after corruption by scanning for the magic.
+ */
+
+constexpr uint8_t CAPTURE_MAGIC[] = {'A', 'D', 'S', 'X'}; ///< First bytes of every block
+
+constexpr uint8_t CAPTURE_VERSION      = 1;    ///< Format version written in every block header
+constexpr uint8_t CAPTURE_MAX_CHANNELS = 8;    ///< Channel ids fit in 3 bits
+constexpr uint8_t CAPTURE_NO_CHANNEL   = 0xFF; ///< Returned by defineChannel() when the table is full
+constexpr size_t CAPTURE_HEADER_SIZE   = 18;   ///< Bytes before the payload
+constexpr size_t CAPTURE_CRC_SIZE      = 2;    ///< Bytes after the payload
+constexpr size_t CAPTURE_MAX_SAMPLE    = 12;   ///< Largest encoded sample: tag, descriptor, 5-byte dt, 3-byte dcount
+constexpr uint16_t CAPTURE_CONFIG_MASK =
+    ADS1X15_REG_CONFIG_MUX_MASK | ADS1X15_REG_CONFIG_PGA_MASK | ADS1X15_REG_CONFIG_RATE_MASK; ///< CONFIG bits kept
+
+constexpr uint8_t CAPTURE_TAG_CHANNEL_MASK = 0x07; ///< Tag bits holding the channel id
+constexpr uint8_t CAPTURE_TAG_DESCRIPTOR   = 0x08; ///< Tag bit: a channel descriptor follows
+
+/**
+ * \brief Packs samples into self-contained, CRC-protected capture blocks in a fixed buffer.
+ *
+ * Define a channel for each (device, input, gain, rate) combination, then add() samples as they arrive. When add()
+ * reports that the block is full, write out the block from flush() and add the sample again. Call flush() once more at
+ * the end of a capture for the partial block. A slowly changing signal typically costs 3-4 bytes per sample.
+ *
+ * \tparam BlockSize Block buffer size in bytes, including header and CRC (e.g. 512 for one SD card sector)
+ */
+template <size_t BlockSize> class CaptureEncoder {
+  static_assert(BlockSize >= CAPTURE_HEADER_SIZE + CAPTURE_MAX_SAMPLE + CAPTURE_CRC_SIZE, "Block too small");
+  static_assert(BlockSize <= CAPTURE_HEADER_SIZE + 0xFFFF + CAPTURE_CRC_SIZE, "Payload length must fit 16 bits");
+
+  public:
+  /** \brief Defines a channel: one input of one device at one gain and rate.
+   *  \param address I2C address of the device
+   *  \param entry Input, gain and rate (other CONFIG bits are ignored)
+   *  \return Channel id for add(), or CAPTURE_NO_CHANNEL if all CAPTURE_MAX_CHANNELS are in use */
+  uint8_t defineChannel(uint8_t address, const ScanEntry& entry) {
+    if (_channelCount == CAPTURE_MAX_CHANNELS) { return CAPTURE_NO_CHANNEL; }
+    _channels[_channelCount].address = address;
+    _channels[_channelCount].config  = entry.config & CAPTURE_CONFIG_MASK;
+    return _channelCount++;
+  }
+
+  /** \brief Appends a sample to the current block.
+   *  \param channel Channel id from defineChannel()
+   *  \param count Conversion result
+   *  \param timestamp Sample time (e.g. micros(), or a SampleClock timestamp)
+   *  \return false if the block is full (flush() it and add the sample again) or the channel is undefined */
+  bool add(uint8_t channel, int16_t count, uint32_t timestamp) {
+    if (channel >= _channelCount || channel >= CAPTURE_MAX_CHANNELS) { return false; }
+    if (_length + CAPTURE_MAX_SAMPLE + CAPTURE_CRC_SIZE > BlockSize) { return false; }
+
+    if (_samples == 0) {
+      _baseTimestamp = timestamp;
+      _lastTimestamp = timestamp;
+    }
+
+    Channel& c  = _channels[channel];
+    uint8_t tag = channel;
+    if (!c.described) { tag |= CAPTURE_TAG_DESCRIPTOR; }
+    _block[_length++] = tag;
+    if (!c.described) {
+      _block[_length++] = c.address;
+      putWord(c.config);
+      c.described = true;
+    }
+    putZigzag(static_cast<int32_t>(timestamp - _lastTimestamp));
+    putZigzag(static_cast<int32_t>(count) - c.lastCount);
+    c.lastCount    = count;
+    _lastTimestamp = timestamp;
+    _samples++;
+    return true;
+  }
+
+  /** \brief Seals the current block and starts a new one.
+   *  \return Length of the sealed block at data(), valid until the next add(); 0 if the block was empty */
+  size_t flush() {
+    if (_samples == 0) { return 0; }
+    size_t payloadEnd = _length;
+
+    // The header is filled in last, once the payload length and sample count are known.
+    _length = 0;
+    for (uint8_t i = 0; i < sizeof(CAPTURE_MAGIC); i++) { _block[_length++] = CAPTURE_MAGIC[i]; }
+    _block[_length++] = CAPTURE_VERSION;
+    _block[_length++] = 0;
+    putWord(static_cast<uint16_t>(payloadEnd - CAPTURE_HEADER_SIZE));
+    putWord(_samples);
+    putLong(_sequence);
+    putLong(_baseTimestamp);
+
+    _length = payloadEnd;
+    putWord(crc16Ccitt(0xFFFF, _block + sizeof(CAPTURE_MAGIC), payloadEnd - sizeof(CAPTURE_MAGIC)));
+    size_t length = _length;
+
+    _sequence++;
+    startBlock();
+    return length;
+  }
+
+  /** \brief Gets the block sealed by the last flush().
+   *  \return Block bytes */
+  const uint8_t* data() const { return _block; }
+
+  /** \brief Gets the number of samples in the current (unsealed) block.
+   *  \return Sample count */
+  uint16_t pending() const { return _samples; }
+
+  /** \brief Gets the number of blocks sealed so far.
+   *  \return Block count, which is also the next block's sequence number */
+  uint32_t blocks() const { return _sequence; }
+
+  private:
+  struct Channel {
+    uint8_t address   = 0;
+    uint16_t config   = 0;
+    int16_t lastCount = 0;
+    bool described    = false;
+  };
+
+  void startBlock() {
+    _length  = CAPTURE_HEADER_SIZE;
+    _samples = 0;
+    for (uint8_t i = 0; i < _channelCount; i++) {
+      _channels[i].lastCount = 0;
+      _channels[i].described = false;
+    }
+  }
+
+  void putWord(uint16_t v) {
+    _block[_length++] = static_cast<uint8_t>(v);
+    _block[_length++] = static_cast<uint8_t>(v >> 8);
+  }
+
+  void putLong(uint32_t v) {
+    putWord(static_cast<uint16_t>(v));
+    putWord(static_cast<uint16_t>(v >> 16));
+  }
+
+  void putZigzag(int32_t v) {
+    uint32_t u = (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+    while (u >= 0x80) {
+      _block[_length++] = static_cast<uint8_t>(u | 0x80);
+      u >>= 7;
+    }
+    _block[_length++] = static_cast<uint8_t>(u);
+  }
+
+  uint8_t _block[BlockSize];
+  Channel _channels[CAPTURE_MAX_CHANNELS];
+  size_t _length          = CAPTURE_HEADER_SIZE;
+  uint16_t _samples       = 0;
+  uint8_t _channelCount   = 0;
+  uint32_t _sequence      = 0;
+  uint32_t _baseTimestamp = 0;
+  uint32_t _lastTimestamp = 0;
+};
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_CAPTURE_H
@@ -0,0 +1,195 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_CAPTURE_DECODER_H
+#define ADS1X15_CAPTURE_DECODER_H
+
+// Host-only: uses the C++ standard library. Not for use on microcontrollers.
+
+#include <deque>
+#include <vector>
+
+#include "ADS1X15Capture.h"
+
+namespace ADS1X15 {
+
+/** \brief One sample read back from a capture. */
+struct CapturedSample {
+  uint32_t timestamp; ///< Sample time as given to CaptureEncoder::add()
+  uint32_t block;     ///< Sequence number of the block it came from
+  uint8_t address;    ///< I2C address of the device
+  uint16_t config;    ///< CONFIG bits (MUX | PGA | DR)
+  int16_t count;      ///< Conversion result
+
+  /** \brief Gets the MUX bits.
+   *  \return MUX bits (ADS1X15_REG_CONFIG_MUX_*) */
+  uint16_t mux() const { return config & ADS1X15_REG_CONFIG_MUX_MASK; }
+
+  /** \brief Gets the gain.
+   *  \return Gain setting */
+  Gain gain() const { return static_cast<Gain>(config & ADS1X15_REG_CONFIG_PGA_MASK); }
+
+  /** \brief Gets the data rate.
+   *  \tparam Chip Chip traits the capture was made with
+   *  \return Rate setting */
+  template <typename Chip> ChipRate<Chip> rate() const {
+    return ChipRate<Chip>{static_cast<uint16_t>(config & ADS1X15_REG_CONFIG_RATE_MASK)};
+  }
+};
+
+/**
+ * \brief Streaming decoder for the CaptureEncoder block format.
+ *
+ * feed() accepts the capture in chunks of any size. Complete blocks are checked and decoded, and their samples are
+ * queued for next(). If a block is damaged (bad CRC, unknown version, impossible length or malformed payload), the
+ * decoder drops it and scans forward for the next magic, so one bad sector costs one block. Gaps in the block
+ * sequence numbers are counted as lost blocks.
+ */
+class CaptureDecoder {
+  public:
+  /** \brief Constructs a decoder.
+   *  \param maxBlockSize Largest block the encoder can produce (its BlockSize). A header claiming a longer block is
+   *                      treated as corrupt rather than waited for. */
+  explicit CaptureDecoder(size_t maxBlockSize = 4096) : _maxBlockSize(maxBlockSize) {}
+
+  /** \brief Adds capture bytes and decodes every complete block.
+   *  \param data Bytes
+   *  \param n Number of bytes */
+  void feed(const uint8_t* data, size_t n) {
+    _buffer.insert(_buffer.end(), data, data + n);
+    size_t pos = 0;
+    while (_buffer.size() - pos >= CAPTURE_HEADER_SIZE + CAPTURE_CRC_SIZE) {
+      if (!magicAt(pos)) {
+        pos++;
+        _skippedBytes++;
+        continue;
+      }
+      size_t total = CAPTURE_HEADER_SIZE + word(pos + 6) + CAPTURE_CRC_SIZE;
+      bool valid   = _buffer[pos + 4] == CAPTURE_VERSION && total <= _maxBlockSize;
+      if (valid && _buffer.size() - pos < total) { break; } // wait for the rest of the block
+      if (valid && decodeBlock(pos, total)) {
+        pos += total;
+      } else {
+        _corruptBlocks++;
+        pos++;
+        _skippedBytes++;
+      }
+    }
+    _buffer.erase(_buffer.begin(), _buffer.begin() + static_cast<std::ptrdiff_t>(pos));
+  }
+
+  /** \brief Takes the next decoded sample.
+   *  \param sample Receives the sample
+   *  \return false if no decoded sample is waiting */
+  bool next(CapturedSample& sample) {
+    if (_samples.empty()) { return false; }
+    sample = _samples.front();
+    _samples.pop_front();
+    return true;
+  }
+
+  /** \brief Gets the number of blocks decoded.
+   *  \return Good block count */
+  uint32_t blocks() const { return _blocks; }
+
+  /** \brief Gets the number of damaged blocks dropped.
+   *  \return Corrupt block count */
+  uint32_t corruptBlocks() const { return _corruptBlocks; }
+
+  /** \brief Gets the number of blocks missing from the sequence between good blocks.
+   *  \return Lost block count */
+  uint32_t lostBlocks() const { return _lostBlocks; }
+
+  /** \brief Gets the number of bytes skipped while searching for a block.
+   *  \return Skipped byte count */
+  uint32_t skippedBytes() const { return _skippedBytes; }
+
+  private:
+  struct Channel {
+    bool defined      = false;
+    uint8_t address   = 0;
+    uint16_t config   = 0;
+    int16_t lastCount = 0;
+  };
+
+  bool magicAt(size_t pos) const {
+    for (size_t i = 0; i < sizeof(CAPTURE_MAGIC); i++) {
+      if (_buffer[pos + i] != CAPTURE_MAGIC[i]) { return false; }
+    }
+    return true;
+  }
+
+  uint16_t word(size_t pos) const { return static_cast<uint16_t>(_buffer[pos] | (_buffer[pos + 1] << 8)); }
+
+  uint32_t longWord(size_t pos) const { return word(pos) | (static_cast<uint32_t>(word(pos + 2)) << 16); }
+
+  // Reads a zigzag varint at pos, which must stay below end. Returns false if it is truncated or too long.
+  bool zigzag(size_t& pos, size_t end, int32_t& value) const {
+    uint32_t u = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+      if (pos >= end) { return false; }
+      uint8_t byte = _buffer[pos++];
+      u |= static_cast<uint32_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        value = static_cast<int32_t>((u >> 1) ^ (0u - (u & 1)));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool decodeBlock(size_t start, size_t total) {
+    size_t payloadEnd = start + total - CAPTURE_CRC_SIZE;
+    uint16_t crc      = crc16Ccitt(0xFFFF, &_buffer[start + sizeof(CAPTURE_MAGIC)], payloadEnd - start - 4);
+    if (crc != word(payloadEnd)) { return false; }
+
+    uint16_t count     = word(start + 8);
+    uint32_t sequence  = longWord(start + 10);
+    uint32_t timestamp = longWord(start + 14);
+
+    std::vector<CapturedSample> decoded;
+    decoded.reserve(count);
+    Channel channels[CAPTURE_MAX_CHANNELS];
+    size_t pos = start + CAPTURE_HEADER_SIZE;
+    for (uint16_t i = 0; i < count; i++) {
+      if (pos >= payloadEnd) { return false; }
+      uint8_t tag      = _buffer[pos++];
+      Channel& channel = channels[tag & CAPTURE_TAG_CHANNEL_MASK];
+      if ((tag & CAPTURE_TAG_DESCRIPTOR) != 0) {
+        if (payloadEnd - pos < 3) { return false; }
+        channel.defined = true;
+        channel.address = _buffer[pos];
+        channel.config  = word(pos + 1);
+        pos += 3;
+      }
+      int32_t dt, dcount;
+      if (!channel.defined || !zigzag(pos, payloadEnd, dt) || !zigzag(pos, payloadEnd, dcount)) { return false; }
+      timestamp += static_cast<uint32_t>(dt);
+      channel.lastCount = static_cast<int16_t>(channel.lastCount + dcount);
+      decoded.push_back(CapturedSample{timestamp, sequence, channel.address, channel.config, channel.lastCount});
+    }
+    if (pos != payloadEnd) { return false; }
+
+    if (_blocks > 0 && sequence - _nextSequence < 0x80000000u) { _lostBlocks += sequence - _nextSequence; }
+    _nextSequence = sequence + 1;
+    _blocks++;
+    _samples.insert(_samples.end(), decoded.begin(), decoded.end());
+    return true;
+  }
+
+  size_t _maxBlockSize;
+  std::vector<uint8_t> _buffer;
+  std::deque<CapturedSample> _samples;
+  uint32_t _blocks        = 0;
+  uint32_t _corruptBlocks = 0;
+  uint32_t _lostBlocks    = 0;
+  uint32_t _skippedBytes  = 0;
+  uint32_t _nextSequence  = 0;
+};
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_CAPTURE_DECODER_H
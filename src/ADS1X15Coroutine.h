@@ -0,0 +1,437 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_COROUTINE_H
+#define ADS1X15_COROUTINE_H
+
+// Needs C++20 coroutines (-std=c++20 or later). Nothing is allocated per read.
+
+#if !defined(__cpp_impl_coroutine)
+#error "ADS1X15Coroutine.h needs a compiler with C++20 coroutine support (-std=c++20)"
+#endif
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+
+#include "ADS1X15.h"
+
+namespace ADS1X15 {
+
+class ConversionScheduler;
+
+namespace detail {
+
+class AsyncChannel;
+
+/** \brief Awaitable for one conversion, returned by the AsyncAdc read functions. Yields a ReadResult. */
+class ReadAwaiter {
+  public:
+  ReadAwaiter(AsyncChannel& channel, uint16_t config) : mChannel(channel), _config(config) {}
+
+  bool await_ready() const noexcept { return false; }
+  bool await_suspend(std::coroutine_handle<> handle);
+  ReadResult await_resume() const noexcept { return _result; }
+
+  private:
+  friend class AsyncChannel;
+
+  AsyncChannel& mChannel;
+  uint16_t _config;
+  ReadResult _result{Status::OK, 0};
+  std::coroutine_handle<> _handle;
+  ReadAwaiter* _next = nullptr; ///< Next read queued on the same chip
+};
+
+/**
+ * \brief Per-chip queue of suspended reads. The awaiters live in the waiting coroutines' frames and are linked
+ * through their own _next pointers, so queueing a read allocates nothing.
+ */
+class AsyncChannel {
+  public:
+  AsyncChannel(const AsyncChannel&)            = delete;
+  AsyncChannel& operator=(const AsyncChannel&) = delete;
+
+  /** \brief Marks the current conversion as finished, e.g. from the ALERT/RDY interrupt. The next
+   *  ConversionScheduler::poll() then reads the result without checking the OS bit first. */
+  void notifyReady() {
+    if (_converting) { _ready = true; }
+  }
+
+  /** \brief Gets the number of reads queued on this chip, including the one converting.
+   *  \return Read count */
+  size_t pending() const { return _pending; }
+
+  protected:
+  explicit AsyncChannel(ConversionScheduler& scheduler);
+  ~AsyncChannel();
+
+  virtual Status start(uint16_t config)           = 0;
+  virtual Status checkComplete(bool& done)        = 0;
+  virtual ReadResult read()                       = 0;
+  virtual uint32_t minimumMicros(uint16_t config) = 0;
+
+  private:
+  friend class ::ADS1X15::ConversionScheduler;
+  friend class ReadAwaiter;
+
+  // Queues a read. Returns false (do not suspend) if its conversion could not be started.
+  bool enqueue(ReadAwaiter& awaiter) {
+    awaiter._next = nullptr;
+    if (_tail != nullptr) {
+      _tail->_next = &awaiter;
+      _tail        = &awaiter;
+      _pending++;
+      return true;
+    }
+    _head = _tail = &awaiter;
+    _pending      = 1;
+    if (startHead(now())) { return true; }
+    pop();
+    return false;
+  }
+
+  // Services the read at the head of the queue. Returns true if a coroutine was resumed.
+  bool service(uint32_t time) {
+    if (_head == nullptr) { return false; }
+    if (!_converting) {
+      if (startHead(time)) { return false; }
+      return finish(ReadResult{_startStatus, 0}, time);
+    }
+    bool done = _ready;
+    if (!done) {
+      if (static_cast<int32_t>(time - _checkAt) < 0) { return false; }
+      Status status = checkComplete(done);
+      if (status != Status::OK) { return finish(ReadResult{status, 0}, time); }
+      if (!done) {
+        _checkAt = time + _retryMicros;
+        return false;
+      }
+    }
+    return finish(read(), time);
+  }
+
+  bool startHead(uint32_t time) {
+    _ready       = false;
+    _startStatus = start(_head->_config);
+    _converting  = _startStatus == Status::OK;
+    uint32_t min = minimumMicros(_head->_config);
+    _checkAt     = time + min;
+    _retryMicros = min / 16 > MIN_RETRY_US ? min / 16 : MIN_RETRY_US;
+    return _converting;
+  }
+
+  // Completes the head read, starts the next one so it converts while the coroutine runs, then resumes it.
+  bool finish(ReadResult result, uint32_t time) {
+    ReadAwaiter* done = pop();
+    done->_result     = result;
+    if (_head != nullptr) { startHead(time); }
+    done->_handle.resume();
+    return true;
+  }
+
+  ReadAwaiter* pop() {
+    ReadAwaiter* head = _head;
+    _head             = head->_next;
+    if (_head == nullptr) { _tail = nullptr; }
+    _pending--;
+    _converting = false;
+    return head;
+  }
+
+  uint32_t now() const;
+
+  static constexpr uint32_t MIN_RETRY_US = 20; ///< Shortest gap between OS-bit checks
+
+  ConversionScheduler& mScheduler;
+  AsyncChannel* _nextChannel = nullptr;
+  ReadAwaiter* _head         = nullptr;
+  ReadAwaiter* _tail         = nullptr;
+  size_t _pending            = 0;
+  bool _converting           = false;
+  volatile bool _ready       = false;
+  Status _startStatus        = Status::OK;
+  uint32_t _checkAt          = 0;
+  uint32_t _retryMicros      = MIN_RETRY_US;
+};
+
+inline bool ReadAwaiter::await_suspend(std::coroutine_handle<> handle) {
+  _handle = handle;
+  if (mChannel.enqueue(*this)) { return true; }
+  _result = ReadResult{mChannel._startStatus, 0};
+  return false;
+}
+
+} // namespace detail
+
+/**
+ * \brief Runs the conversions awaited through AsyncAdc objects and resumes their coroutines.
+ *
+ * Call poll() from the scheduler loop of the thread or task the coroutines run on. Each call visits every chip
+ * once: a chip is only polled after the minimum conversion time of its current read has passed (or straight away
+ * after notifyReady()), and a finished chip starts its next queued read before the waiting coroutine is resumed.
+ * The cost of a poll() grows with the number of chips, not with the number of waiting reads.
+ */
+class ConversionScheduler {
+  public:
+  /** \brief Constructs a scheduler.
+   *  \param clock Microsecond clock (e.g. micros()) */
+  explicit ConversionScheduler(ClockFunction clock) : _clock(clock) {}
+
+  ConversionScheduler(const ConversionScheduler&)            = delete;
+  ConversionScheduler& operator=(const ConversionScheduler&) = delete;
+
+  /** \brief Services every chip once.
+   *  \return Number of coroutines resumed */
+  size_t poll() {
+    size_t resumed = 0;
+    uint32_t now   = _clock();
+    for (detail::AsyncChannel* c = _channels; c != nullptr; c = c->_nextChannel) {
+      if (c->service(now)) { resumed++; }
+    }
+    return resumed;
+  }
+
+  /** \brief Gets the number of reads waiting on all chips.
+   *  \return Read count */
+  size_t pending() const {
+    size_t total = 0;
+    for (const detail::AsyncChannel* c = _channels; c != nullptr; c = c->_nextChannel) { total += c->pending(); }
+    return total;
+  }
+
+  private:
+  friend class detail::AsyncChannel;
+
+  ClockFunction _clock;
+  detail::AsyncChannel* _channels = nullptr;
+};
+
+namespace detail {
+
+inline AsyncChannel::AsyncChannel(ConversionScheduler& scheduler) : mScheduler(scheduler) {
+  _nextChannel        = scheduler._channels;
+  scheduler._channels = this;
+}
+
+inline AsyncChannel::~AsyncChannel() {
+  for (AsyncChannel** c = &mScheduler._channels; *c != nullptr; c = &(*c)->_nextChannel) {
+    if (*c == this) {
+      *c = _nextChannel;
+      break;
+    }
+  }
+}
+
+inline uint32_t AsyncChannel::now() const { return mScheduler._clock(); }
+
+} // namespace detail
+
+/**
+ * \brief Awaitable conversions on one chip, for C++20 coroutines.
+ *
+ * \code
+ * int16_t v = (co_await adc.readSingleEnded(0)).value;
+ * \endcode
+ *
+ * The awaiting coroutine is suspended until the conversion is done, so one thread can wait on any number of reads.
+ * Reads on the same chip are queued and run one after another; reads on different chips run at the same time.
+ * Nothing is allocated per read. Must not be destroyed while reads are queued.
+ *
+ * \tparam ADC Driver type (e.g. ADS1115<TwoWire>)
+ */
+template <typename ADC> class AsyncAdc : public detail::AsyncChannel {
+  public:
+  /** \brief Constructs an awaitable view of a driver.
+   *  \param ads Driver, already initialised with begin(); only use it through this object while reads are queued
+   *  \param scheduler Scheduler that runs the conversions */
+  AsyncAdc(ADC& ads, ConversionScheduler& scheduler) : AsyncChannel(scheduler), mAds(ads) {}
+
+  /** \brief Reads a single-ended channel at the driver's gain and data rate.
+   *  \param channel ADC channel (0-3)
+   *  \return Awaitable yielding a ReadResult */
+  detail::ReadAwaiter readSingleEnded(uint8_t channel) {
+    return read(ScanEntry::singleEnded(channel, mAds.getGain(), mAds.getDataRate()));
+  }
+
+  /** \brief Reads a differential pair at the driver's gain and data rate.
+   *  \param pair Differential input pair
+   *  \return Awaitable yielding a ReadResult */
+  detail::ReadAwaiter readDifferential(DifferentialPair pair) {
+    return read(ScanEntry::differential(pair, mAds.getGain(), mAds.getDataRate()));
+  }
+
+  /** \brief Reads a scan entry (input, gain and rate). The entry is converted in single-shot mode.
+   *  \param entry Conversion request
+   *  \return Awaitable yielding a ReadResult */
+  detail::ReadAwaiter read(const ScanEntry& entry) {
+    return detail::ReadAwaiter(*this, static_cast<uint16_t>(entry.config | ADS1X15_REG_CONFIG_MODE_SINGLE));
+  }
+
+  /** \brief Gets the driver.
+   *  \return Driver */
+  ADC& adc() { return mAds; }
+
+  protected:
+  Status start(uint16_t config) override { return mAds.startReading(ScanEntry{config}); }
+
+  Status checkComplete(bool& done) override { return mAds.tryConversionComplete(done); }
+
+  ReadResult read() override { return mAds.tryGetLastConversionResults(); }
+
+  uint32_t minimumMicros(uint16_t config) override {
+    return conversionTimeMinMicros(ScanEntry{config}.template rate<typename ADC::Traits>());
+  }
+
+  private:
+  ADC& mAds;
+};
+
+/** \brief Frame allocation policy for BasicConversionTask that uses the heap (nothrow operator new). */
+struct HeapFrames {
+  /** \brief Allocates a frame.
+   *  \param size Bytes needed
+   *  \return Memory, or nullptr if none is left */
+  static void* allocate(size_t size) noexcept { return ::operator new(size, std::nothrow); }
+
+  /** \brief Releases a frame.
+   *  \param frame Memory from allocate()
+   *  \param size Size passed to allocate() */
+  static void deallocate(void* frame, size_t size) noexcept { ::operator delete(frame, size); }
+};
+
+/**
+ * \brief Frame allocation policy for BasicConversionTask that uses a fixed pool of equal-sized blocks.
+ *
+ * The pool is static storage shared by every task type using the same template arguments; use a different Tag for a
+ * separate pool. Allocation and release are O(1) and never touch the heap. Not thread-safe: create and destroy the
+ * tasks from one thread, normally the one running ConversionScheduler::poll().
+ *
+ * \tparam BlockSize Bytes per block; must hold the largest coroutine frame
+ * \tparam Blocks Number of blocks
+ * \tparam Tag Any type, to tell pools of the same size apart
+ */
+template <size_t BlockSize, size_t Blocks, typename Tag = void> class FramePool {
+  static_assert(BlockSize >= sizeof(void*), "Block too small");
+
+  public:
+  /** \brief Allocates a frame.
+   *  \param size Bytes needed
+   *  \return Memory, or nullptr if the frame is too big or every block is in use */
+  static void* allocate(size_t size) noexcept {
+    if (size > BlockSize) { return nullptr; }
+    void* frame = nullptr;
+    if (_free != nullptr) {
+      frame = _free;
+      _free = *static_cast<void**>(frame);
+    } else if (_fresh < Blocks) {
+      frame = _storage + _fresh++ * STRIDE;
+    } else {
+      return nullptr;
+    }
+    _used++;
+    return frame;
+  }
+
+  /** \brief Releases a frame.
+   *  \param frame Memory from allocate()
+   *  \param size Size passed to allocate() */
+  static void deallocate(void* frame, size_t size) noexcept {
+    (void)size;
+    *static_cast<void**>(frame) = _free;
+    _free                       = frame;
+    _used--;
+  }
+
+  /** \brief Gets the number of blocks in use.
+   *  \return Block count */
+  static size_t used() { return _used; }
+
+  private:
+  static constexpr size_t ALIGN  = alignof(std::max_align_t);
+  static constexpr size_t STRIDE = (BlockSize + ALIGN - 1) / ALIGN * ALIGN;
+
+  alignas(std::max_align_t) static inline unsigned char _storage[STRIDE * Blocks];
+  static inline void* _free   = nullptr; ///< Released blocks, linked through their first bytes
+  static inline size_t _fresh = 0;       ///< Blocks never handed out start here
+  static inline size_t _used  = 0;
+};
+
+/**
+ * \brief Minimal eagerly started coroutine type for code that awaits AsyncAdc reads.
+ *
+ * A function returning a task runs until its first co_await and then continues from ConversionScheduler::poll().
+ * The task object owns the frame: keep it until done().
+ *
+ * Frames come from the Frames policy: HeapFrames (ConversionTask), or a FramePool to keep the heap out of it. If no
+ * frame can be allocated the function does not run and valid() is false.
+ *
+ * \code
+ * using PooledTask = BasicConversionTask<FramePool<256, 64>>;
+ * PooledTask sampler(AsyncAdc<ADS1115<TwoWire>>& adc, int16_t& out) {
+ *   out = (co_await adc.readSingleEnded(0)).value;
+ * }
+ * \endcode
+ *
+ * \tparam Frames Frame allocation policy with static allocate(size) and deallocate(frame, size)
+ */
+template <typename Frames = HeapFrames> class BasicConversionTask {
+  public:
+  /** \brief Coroutine promise type. */
+  struct promise_type {
+    BasicConversionTask get_return_object() noexcept {
+      return BasicConversionTask(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    static BasicConversionTask get_return_object_on_allocation_failure() noexcept { return BasicConversionTask(); }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+
+    static void* operator new(size_t size) noexcept { return Frames::allocate(size); }
+    static void operator delete(void* frame, size_t size) noexcept { Frames::deallocate(frame, size); }
+  };
+
+  BasicConversionTask() = default;
+  BasicConversionTask(BasicConversionTask&& other) noexcept : _handle(other._handle) { other._handle = nullptr; }
+  BasicConversionTask& operator=(BasicConversionTask&& other) noexcept {
+    if (this != &other) {
+      destroy();
+      _handle       = other._handle;
+      other._handle = nullptr;
+    }
+    return *this;
+  }
+  BasicConversionTask(const BasicConversionTask&)            = delete;
+  BasicConversionTask& operator=(const BasicConversionTask&) = delete;
+  ~BasicConversionTask() { destroy(); }
+
+  /** \brief Checks whether the task was started (its frame could be allocated).
+   *  \return true if started */
+  bool valid() const { return static_cast<bool>(_handle); }
+
+  /** \brief Checks whether the task has run to completion.
+   *  \return true if finished (or never started) */
+  bool done() const { return !_handle || _handle.done(); }
+
+  private:
+  explicit BasicConversionTask(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+  void destroy() {
+    if (_handle) { _handle.destroy(); }
+    _handle = nullptr;
+  }
+
+  std::coroutine_handle<promise_type> _handle;
+};
+
+/** \brief Coroutine task whose frames come from the heap. */
+using ConversionTask = BasicConversionTask<>;
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_COROUTINE_H
@@ -0,0 +1,155 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_DEVICE_GROUP_H
+#define ADS1X15_DEVICE_GROUP_H
+
+#include "ADS1X15.h"
+
+namespace ADS1X15 {
+
+/**
+ * \brief Samples several ADS1X15 chips on one bus with overlapping conversions.
+ *
+ * start() issues the CONFIG write to every device back-to-back, so all conversions run at the same time instead of
+ * one after another. poll() then collects results in whichever order the devices finish. With four chips
+ * (0x48-0x4B) a frame takes roughly one conversion time plus bus overhead, rather than four conversion times.
+ *
+ * If a clock is set, start and completion times are recorded, so the skew between the devices' sampling instants
+ * can be reported for each frame.
+ *
+ * \tparam ADC Driver type (e.g. ADS1115<TwoWire>)
+ * \tparam N Number of devices
+ */
+template <typename ADC, size_t N> class DeviceGroup {
+  static_assert(N > 0, "Device group must not be empty");
+
+  public:
+  /** \brief Constructs a group from already initialised devices (begin() called with their addresses).
+   *  \param devices Pointers to the devices; copied, so the array itself need not outlive the group */
+  explicit DeviceGroup(ADC* const (&devices)[N]) {
+    for (size_t i = 0; i < N; i++) { mDevices[i] = devices[i]; }
+  }
+
+  /** \brief Sets the clock used to timestamp starts and completions.
+   *  \param clockFn Microsecond clock, or nullptr to disable timing */
+  void setClockFunction(ClockFunction clockFn) { _clockFn = clockFn; }
+
+  /** \brief Starts the same conversion on every device.
+   *
+   *  A device whose start fails finishes at once with that error.
+   *  \param entry Input, gain and rate to convert */
+  void start(const ScanEntry& entry) {
+    beginFrame();
+    for (size_t i = 0; i < N; i++) { startDevice(i, entry); }
+  }
+
+  /** \brief Starts a conversion on every device, each with its own entry.
+   *  \param entries One entry per device */
+  void start(const ScanEntry (&entries)[N]) {
+    beginFrame();
+    for (size_t i = 0; i < N; i++) { startDevice(i, entries[i]); }
+  }
+
+  /** \brief Collects finished conversions without blocking.
+   *
+   *  Checks each outstanding device once, reading the results of those that have finished.
+   *  \return true if this call completed the frame (every device has finished or failed) */
+  bool poll() {
+    if (_completed == N) { return false; }
+    for (size_t i = 0; i < N; i++) {
+      if (_done[i]) { continue; }
+      bool complete = false;
+      Status status = mDevices[i]->tryConversionComplete(complete);
+      if (status == Status::OK && !complete) { continue; }
+      if (status == Status::OK) {
+        ReadResult r = mDevices[i]->tryGetLastConversionResults();
+        status       = r.status;
+        _results[i]  = r.value;
+      }
+      finishDevice(i, status);
+    }
+    return _completed == N;
+  }
+
+  /** \brief Checks whether the current frame is complete.
+   *  \return true if every device has finished since the last start(), or no frame was started */
+  bool complete() const { return _completed == N; }
+
+  /** \brief Gets a device's result from the current frame.
+   *  \param device Device index (0 to N-1)
+   *  \return Conversion result (0 if the device failed) */
+  int16_t result(size_t device) const { return device < N ? _results[device] : 0; }
+
+  /** \brief Gets the outcome of a device's conversion in the current frame.
+   *  \param device Device index (0 to N-1)
+   *  \return Status::OK, or the bus error that occurred */
+  Status status(size_t device) const { return device < N ? _status[device] : Status::INVALID_ARGUMENT; }
+
+  /** \brief Gets the order in which devices finished.
+   *  \param position Completion position (0 = first to finish)
+   *  \return Device index that finished at that position */
+  uint8_t completionOrder(size_t position) const { return position < N ? _order[position] : 0; }
+
+  /** \brief Gets the spread of conversion start times across the devices, i.e. the skew between their sampling
+   *  instants. Requires a clock.
+   *  \return Microseconds between the first and last start */
+  uint32_t startSkewMicros() const { return _startTime[N - 1] - _startTime[0]; }
+
+  /** \brief Gets the time from the first start to a device's result being read. Requires a clock.
+   *  \param device Device index (0 to N-1)
+   *  \return Microseconds */
+  uint32_t completionMicros(size_t device) const { return device < N ? _doneTime[device] - _startTime[0] : 0; }
+
+  /** \brief Gets the spread of result read times across the devices. Requires a clock.
+   *  \return Microseconds between the first and last device being read */
+  uint32_t completionSkewMicros() const {
+    return _completed == 0 ? 0 : _doneTime[_order[_completed - 1]] - _doneTime[_order[0]];
+  }
+
+  /** \brief Gets the number of devices.
+   *  \return N */
+  static constexpr size_t size() { return N; }
+
+  private:
+  uint32_t now() const { return _clockFn != nullptr ? _clockFn() : 0; }
+
+  void beginFrame() {
+    _completed = 0;
+    for (size_t i = 0; i < N; i++) {
+      _done[i]    = false;
+      _results[i] = 0;
+    }
+  }
+
+  void startDevice(size_t i, const ScanEntry& entry) {
+    _startTime[i] = now();
+    // A device that failed to start is not polled, so a stale result can't pass as this frame's.
+    Status status = mDevices[i]->startReading(entry);
+    if (status != Status::OK) { finishDevice(i, status); }
+  }
+
+  void finishDevice(size_t i, Status status) {
+    _status[i]           = status;
+    _doneTime[i]         = now();
+    _done[i]             = true;
+    _order[_completed++] = static_cast<uint8_t>(i);
+  }
+
+  ADC* mDevices[N];
+  ClockFunction _clockFn = nullptr;
+  int16_t _results[N]    = {};
+  Status _status[N]      = {};
+  uint8_t _order[N]      = {};
+  uint32_t _startTime[N] = {};
+  uint32_t _doneTime[N]  = {};
+  bool _done[N]          = {};
+  size_t _completed      = N;
+};
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_DEVICE_GROUP_H
@@ -0,0 +1,282 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_FILTER_H
+#define ADS1X15_FILTER_H
+
+#include "ADS1X15.h"
+
+namespace ADS1X15 {
+
+/*
+ * Filter stages for streams of conversion results, e.g. from continuous mode or a StreamReader.
+ *
+ * Every stage has the same interface:
+ *   bool push(int32_t in, int32_t& out)  feeds one sample; returns true when it has produced an output
+ *   int32_t gain() const                 outputs are in input units times gain(), so no precision is dropped
+ *   void reset()                         forgets all history
+ *
+ * Stages hold no heap memory, and each push() costs a fixed amount of work. They can be chained with FilterChain.
+ */
+
+constexpr uint8_t MAINS_50HZ        = 50; ///< Mains frequency for BoxcarDecimator::forMains()
+constexpr uint8_t MAINS_60HZ        = 60; ///< Mains frequency for BoxcarDecimator::forMains()
+constexpr uint8_t MAINS_50_AND_60HZ = 10; ///< 100 ms window: whole cycles of both 50 Hz and 60 Hz
+
+namespace detail {
+
+// ceil(log2(v)) for v >= 1.
+constexpr uint8_t ceilLog2(uint32_t v) { return v <= 1 ? 0 : static_cast<uint8_t>(1 + ceilLog2((v + 1) / 2)); }
+
+constexpr uint32_t power(uint32_t base, uint8_t exponent) {
+  return exponent == 0 ? 1 : base * power(base, static_cast<uint8_t>(exponent - 1));
+}
+
+} // namespace detail
+
+/**
+ * \brief Moving average (sliding boxcar): one output per input once N samples have been seen.
+ *
+ * Keeps a running sum, so each sample costs one add and one subtract whatever N is. The sum of N inputs must fit in
+ * 32 bits, which raw counts always do.
+ *
+ * \tparam N Window length in samples
+ * \tparam T History element type: int16_t for raw counts, int32_t when fed from another stage
+ */
+template <uint16_t N, typename T = int16_t> class MovingAverage {
+  static_assert(N > 0, "Window must not be empty");
+
+  public:
+  /** \brief Feeds one sample.
+   *  \param in Input sample
+   *  \param out Receives the sum of the last N samples
+   *  \return true once the window is full */
+  bool push(int32_t in, int32_t& out) {
+    _sum += in - _history[_next];
+    _history[_next] = static_cast<T>(in);
+    if (++_next == N) {
+      _next   = 0;
+      _primed = true;
+    }
+    if (!_primed) { return false; }
+    out = _sum;
+    return true;
+  }
+
+  /** \brief Gets the factor between output and input units.
+   *  \return N */
+  static constexpr int32_t gain() { return N; }
+
+  /** \brief Forgets all history. */
+  void reset() {
+    for (uint16_t i = 0; i < N; i++) { _history[i] = 0; }
+    _sum    = 0;
+    _next   = 0;
+    _primed = false;
+  }
+
+  private:
+  T _history[N]  = {};
+  int32_t _sum   = 0;
+  uint16_t _next = 0;
+  bool _primed   = false;
+};
+
+/**
+ * \brief Boxcar decimator: sums blocks of length() samples and outputs one sum per block.
+ *
+ * Averaging over a whole number of mains cycles puts nulls at the mains frequency and its harmonics; forMains()
+ * picks the block length for a data rate.
+ */
+class BoxcarDecimator {
+  public:
+  /** \brief Constructs a decimator.
+   *  \param length Samples per output (at least 1) */
+  explicit BoxcarDecimator(uint16_t length) : _length(length != 0 ? length : 1) {}
+
+  /** \brief Constructs a decimator whose block spans whole mains cycles at a data rate.
+   *
+   *  The block length is the window (cycles / mainsHz seconds) divided by the nominal conversion period, rounded to
+   *  the nearest sample. Rejection is best when that division is exact, e.g. 250 SPS with MAINS_50_AND_60HZ, or
+   *  ADS1015 1600 SPS with MAINS_50HZ. The chip's oscillator tolerance shifts the nulls by the same fraction.
+   *  \param rate Data rate the samples are taken at
+   *  \param mainsHz Mains frequency (MAINS_50HZ, MAINS_60HZ or MAINS_50_AND_60HZ)
+   *  \param cycles Number of mains cycles per block
+   *  \return Decimator */
+  template <typename Chip> static BoxcarDecimator forMains(ChipRate<Chip> rate, uint8_t mainsHz, uint8_t cycles = 1) {
+    return BoxcarDecimator(mainsLength(conversionPeriodMicros(rate), mainsHz, cycles));
+  }
+
+  /** \brief Feeds one sample.
+   *  \param in Input sample
+   *  \param out Receives the sum of the block
+   *  \return true at the end of each block */
+  bool push(int32_t in, int32_t& out) {
+    _sum += in;
+    if (++_count < _length) { return false; }
+    out    = _sum;
+    _sum   = 0;
+    _count = 0;
+    return true;
+  }
+
+  /** \brief Gets the factor between output and input units.
+   *  \return Block length */
+  int32_t gain() const { return _length; }
+
+  /** \brief Gets the number of samples per output.
+   *  \return Block length */
+  uint16_t length() const { return _length; }
+
+  /** \brief Forgets the partial block. */
+  void reset() {
+    _sum   = 0;
+    _count = 0;
+  }
+
+  private:
+  static uint16_t mainsLength(uint32_t periodMicros, uint8_t mainsHz, uint8_t cycles) {
+    if (mainsHz == 0 || cycles == 0) { return 1; }
+    uint32_t windowMicros = static_cast<uint32_t>(cycles) * 1000000UL / mainsHz;
+    uint32_t length       = (windowMicros + periodMicros / 2) / periodMicros;
+    if (length == 0) { return 1; }
+    if (length > 0xFFFF) { return 0xFFFF; }
+    return static_cast<uint16_t>(length);
+  }
+
+  uint16_t _length;
+  uint16_t _count = 0;
+  int32_t _sum    = 0;
+};
+
+/**
+ * \brief Cascaded integrator-comb (CIC) decimator.
+ *
+ * Equivalent to M boxcars of length R in series followed by decimation by R, but costs M additions per input and M
+ * subtractions per output. The first M - 1 outputs are suppressed while the combs fill.
+ *
+ * The integrators use wrapping unsigned arithmetic, which is exact as long as the output fits: InputBits +
+ * M * ceil(log2(R)) must not exceed 32.
+ *
+ * \tparam R Decimation ratio
+ * \tparam M Order (number of integrator/comb pairs)
+ * \tparam InputBits Significant bits of the input, including sign (16 for raw counts)
+ */
+template <uint16_t R, uint8_t M = 3, uint8_t InputBits = 16> class CicDecimator {
+  static_assert(R >= 2, "Decimation ratio must be at least 2");
+  static_assert(M >= 1, "Order must be at least 1");
+  static_assert(InputBits + M * detail::ceilLog2(R) <= 32, "Output would overflow 32 bits");
+
+  public:
+  /** \brief Feeds one sample.
+   *  \param in Input sample
+   *  \param out Receives the filtered output
+   *  \return true on every R-th input once the combs are full */
+  bool push(int32_t in, int32_t& out) {
+    uint32_t acc = static_cast<uint32_t>(in);
+    for (uint8_t i = 0; i < M; i++) {
+      _integrators[i] += acc;
+      acc = _integrators[i];
+    }
+    if (++_phase < R) { return false; }
+    _phase = 0;
+
+    for (uint8_t i = 0; i < M; i++) {
+      uint32_t delayed = _combs[i];
+      _combs[i]        = acc;
+      acc -= delayed;
+    }
+    if (_warmup + 1 < M) {
+      _warmup++;
+      return false;
+    }
+    out = static_cast<int32_t>(acc);
+    return true;
+  }
+
+  /** \brief Gets the factor between output and input units.
+   *  \return R to the power M */
+  static constexpr int32_t gain() { return static_cast<int32_t>(detail::power(R, M)); }
+
+  /** \brief Forgets all history. */
+  void reset() {
+    for (uint8_t i = 0; i < M; i++) {
+      _integrators[i] = 0;
+      _combs[i]       = 0;
+    }
+    _phase  = 0;
+    _warmup = 0;
+  }
+
+  private:
+  uint32_t _integrators[M] = {};
+  uint32_t _combs[M]       = {};
+  uint16_t _phase          = 0;
+  uint8_t _warmup          = 0;
+};
+
+/**
+ * \brief Two stages in series: the output of the first feeds the second.
+ *
+ * Chains nest, e.g. FilterChain<FilterChain<A, B>, C>. The combined gain is the product of the stage gains, so make
+ * sure the later stages have room for it (CicDecimator's InputBits, MovingAverage's T).
+ *
+ * \tparam First First stage
+ * \tparam Second Second stage
+ */
+template <typename First, typename Second> class FilterChain {
+  public:
+  /** \brief Constructs a chain.
+   *  \param first First stage
+   *  \param second Second stage */
+  explicit FilterChain(const First& first = First(), const Second& second = Second())
+      : _first(first), _second(second) {}
+
+  /** \brief Feeds one sample.
+   *  \param in Input sample
+   *  \param out Receives the output of the second stage
+   *  \return true when the second stage produced an output */
+  bool push(int32_t in, int32_t& out) {
+    int32_t middle;
+    if (!_first.push(in, middle)) { return false; }
+    return _second.push(middle, out);
+  }
+
+  /** \brief Gets the factor between output and input units.
+   *  \return Product of the stage gains */
+  int32_t gain() const { return _first.gain() * _second.gain(); }
+
+  /** \brief Forgets all history in both stages. */
+  void reset() {
+    _first.reset();
+    _second.reset();
+  }
+
+  /** \brief Gets the first stage.
+   *  \return First stage */
+  First& first() { return _first; }
+
+  /** \brief Gets the second stage.
+   *  \return Second stage */
+  Second& second() { return _second; }
+
+  private:
+  First _first;
+  Second _second;
+};
+
+/** \brief Converts a filter output to volts at the ADC's current gain.
+ *  \param ads ADC the samples came from
+ *  \param stage Stage (or chain) that produced the output
+ *  \param value Filter output
+ *  \return Voltage in volts, with the extra precision of the filter kept */
+template <typename ADC, typename Stage> float filteredVolts(const ADC& ads, const Stage& stage, int32_t value) {
+  return ads.computeVolts(1) * (static_cast<float>(value) / static_cast<float>(stage.gain()));
+}
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_FILTER_H
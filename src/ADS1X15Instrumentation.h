@@ -0,0 +1,126 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_INSTRUMENTATION_H
+#define ADS1X15_INSTRUMENTATION_H
+
+#include "ADS1X15.h"
+
+namespace ADS1X15 {
+
+constexpr uint8_t POLL_HISTOGRAM_BUCKETS    = 8;  ///< Buckets in InstrumentationCounters::pollsPerConversion
+constexpr uint8_t LATENCY_HISTOGRAM_BUCKETS = 20; ///< Buckets in InstrumentationCounters::latencyMicros
+
+/**
+ * \brief Counters recorded by CountingInstrumentation.
+ *
+ * The histograms use power-of-two buckets: bucket i counts values v with 2^(i-1) <= v < 2^i (bucket 0 is v = 0),
+ * and the last bucket also takes everything larger.
+ */
+struct InstrumentationCounters {
+  uint32_t registerWrites       = 0; ///< Register write transactions
+  uint32_t registerReads        = 0; ///< Register reads
+  uint32_t pointerWrites        = 0; ///< Pointer-only writes made before a read
+  uint32_t bytesWritten         = 0; ///< Bytes written, excluding address bytes
+  uint32_t bytesRead            = 0; ///< Bytes requested, excluding address bytes
+  uint32_t busErrors            = 0; ///< Transactions that did not return Status::OK
+  uint32_t conversionsStarted   = 0; ///< CONFIG writes that started a conversion
+  uint32_t conversionsCompleted = 0; ///< Conversions seen complete by a poll
+  uint32_t polls                = 0; ///< Successful OS-bit checks
+
+  uint32_t pollsPerConversion[POLL_HISTOGRAM_BUCKETS] = {}; ///< OS-bit checks needed per conversion
+  uint32_t latencyMicros[LATENCY_HISTOGRAM_BUCKETS]   = {}; ///< Start to observed completion (all 0 without a clock)
+};
+
+/**
+ * \brief Instrumentation policy that counts bus traffic and polling cost.
+ *
+ * Use it as the Instrumentation parameter of a driver, e.g. ADS1115<TwoWire, CountingInstrumentation>, then read
+ * the counters with ads.instrumentation().snapshot(). Conversion latencies are measured with the driver's clock
+ * (setClockFunction()); without one they all fall in bucket 0.
+ *
+ * The counters are plain integers: take snapshots from the same context that uses the driver.
+ */
+class CountingInstrumentation {
+  public:
+  /** \brief Asks the driver for timestamps.
+   *  \return true */
+  static constexpr bool enabled() { return true; }
+
+  /** \brief Records a register write.
+   *  \param bytes Bytes written after the address byte
+   *  \param status Outcome of the write */
+  void onRegisterWrite(uint8_t bytes, Status status) {
+    _counters.registerWrites++;
+    _counters.bytesWritten += bytes;
+    if (status != Status::OK) { _counters.busErrors++; }
+  }
+
+  /** \brief Records a register read.
+   *  \param bytesWritten Pointer bytes written (0 if the pointer was already set)
+   *  \param bytesRead Data bytes requested
+   *  \param status Outcome of the read */
+  void onRegisterRead(uint8_t bytesWritten, uint8_t bytesRead, Status status) {
+    _counters.registerReads++;
+    if (bytesWritten != 0) { _counters.pointerWrites++; }
+    _counters.bytesWritten += bytesWritten;
+    _counters.bytesRead += bytesRead;
+    if (status != Status::OK) { _counters.busErrors++; }
+  }
+
+  /** \brief Records the start of a conversion.
+   *  \param now Clock time in microseconds */
+  void onConversionStart(uint32_t now) {
+    _counters.conversionsStarted++;
+    _startTime    = now;
+    _pendingPolls = 0;
+    _pending      = true;
+  }
+
+  /** \brief Records a check of the OS bit.
+   *  \param complete Whether the conversion had finished
+   *  \param now Clock time in microseconds */
+  void onConversionPoll(bool complete, uint32_t now) {
+    _counters.polls++;
+    if (!_pending) { return; } // e.g. repeated checks after completion
+    _pendingPolls++;
+    if (!complete) { return; }
+    _pending = false;
+    _counters.conversionsCompleted++;
+    _counters.pollsPerConversion[bucket(_pendingPolls, POLL_HISTOGRAM_BUCKETS)]++;
+    _counters.latencyMicros[bucket(now - _startTime, LATENCY_HISTOGRAM_BUCKETS)]++;
+  }
+
+  /** \brief Copies the counters.
+   *  \return Current counter values */
+  InstrumentationCounters snapshot() const { return _counters; }
+
+  /** \brief Clears the counters. A conversion in progress is still tracked. */
+  void reset() { _counters = InstrumentationCounters(); }
+
+  /** \brief Gets the histogram bucket a value falls in.
+   *  \param value Value to classify
+   *  \param buckets Number of buckets
+   *  \return Bucket index: the bit length of value, capped at buckets - 1 */
+  static uint8_t bucket(uint32_t value, uint8_t buckets) {
+    uint8_t index = 0;
+    while (value != 0 && index < buckets - 1) {
+      value >>= 1;
+      index++;
+    }
+    return index;
+  }
+
+  private:
+  InstrumentationCounters _counters;
+  uint32_t _startTime    = 0;
+  uint32_t _pendingPolls = 0;
+  bool _pending          = false;
+};
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_INSTRUMENTATION_H
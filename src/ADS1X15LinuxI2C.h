@@ -0,0 +1,197 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_LINUX_I2C_H
+#define ADS1X15_LINUX_I2C_H
+
+// Host-only: uses the Linux i2c-dev interface. Not for use on microcontrollers.
+
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "ADS1X15.h"
+
+namespace ADS1X15 {
+
+constexpr uint8_t LINUX_I2C_BUFFER_LENGTH = 32; ///< Largest write or read, as for Arduino TwoWire
+
+/**
+ * \brief The system calls LinuxI2C makes, so they can be replaced by a fake in tests.
+ *
+ * A replacement needs the same three members. Each returns a negative errno value on failure.
+ */
+struct LinuxI2CSyscalls {
+  /** \brief Opens an i2c-dev device node.
+   *  \param path Device node, e.g. "/dev/i2c-1"
+   *  \return File descriptor, or a negative errno value */
+  int open(const char* path) {
+    int fd = ::open(path, O_RDWR | O_CLOEXEC);
+    return fd < 0 ? -errno : fd;
+  }
+
+  /** \brief Closes a device node.
+   *  \param fd File descriptor from open() */
+  void close(int fd) { ::close(fd); }
+
+  /** \brief Runs one combined transaction: every message after the first starts with a repeated start.
+   *  \param fd File descriptor from open()
+   *  \param transfer Messages to run
+   *  \return 0, or a negative errno value */
+  int transfer(int fd, i2c_rdwr_ioctl_data& transfer) { return ::ioctl(fd, I2C_RDWR, &transfer) < 0 ? -errno : 0; }
+};
+
+/**
+ * \brief WIRE implementation for a Linux i2c-dev bus (/dev/i2c-N).
+ *
+ * Writes are buffered until endTransmission(). A write ended with endTransmission(false) is held back and sent with
+ * the following requestFrom() as one I2C_RDWR ioctl: pointer write, repeated start, read. So every register access
+ * costs one system call, and no other bus master can get between the pointer write and the read.
+ *
+ * A failed transfer is reported the Arduino way: endTransmission() returns 2 for a NAK (ENXIO or EREMOTEIO), 5 for a
+ * timeout and 4 for any other error, and requestFrom() returns 0. lastError() gives the errno value. Because a held
+ * pointer write is only sent by requestFrom(), its NAK shows up as a short read.
+ *
+ * The device node needs read and write access, e.g. membership of the i2c group.
+ *
+ * \tparam Syscalls System call layer (LinuxI2CSyscalls, or a fake with the same members)
+ */
+template <typename Syscalls = LinuxI2CSyscalls> class BasicLinuxI2C {
+  public:
+  /** \brief Constructs a bus. The device node is opened by begin().
+   *  \param path Device node, e.g. "/dev/i2c-1"; must outlive the bus
+   *  \param syscalls System call layer */
+  explicit BasicLinuxI2C(const char* path, const Syscalls& syscalls = Syscalls())
+      : _path(path), _syscalls(syscalls) {}
+
+  BasicLinuxI2C(const BasicLinuxI2C&)            = delete;
+  BasicLinuxI2C& operator=(const BasicLinuxI2C&) = delete;
+
+  ~BasicLinuxI2C() { end(); }
+
+  /** \brief Gets the system call layer, e.g. to inspect a fake.
+   *  \return System call layer */
+  Syscalls& syscalls() { return _syscalls; }
+
+  /** \brief Checks whether the device node is open.
+   *  \return true after a successful begin() */
+  bool isOpen() const { return _fd >= 0; }
+
+  /** \brief Gets the errno value of the last failure.
+   *  \return errno value, or 0 if the last open or transfer succeeded */
+  int lastError() const { return _lastError; }
+
+  /** \brief Gets the number of I2C_RDWR calls made.
+   *  \return Transfer count */
+  uint32_t transfers() const { return _transfers; }
+
+  /** \brief Closes the device node. begin() opens it again. */
+  void end() {
+    if (_fd >= 0) { _syscalls.close(_fd); }
+    _fd = -1;
+  }
+
+  /// \name WIRE interface
+  /// @{
+  void begin() {
+    if (_fd >= 0) { return; }
+    int fd     = _syscalls.open(_path);
+    _lastError = fd < 0 ? -fd : 0;
+    _fd        = fd < 0 ? -1 : fd;
+  }
+
+  void beginTransmission(uint8_t address) {
+    _address = address;
+    _txSize  = 0;
+    _held    = false;
+  }
+
+  size_t write(uint8_t value) {
+    if (_txSize == LINUX_I2C_BUFFER_LENGTH) { return 0; }
+    _tx[_txSize++] = value;
+    return 1;
+  }
+
+  size_t write(const uint8_t* data, size_t n) {
+    size_t written = 0;
+    while (written < n && write(data[written]) == 1) { written++; }
+    return written;
+  }
+
+  uint8_t endTransmission(bool sendStop = true) {
+    if (!sendStop) {
+      _held = true;
+      return 0;
+    }
+    i2c_msg message = {_address, 0, _txSize, _tx};
+    return endCode(run(&message, 1));
+  }
+
+  uint8_t requestFrom(uint8_t address, uint8_t quantity) {
+    if (quantity > LINUX_I2C_BUFFER_LENGTH) { quantity = LINUX_I2C_BUFFER_LENGTH; }
+    _rxSize  = 0;
+    _rxIndex = 0;
+
+    i2c_msg messages[2] = {{_address, 0, _txSize, _tx}, {address, I2C_M_RD, quantity, _rx}};
+    bool combined       = _held && _address == address;
+    // A held write to another address cannot share the read's transfer, so it goes out on its own.
+    if (_held && !combined && run(messages, 1) != 0) { return 0; }
+    _held = false;
+
+    int result = combined ? run(messages, 2) : run(messages + 1, 1);
+    if (result != 0) { return 0; }
+    _rxSize = quantity;
+    return quantity;
+  }
+
+  int available() const { return _rxSize - _rxIndex; }
+
+  uint8_t read() { return _rxIndex < _rxSize ? _rx[_rxIndex++] : 0xFF; }
+  /// @}
+
+  private:
+  // Runs the messages as one I2C_RDWR call. Returns 0 or a negative errno value.
+  int run(i2c_msg* messages, uint32_t count) {
+    if (_fd < 0) {
+      _lastError = EBADF;
+      return -EBADF;
+    }
+    i2c_rdwr_ioctl_data transfer = {messages, count};
+    _transfers++;
+    int result = _syscalls.transfer(_fd, transfer);
+    _lastError = -result;
+    return result;
+  }
+
+  static uint8_t endCode(int result) {
+    if (result == 0) { return 0; }
+    if (result == -ENXIO || result == -EREMOTEIO) { return 2; }
+    return result == -ETIMEDOUT ? 5 : 4;
+  }
+
+  const char* _path;
+  Syscalls _syscalls;
+  int _fd                              = -1;
+  int _lastError                       = 0;
+  uint32_t _transfers                  = 0;
+  uint16_t _address                    = 0;
+  bool _held                           = false; // a write ended without a stop, waiting for requestFrom()
+  uint8_t _tx[LINUX_I2C_BUFFER_LENGTH] = {};
+  uint8_t _rx[LINUX_I2C_BUFFER_LENGTH] = {};
+  uint16_t _txSize                     = 0;
+  uint8_t _rxSize                      = 0;
+  uint8_t _rxIndex                     = 0;
+};
+
+/** \brief WIRE implementation for a Linux i2c-dev bus, using the real system calls. */
+using LinuxI2C = BasicLinuxI2C<>;
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_LINUX_I2C_H
@@ -0,0 +1,152 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_RING_BUFFER_H
+#define ADS1X15_RING_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#else
+#include <atomic>
+#endif
+
+namespace ADS1X15 {
+
+namespace detail {
+
+#if defined(__AVR__)
+// AVR has no <atomic>. Single-byte loads and stores are atomic, so the
+// indices are volatile uint8_t with compiler barriers for ordering.
+struct RingIndex {
+  volatile uint8_t value = 0;
+
+  uint8_t load() const {
+    uint8_t v = value;
+    __asm__ __volatile__("" ::: "memory");
+    return v;
+  }
+  void store(uint8_t v) {
+    __asm__ __volatile__("" ::: "memory");
+    value = v;
+  }
+};
+using RingIndexType = uint8_t;
+
+// A 32-bit access is four byte accesses, so the counter is read and
+// updated with interrupts masked, restoring the previous interrupt state.
+struct SharedCounter {
+  volatile uint32_t value = 0;
+
+  uint32_t load() const {
+    uint8_t sreg = SREG;
+    cli();
+    uint32_t v = value;
+    SREG       = sreg;
+    return v;
+  }
+  void increment() {
+    uint8_t sreg = SREG;
+    cli();
+    value = value + 1;
+    SREG  = sreg;
+  }
+};
+#else
+struct RingIndex {
+  std::atomic<uint32_t> value{0};
+
+  uint32_t load() const { return value.load(std::memory_order_acquire); }
+  void store(uint32_t v) { value.store(v, std::memory_order_release); }
+};
+using RingIndexType = uint32_t;
+
+struct SharedCounter {
+  std::atomic<uint32_t> value{0};
+
+  uint32_t load() const { return value.load(std::memory_order_relaxed); }
+  void increment() { value.fetch_add(1, std::memory_order_relaxed); }
+};
+#endif
+
+} // namespace detail
+
+/**
+ * \brief Fixed-capacity, allocation-free single-producer/single-consumer ring buffer.
+ *
+ * push() may be called from one context (e.g. an ISR or a reader thread) while pop()/drain() are called from
+ * another, without locks. Indices run freely and wrap, so all Capacity slots are usable.
+ *
+ * \tparam T Element type (copied in and out)
+ * \tparam Capacity Number of elements; a power of two (at most 128 on AVR)
+ */
+template <typename T, size_t Capacity> class SpscRingBuffer {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+  static_assert(
+      Capacity <= (static_cast<size_t>(static_cast<detail::RingIndexType>(~0)) >> 1) + 1,
+      "Capacity too large for the index type on this platform");
+
+  public:
+  /** \brief Appends an element. Producer side only.
+   *  \param item Element to append
+   *  \return false if the buffer was full and the element was dropped */
+  bool push(const T& item) {
+    detail::RingIndexType head = _head.load();
+    if (static_cast<detail::RingIndexType>(head - _tail.load()) == Capacity) { return false; }
+    _items[head & MASK] = item;
+    _head.store(static_cast<detail::RingIndexType>(head + 1));
+    return true;
+  }
+
+  /** \brief Removes the oldest element. Consumer side only.
+   *  \param item Receives the element
+   *  \return false if the buffer was empty */
+  bool pop(T& item) {
+    detail::RingIndexType tail = _tail.load();
+    if (tail == _head.load()) { return false; }
+    item = _items[tail & MASK];
+    _tail.store(static_cast<detail::RingIndexType>(tail + 1));
+    return true;
+  }
+
+  /** \brief Removes up to n of the oldest elements in one go. Consumer side only.
+   *  \param out Destination array
+   *  \param n Maximum number of elements to copy
+   *  \return Number of elements copied */
+  size_t drain(T* out, size_t n) {
+    detail::RingIndexType tail = _tail.load();
+    size_t count               = static_cast<detail::RingIndexType>(_head.load() - tail);
+    if (count > n) { count = n; }
+    for (size_t i = 0; i < count; i++) { out[i] = _items[(tail + i) & MASK]; }
+    _tail.store(static_cast<detail::RingIndexType>(tail + count));
+    return count;
+  }
+
+  /** \brief Gets the number of elements waiting. Exact from the consumer side, a lower bound elsewhere.
+   *  \return Number of elements */
+  size_t size() const { return static_cast<detail::RingIndexType>(_head.load() - _tail.load()); }
+
+  /** \brief Checks whether the buffer is empty.
+   *  \return true if no elements are waiting */
+  bool empty() const { return size() == 0; }
+
+  /** \brief Gets the capacity.
+   *  \return Capacity */
+  static constexpr size_t capacity() { return Capacity; }
+
+  private:
+  static constexpr size_t MASK = Capacity - 1;
+
+  T _items[Capacity];
+  detail::RingIndex _head;
+  detail::RingIndex _tail;
+};
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_RING_BUFFER_H
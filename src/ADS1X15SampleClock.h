@@ -0,0 +1,159 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_SAMPLE_CLOCK_H
+#define ADS1X15_SAMPLE_CLOCK_H
+
+#include "ADS1X15.h"
+
+namespace ADS1X15 {
+
+/**
+ * \brief Recovers the true conversion rate of a continuously converting chip from data-ready arrival times.
+ *
+ * The internal oscillator is only accurate to +/-10%, so timestamps of n * nominal period drift quickly. Feed every
+ * data-ready arrival time (from an ALERT/RDY interrupt or a poll) to onSample(). It returns a corrected timestamp on a
+ * smooth timeline that runs at the chip's actual rate.
+ *
+ * The estimate is made in two phases:
+ * - Acquisition: the first ACQUISITION_SAMPLES intervals are averaged to get the period.
+ * - Tracking: a second-order phase-locked loop follows slow drift, e.g. with temperature, and averages out arrival
+ *   jitter.
+ *
+ * Gaps of one or more whole periods (missed events, buffer overruns) are detected and counted, so the sample index
+ * stays aligned with the chip.
+ *
+ * Corrected timestamps include the average delay between conversion end and arrival. They are in the same wrapping
+ * microsecond domain as the arrival times. During acquisition the arrival times are returned unchanged. Use one
+ * SampleClock per device.
+ */
+class SampleClock {
+  public:
+  static constexpr uint8_t ACQUISITION_SAMPLES = 8; ///< Intervals averaged before the loop takes over
+
+  /** \brief Constructs a clock for a data rate.
+   *  \param rate Data rate the chip is converting at
+   *  \param bandwidthShift Loop gain is 2^-bandwidthShift per sample: larger is smoother but slower to follow drift */
+  template <typename Chip>
+  explicit SampleClock(ChipRate<Chip> rate, uint8_t bandwidthShift = 4)
+      : SampleClock(conversionPeriodMicros(rate), bandwidthShift) {}
+
+  /** \brief Constructs a clock for a nominal conversion period.
+   *  \param nominalPeriodMicros Nominal conversion period in microseconds
+   *  \param bandwidthShift Loop gain is 2^-bandwidthShift per sample */
+  explicit SampleClock(uint32_t nominalPeriodMicros, uint8_t bandwidthShift = 4)
+      : _nominal(static_cast<float>(nominalPeriodMicros)), _period(static_cast<float>(nominalPeriodMicros)),
+        _phaseGain(1.0f / static_cast<float>(1UL << bandwidthShift)),
+        _frequencyGain(_phaseGain * _phaseGain / 4.0f) {}
+
+  /** \brief Records a data-ready arrival and gets the corrected timestamp of that sample.
+   *  \param arrivalMicros Host time the data-ready event was seen, in microseconds (e.g. micros())
+   *  \return Corrected timestamp in microseconds */
+  uint32_t onSample(uint32_t arrivalMicros) {
+    if (_samples == 0) {
+      _origin    = arrivalMicros;
+      _phase     = arrivalMicros;
+      _phaseFrac = 0.0f;
+      _samples   = 1;
+      return arrivalMicros;
+    }
+
+    if (_samples <= ACQUISITION_SAMPLES) { return acquire(arrivalMicros); }
+    return track(arrivalMicros);
+  }
+
+  /** \brief Gets the estimated conversion period.
+   *  \return Period in microseconds */
+  float periodMicros() const { return _period; }
+
+  /** \brief Gets the measured effective sample rate.
+   *  \return Samples per second */
+  float samplesPerSecond() const { return 1e6f / _period; }
+
+  /** \brief Gets the estimated oscillator error.
+   *  \return Error in parts per million; positive means a slow oscillator and longer conversions */
+  float oscillatorErrorPpm() const { return (_period / _nominal - 1.0f) * 1e6f; }
+
+  /** \brief Gets the number of conversions since the first sample, including missed ones.
+   *  \return Sample index of the latest sample (0 for the first) */
+  uint32_t sampleIndex() const { return _samples == 0 ? 0 : _samples - 1 + _missed; }
+
+  /** \brief Gets the number of conversions whose data-ready events were never seen.
+   *  \return Missed sample count */
+  uint32_t missed() const { return _missed; }
+
+  /** \brief Checks whether the acquisition phase is over.
+   *  \return true once the loop is tracking */
+  bool locked() const { return _samples > ACQUISITION_SAMPLES; }
+
+  /** \brief Starts over from the nominal period, e.g. after the data rate or input has changed. */
+  void reset() {
+    _period    = _nominal;
+    _samples   = 0;
+    _missed    = 0;
+    _acquired  = 0;
+    _phaseFrac = 0.0f;
+  }
+
+  private:
+  // Averages the intervals seen so far. Gaps are counted against the nominal period, which is never more than 10%
+  // out, so one missing event (a 2x interval) cannot be mistaken for a slow oscillator.
+  uint32_t acquire(uint32_t arrivalMicros) {
+    uint32_t interval = arrivalMicros - _phase; // _phase holds the previous arrival until the loop starts
+    uint32_t periods  = periodsIn(static_cast<float>(interval), _nominal);
+    _missed += periods - 1;
+    _acquired += periods;
+    _samples++;
+    _period = static_cast<float>(arrivalMicros - _origin) / static_cast<float>(_acquired);
+    _phase  = arrivalMicros;
+    return arrivalMicros;
+  }
+
+  uint32_t track(uint32_t arrivalMicros) {
+    advance(_period); // predicted time of the next conversion
+    float error = static_cast<float>(static_cast<int32_t>(arrivalMicros - _phase)) - _phaseFrac;
+    if (error > _period / 2) {
+      uint32_t skipped = periodsIn(error, _period);
+      _missed += skipped;
+      advance(_period * static_cast<float>(skipped));
+      error -= _period * static_cast<float>(skipped);
+    }
+    _samples++;
+    advance(error * _phaseGain);
+    _period += error * _frequencyGain;
+    return _phaseFrac < 0.5f ? _phase : _phase + 1;
+  }
+
+  // Rounds interval / period to the nearest whole number of periods, at least 1.
+  static uint32_t periodsIn(float interval, float period) {
+    uint32_t n = static_cast<uint32_t>(interval / period + 0.5f);
+    return n == 0 ? 1 : n;
+  }
+
+  // Moves the phase by delta microseconds, keeping the fraction in [0, 1).
+  void advance(float delta) {
+    float total   = _phaseFrac + delta;
+    int32_t whole = static_cast<int32_t>(total);
+    if (static_cast<float>(whole) > total) { whole--; }
+    _phase += static_cast<uint32_t>(whole);
+    _phaseFrac = total - static_cast<float>(whole);
+  }
+
+  float _nominal;            ///< Nominal period from the data rate
+  float _period;             ///< Estimated period
+  float _phaseGain;          ///< Fraction of each phase error applied to the phase
+  float _frequencyGain;      ///< Fraction of each phase error applied to the period
+  uint32_t _origin   = 0;    ///< Arrival time of the first sample
+  uint32_t _phase    = 0;    ///< Integer part of the latest sample's time
+  float _phaseFrac   = 0.0f; ///< Fractional part of the latest sample's time
+  uint32_t _samples  = 0;    ///< Samples seen
+  uint32_t _acquired = 0;    ///< Periods covered during acquisition
+  uint32_t _missed   = 0;    ///< Conversions never seen
+};
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_SAMPLE_CLOCK_H
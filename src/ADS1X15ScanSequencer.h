@@ -0,0 +1,233 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_SCAN_SEQUENCER_H
+#define ADS1X15_SCAN_SEQUENCER_H
+
+#include "ADS1X15.h"
+#include "ADS1X15AutoRange.h"
+
+namespace ADS1X15 {
+
+// A result read (pointer write and 2-byte read with repeated start) takes about 450 us at 100 kHz.
+constexpr uint32_t PIPELINE_READ_BUDGET_US = 500; ///< Shortest conversion a pipelined scan overlaps with a read
+
+/**
+ * \brief Non-blocking sequencer that converts a list of inputs in turn and publishes complete frames.
+ *
+ * Each entry of the scan list carries its own mux, gain and rate as a precomputed CONFIG word (see ScanEntry).
+ * poll() never waits: it checks whether the current conversion has finished and, if so, reads it and starts the
+ * next one. When the last entry of a pass has been read, the pass is published as a frame and the next pass
+ * begins immediately.
+ *
+ * Entries can be auto-ranged with setAutoRange(): their gain then follows the input (see AutoRanger), and a
+ * saturated result is re-converted before the scan moves on. Each published result keeps the gain it was taken at.
+ *
+ * With setPipelined(), the next conversion is started as soon as the previous one is seen to finish, and the finished
+ * result is read while the next conversion runs. The chip then only idles for the completion poll and the CONFIG
+ * write. The number of transactions per result is unchanged, but each costs one extra pointer byte: the result read
+ * comes after the CONFIG write, so it leaves the pointer on CONVERSION, and the next completion poll has to move it
+ * back to CONFIG. The start can't come after the read without giving up the overlap.
+ *
+ * A bus error never publishes a result: the failed read is retried, or the failed start reissued, on the next poll(),
+ * and the error is reported by status() and busErrors().
+ *
+ * The scan list is referenced, not copied, so it must outlive the sequencer (typically a constexpr array).
+ *
+ * \tparam ADC Driver type (e.g. ADS1115<TwoWire>)
+ * \tparam N Number of entries in the scan list
+ */
+template <typename ADC, size_t N> class ScanSequencer {
+  static_assert(N > 0, "Scan list must not be empty");
+
+  public:
+  /** \brief Constructs a sequencer for a scan list.
+   *  \param ads ADC to drive
+   *  \param entries Scan list; must outlive the sequencer */
+  ScanSequencer(ADC& ads, const ScanEntry (&entries)[N]) : mAds(ads), mEntries(entries) {
+    for (size_t i = 0; i < N; i++) {
+      _gains[0][i] = entries[i].gain();
+      _gains[1][i] = entries[i].gain();
+    }
+  }
+
+  /** \brief Enables or disables automatic gain selection for one entry.
+   *
+   *  Enabling restarts the entry's ranging from the gain in its scan list entry. Takes effect from the entry's next
+   *  conversion.
+   *  \param index Scan list index (0 to N-1)
+   *  \param enable true to auto-range the entry */
+  void setAutoRange(size_t index, bool enable) {
+    if (index >= N) { return; }
+    _autoRange[index] = enable;
+    if (enable) { _rangers[index] = AutoRanger<typename ADC::Traits>(mEntries[index].gain()); }
+  }
+
+  /** \brief Enables or disables pipelining: starting each conversion before reading the previous result.
+   *
+   *  The conversion register keeps the previous result until the new conversion ends, so the read is safe as long
+   *  as it finishes first. Conversions shorter than PIPELINE_READ_BUDGET_US, and results of auto-ranged entries
+   *  (whose value decides what to convert next), are still read before the next start.
+   *  \param enable true to pipeline */
+  void setPipelined(bool enable) { _pipelined = enable; }
+
+  /** \brief Starts scanning from the first entry. Any pass in progress is abandoned. */
+  void start() {
+    _index   = 0;
+    _running = true;
+    startEntry(0);
+  }
+
+  /** \brief Stops scanning after the current conversion. The last published frame remains available. */
+  void stop() { _running = false; }
+
+  /** \brief Checks whether the sequencer is scanning.
+   *  \return true if start() has been called and stop() has not */
+  bool running() const { return _running; }
+
+  /** \brief Advances the scan without blocking.
+   *
+   *  Costs one CONFIG read while a conversion is in progress, or a result read plus the next CONFIG write once it
+   *  has finished.
+   *  \return true if this call completed a pass and published a new frame */
+  bool poll() {
+    if (!_running) { return false; }
+    if (_startPending) {
+      startEntry(_index);
+      return false;
+    }
+    bool complete = false;
+    if (!check(mAds.tryConversionComplete(complete)) || !complete) { return false; }
+
+    size_t finished  = _index;
+    size_t following = finished + 1 == N ? 0 : finished + 1;
+    Gain gain        = _activeGain;
+    // A failed overlapped start is retried after the read, as an unpipelined one would be.
+    bool overlapped  = overlaps(finished, following) && startEntry(following);
+
+    ReadResult r = mAds.tryGetLastConversionResults();
+    if (!check(r.status)) {
+      // An idle chip keeps its result and OS bit, so the next poll re-reads it. Once the next conversion is running
+      // the result is lost, so the entry is converted again.
+      if (overlapped) { startEntry(finished); }
+      return false;
+    }
+    int16_t count = r.value;
+    if (_autoRange[finished] && !_rangers[finished].update(count, gain)) {
+      _reconversions++;
+      startEntry(finished); // saturated: convert the same entry again at the widest range
+      return false;
+    }
+
+    workingFrame()[finished]         = count;
+    _gains[_published ^ 1][finished] = gain;
+    _index                           = following;
+    bool completed                   = following == 0;
+    if (completed) {
+      _published ^= 1;
+      ++_frameCount;
+    }
+    if (!overlapped) { startEntry(following); }
+    return completed;
+  }
+
+  /** \brief Gets the most recently published frame.
+   *  \return Pointer to N results, in scan list order (all zero before the first frame) */
+  const int16_t* frame() const { return _frames[_published]; }
+
+  /** \brief Gets one result of the most recently published frame.
+   *  \param index Scan list index (0 to N-1)
+   *  \return ADC conversion result */
+  int16_t result(size_t index) const { return index < N ? _frames[_published][index] : 0; }
+
+  /** \brief Gets the gain one result of the most recently published frame was taken at.
+   *  \param index Scan list index (0 to N-1)
+   *  \return Gain setting (the entry's own gain unless it is auto-ranged) */
+  Gain resultGain(size_t index) const { return index < N ? _gains[_published][index] : Gain::TWOTHIRDS_6144MV; }
+
+  /** \brief Converts a result of the most recently published frame to volts, using the gain it was taken at.
+   *  \param index Scan list index (0 to N-1)
+   *  \return Voltage in volts */
+  float resultVolts(size_t index) const {
+    return index < N ? mAds.computeVolts(_frames[_published][index], _gains[_published][index]) : 0.0f;
+  }
+
+  /** \brief Converts a result of the most recently published frame to calibrated microvolts.
+   *
+   *  Uses the coefficients for the entry's input and the gain the result was taken at, so auto-ranged entries are
+   *  calibrated at whichever gain they used.
+   *  \param index Scan list index (0 to N-1)
+   *  \param calibration Table of coefficients (e.g. a CalibrationTable)
+   *  \return Voltage in microvolts */
+  template <typename Table> int32_t resultMicrovolts(size_t index, const Table& calibration) const {
+    if (index >= N) { return 0; }
+    return calibration.get(mEntries[index].mux(), _gains[_published][index]).microvolts(_frames[_published][index]);
+  }
+
+  /** \brief Gets the number of frames published since construction.
+   *  \return Frame count */
+  uint32_t frameCount() const { return _frameCount; }
+
+  /** \brief Gets the outcome of the most recent bus access made by start() or poll().
+   *  \return Status::OK, or the bus error that occurred */
+  Status status() const { return _status; }
+
+  /** \brief Gets the number of bus errors seen since construction.
+   *  \return Error count */
+  uint32_t busErrors() const { return _busErrors; }
+
+  /** \brief Gets the number of saturated auto-ranged results that were re-converted.
+   *  \return Re-conversion count */
+  uint32_t reconversions() const { return _reconversions; }
+
+  /** \brief Gets the number of entries in the scan list.
+   *  \return N */
+  static constexpr size_t size() { return N; }
+
+  private:
+  int16_t* workingFrame() { return _frames[_published ^ 1]; }
+
+  bool overlaps(size_t finished, size_t following) const {
+    if (!_pipelined || _autoRange[finished]) { return false; }
+    return conversionTimeMinMicros(mEntries[following].template rate<typename ADC::Traits>()) >=
+           PIPELINE_READ_BUDGET_US;
+  }
+
+  // Records the outcome of a bus access.
+  bool check(Status status) {
+    _status = status;
+    if (status != Status::OK) { _busErrors++; }
+    return status == Status::OK;
+  }
+
+  // A start that fails leaves _startPending set, so poll() reissues it instead of reading a stale result.
+  bool startEntry(size_t index) {
+    _activeGain   = _autoRange[index] ? _rangers[index].gain() : mEntries[index].gain();
+    _startPending = !check(mAds.startReading(mEntries[index].withGain(_activeGain)));
+    return !_startPending;
+  }
+
+  ADC& mAds;
+  const ScanEntry (&mEntries)[N];
+  int16_t _frames[2][N] = {};
+  Gain _gains[2][N];
+  AutoRanger<typename ADC::Traits> _rangers[N];
+  bool _autoRange[N]      = {};
+  Gain _activeGain        = Gain::TWOTHIRDS_6144MV;
+  uint8_t _published      = 0;
+  size_t _index           = 0;
+  uint32_t _frameCount    = 0;
+  uint32_t _reconversions = 0;
+  uint32_t _busErrors     = 0;
+  Status _status          = Status::OK;
+  bool _startPending      = false;
+  bool _running           = false;
+  bool _pipelined         = false;
+};
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_SCAN_SEQUENCER_H
@@ -0,0 +1,473 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_SIMULATOR_H
+#define ADS1X15_SIMULATOR_H
+
+// Host-only: uses the C++ standard library. Not for use on microcontrollers.
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "ADS1X15.h"
+#include "ADS1X15AsyncI2C.h"
+
+namespace ADS1X15 {
+
+/**
+ * \brief Register-level model of one ADS1015/ADS1115, for host tests and benchmarks.
+ *
+ * Models the address pointer, the four registers, single-shot and continuous conversions with the OS busy bit, the
+ * comparator (traditional/window, polarity, latch, queue) and the ALERT/RDY pin. A conversion takes the nominal
+ * period for its DR bits, scaled by an optional oscillator error, and samples the input waveform for its mux setting
+ * when it completes.
+ *
+ * Devices are attached to a SimulatedWire, which owns the virtual clock.
+ */
+class SimulatedDevice {
+  public:
+  /** \brief Analog input as a function of time.
+   *  \param seconds Virtual time in seconds
+   *  \return Input voltage in volts */
+  using Waveform = std::function<double(double seconds)>;
+
+  /** \brief Constructs a device in its power-on state.
+   *  \param chip Chip traits value (ADS1015Traits{} or ADS1115Traits{})
+   *  \param address I2C address (0x48-0x4B) */
+  template <typename Chip>
+  explicit SimulatedDevice(Chip chip, uint8_t address = ADS1X15_ADDRESS)
+      : _address(address),
+        _shift(Chip::shift()),
+        _periodFn(&Chip::periodMicros) {
+    (void)chip;
+  }
+
+  /** \brief Sets the input for one mux setting.
+   *  \param mux Mux bits, e.g. ADS1X15_REG_CONFIG_MUX_SINGLE_0 or ScanEntry::mux()
+   *  \param waveform Input voltage over time */
+  void setInput(uint16_t mux, Waveform waveform) { _inputs[muxIndex(mux)] = waveform; }
+
+  /** \brief Sets a constant input for one mux setting.
+   *  \param mux Mux bits
+   *  \param volts Input voltage */
+  void setInputVoltage(uint16_t mux, double volts) {
+    setInput(mux, [volts](double) { return volts; });
+  }
+
+  /** \brief Sets the oscillator error, which scales every conversion period (datasheet: up to +/-10%).
+   *  \param ppm Error in parts per million; positive means a slow oscillator and longer conversions */
+  void setOscillatorErrorPpm(int32_t ppm) { _oscillatorPpm = ppm; }
+
+  /** \brief Gets the I2C address.
+   *  \return Address */
+  uint8_t address() const { return _address; }
+
+  /** \brief Gets a register value as the chip would return it, without touching the pointer.
+   *  \param reg Register
+   *  \return Register value */
+  uint16_t peekRegister(RegisterAddress reg) const {
+    uint8_t index = static_cast<uint8_t>(reg) & 0x03;
+    if (index == static_cast<uint8_t>(RegisterAddress::CONFIG)) {
+      uint16_t os = _converting ? ADS1X15_REG_CONFIG_OS_BUSY : ADS1X15_REG_CONFIG_OS_NOTBUSY;
+      return static_cast<uint16_t>(_regs[index] | os);
+    }
+    return _regs[index];
+  }
+
+  /** \brief Gets the pointer register.
+   *  \return Register the next read will return */
+  uint8_t pointer() const { return _pointer; }
+
+  /** \brief Checks whether a conversion is in progress.
+   *  \return true while the OS bit reads 0 */
+  bool converting() const { return _converting; }
+
+  /** \brief Gets the logical state of the ALERT/RDY output, independent of polarity.
+   *  \return true if the comparator or data-ready signal is asserted */
+  bool alertActive() const {
+    if ((_regs[1] & ADS1X15_REG_CONFIG_CQUE_MASK) == ADS1X15_REG_CONFIG_CQUE_NONE) { return false; }
+    if (rdyMode()) { return _rdyActive; }
+    // A latching comparator holds the pin until the conversion register is read; it re-asserts at the next
+    // conversion if the input is still past the threshold.
+    return latching() ? _alertLatched : _alertRaw;
+  }
+
+  /** \brief Gets the electrical level of the ALERT/RDY pin, applying CPOL. The pin idles high (pull-up).
+   *  \return true if the pin is high */
+  bool alertPinLevel() const {
+    bool activeHigh = (_regs[1] & ADS1X15_REG_CONFIG_CPOL_MASK) == ADS1X15_REG_CONFIG_CPOL_ACTVHI;
+    return alertActive() ? activeHigh : !activeHigh;
+  }
+
+  /** \brief Gets the number of conversions completed since construction.
+   *  \return Conversion count */
+  uint32_t conversions() const { return _conversions; }
+
+  /** \brief Gets the virtual time at which the current conversion will complete.
+   *  \return Time in nanoseconds, or 0 if no conversion is running */
+  uint64_t nextCompletionNanos() const { return _converting ? _completeAt : 0; }
+
+  /** \brief Runs all conversions that complete up to a point in time.
+   *  \param nowNanos Virtual time in nanoseconds */
+  void update(uint64_t nowNanos) {
+    while (_converting && _completeAt <= nowNanos) {
+      completeConversion(_completeAt);
+      if (continuous()) {
+        _completeAt += conversionNanos();
+      } else {
+        _converting = false;
+      }
+    }
+    if (_rdyActive && continuous() && nowNanos >= _rdyPulseEnd) { _rdyActive = false; }
+  }
+
+  /** \brief Handles a write transaction addressed to this device.
+   *  \param data Bytes written after the address byte
+   *  \param n Number of bytes
+   *  \param nowNanos Time of the stop/repeated start */
+  void onWrite(const uint8_t* data, size_t n, uint64_t nowNanos) {
+    update(nowNanos);
+    if (n == 0) { return; }
+    _pointer = data[0] & 0x03;
+    if (n < 3) { return; }
+    uint16_t value = static_cast<uint16_t>((data[1] << 8) | data[2]);
+    switch (static_cast<RegisterAddress>(_pointer)) {
+    case RegisterAddress::CONVERSION:
+      break; // read-only
+    case RegisterAddress::CONFIG:
+      writeConfig(value, nowNanos);
+      break;
+    case RegisterAddress::LOTHRESH:
+    case RegisterAddress::HITHRESH:
+      _regs[_pointer] = value;
+      break;
+    }
+  }
+
+  /** \brief Handles a read transaction addressed to this device.
+   *  \param out Receives the bytes
+   *  \param n Number of bytes requested
+   *  \param nowNanos Time the data is sampled */
+  void onRead(uint8_t* out, size_t n, uint64_t nowNanos) {
+    update(nowNanos);
+    uint16_t value = peekRegister(static_cast<RegisterAddress>(_pointer));
+    for (size_t i = 0; i < n; i++) { out[i] = static_cast<uint8_t>(i % 2 == 0 ? value >> 8 : value); }
+    if (_pointer == static_cast<uint8_t>(RegisterAddress::CONVERSION)) { _alertLatched = false; }
+  }
+
+  private:
+  static size_t muxIndex(uint16_t mux) { return (mux & ADS1X15_REG_CONFIG_MUX_MASK) >> 12; }
+
+  bool continuous() const { return (_regs[1] & ADS1X15_REG_CONFIG_MODE_MASK) == ADS1X15_REG_CONFIG_MODE_CONTIN; }
+
+  bool latching() const { return (_regs[1] & ADS1X15_REG_CONFIG_CLAT_MASK) == ADS1X15_REG_CONFIG_CLAT_LATCH; }
+
+  bool rdyMode() const { return (_regs[3] & 0x8000) != 0 && (_regs[2] & 0x8000) == 0; }
+
+  uint64_t conversionNanos() const {
+    uint64_t nominal = static_cast<uint64_t>(_periodFn(_regs[1] & ADS1X15_REG_CONFIG_RATE_MASK)) * 1000;
+    return nominal + static_cast<int64_t>(nominal) * _oscillatorPpm / 1000000;
+  }
+
+  void writeConfig(uint16_t value, uint64_t nowNanos) {
+    bool start = (value & ADS1X15_REG_CONFIG_OS_MASK) != 0;
+    _regs[1]   = static_cast<uint16_t>(value & ~ADS1X15_REG_CONFIG_OS_MASK);
+    _queued       = 0;
+    _alertRaw     = false;
+    _alertLatched = false;
+    // Writing CONFIG in continuous mode restarts the conversion cycle. OS = 1 during a single-shot conversion has no
+    // effect, and switching from continuous to single-shot lets the current conversion finish, then powers down.
+    if (continuous() || (start && !_converting)) { beginConversion(nowNanos); }
+  }
+
+  void beginConversion(uint64_t nowNanos) {
+    _converting = true;
+    _completeAt = nowNanos + conversionNanos();
+    if (!continuous()) { _rdyActive = false; }
+  }
+
+  void completeConversion(uint64_t atNanos) {
+    uint16_t config       = _regs[1];
+    const Waveform& input = _inputs[muxIndex(config)];
+    double volts          = input ? input(static_cast<double>(atNanos) / 1e9) : 0.0;
+    double range          = ADS1X15_RANGE_MICROVOLTS[(config & ADS1X15_REG_CONFIG_PGA_MASK) >> 9] / 1e6;
+    double fullScale      = static_cast<double>(static_cast<int32_t>(1) << (15 - _shift));
+    double count          = std::floor(volts / range * fullScale + 0.5);
+    if (count > fullScale - 1) { count = fullScale - 1; }
+    if (count < -fullScale) { count = -fullScale; }
+    _regs[0] = static_cast<uint16_t>(static_cast<uint16_t>(static_cast<int16_t>(count)) << _shift);
+    _conversions++;
+
+    _rdyActive   = true;
+    _rdyPulseEnd = atNanos + RDY_PULSE_NS;
+    updateComparator(static_cast<int16_t>(_regs[0]), config);
+  }
+
+  void updateComparator(int16_t value, uint16_t config) {
+    int16_t lo    = static_cast<int16_t>(_regs[2]);
+    int16_t hi    = static_cast<int16_t>(_regs[3]);
+    bool window   = (config & ADS1X15_REG_CONFIG_CMODE_MASK) == ADS1X15_REG_CONFIG_CMODE_WINDOW;
+    bool outside  = window ? (value > hi || value < lo) : value > hi;
+    uint8_t queue = static_cast<uint8_t>(1u << (config & ADS1X15_REG_CONFIG_CQUE_MASK)); // 1, 2 or 4 conversions
+
+    if (outside) {
+      if (_queued < queue) { _queued++; }
+      if (_queued >= queue) {
+        _alertRaw     = true;
+        _alertLatched = true;
+      }
+    } else {
+      _queued = 0;
+      // Traditional mode has hysteresis: it only deasserts once the value falls below LO.
+      if (window || value < lo) { _alertRaw = false; }
+    }
+  }
+
+  static constexpr uint64_t RDY_PULSE_NS = 8000; // ~8 us data-ready pulse in continuous mode
+
+  uint8_t _address;
+  uint8_t _shift;
+  uint32_t (*_periodFn)(uint16_t);
+  uint16_t _regs[4]      = {0x0000, 0x0583, 0x8000, 0x7FFF}; // power-on defaults, OS held separately
+  uint8_t _pointer       = 0;
+  bool _converting       = false;
+  uint64_t _completeAt   = 0;
+  uint32_t _conversions  = 0;
+  int32_t _oscillatorPpm = 0;
+  uint8_t _queued        = 0;
+  bool _alertRaw         = false;
+  bool _alertLatched     = false;
+  bool _rdyActive        = false;
+  uint64_t _rdyPulseEnd  = 0;
+  Waveform _inputs[8];
+};
+
+/**
+ * \brief Simulated I2C bus implementing the WIRE interface, with a virtual clock.
+ *
+ * Every transaction advances the clock by its length on the wire: a start bit, 9 bits per byte including the address
+ * byte, and a stop bit unless the transaction ends in a repeated start. Transactions to an address with no attached
+ * device NAK. The clock can also be advanced directly, e.g. from a driver delay hook.
+ */
+class SimulatedWire {
+  public:
+  /** \brief Constructs a bus.
+   *  \param clockHz SCL frequency (e.g. 100000, 400000, 1000000) */
+  explicit SimulatedWire(uint32_t clockHz = 400000) { setClock(clockHz); }
+
+  /** \brief Attaches a device. The device must outlive the bus.
+   *  \param device Device to attach */
+  void attach(SimulatedDevice& device) { mDevices.push_back(&device); }
+
+  /** \brief Sets the SCL frequency.
+   *  \param clockHz Frequency in Hz */
+  void setClock(uint32_t clockHz) { _bitNanos = 1000000000ull / clockHz; }
+
+  /** \brief Gets the virtual time.
+   *  \return Nanoseconds since construction */
+  uint64_t nanos() const { return _now; }
+
+  /** \brief Gets the virtual time in microseconds, wrapping like Arduino micros().
+   *  \return Microseconds since construction */
+  uint32_t micros() const { return static_cast<uint32_t>(_now / 1000); }
+
+  /** \brief Advances the virtual clock without bus traffic.
+   *  \param micros Microseconds to advance */
+  void advanceMicros(uint32_t micros) { advanceNanos(static_cast<uint64_t>(micros) * 1000); }
+
+  /** \brief Advances the virtual clock without bus traffic.
+   *  \param nanos Nanoseconds to advance */
+  void advanceNanos(uint64_t nanos) {
+    _now += nanos;
+    for (SimulatedDevice* device : mDevices) { device->update(_now); }
+  }
+
+  /** \brief Gets the number of transactions (start conditions) since the last resetStats().
+   *  \return Transaction count */
+  uint32_t transactions() const { return _transactions; }
+
+  /** \brief Gets the number of bytes on the wire, including address bytes, since the last resetStats().
+   *  \return Byte count */
+  uint32_t bytes() const { return _bytes; }
+
+  /** \brief Gets the time the bus was busy since the last resetStats().
+   *  \return Nanoseconds */
+  uint64_t busNanos() const { return _busNanos; }
+
+  /** \brief Clears the transaction, byte and bus-time counters. */
+  void resetStats() {
+    _transactions = 0;
+    _bytes        = 0;
+    _busNanos     = 0;
+  }
+
+  /// \name WIRE interface
+  /// @{
+  void begin() {}
+
+  void beginTransmission(uint8_t address) {
+    _txAddress = address;
+    _tx.clear();
+  }
+
+  size_t write(uint8_t value) {
+    _tx.push_back(value);
+    return 1;
+  }
+
+  size_t write(const uint8_t* data, size_t n) {
+    _tx.insert(_tx.end(), data, data + n);
+    return n;
+  }
+
+  uint8_t endTransmission(bool sendStop = true) {
+    transaction(_tx.size(), sendStop);
+    SimulatedDevice* device = find(_txAddress);
+    if (device == nullptr) { return 2; }
+    device->onWrite(_tx.data(), _tx.size(), _now);
+    return 0;
+  }
+
+  uint8_t requestFrom(uint8_t address, uint8_t quantity) {
+    _rx.clear();
+    _rxIndex                = 0;
+    SimulatedDevice* device = find(address);
+    // The device samples the register just after the address byte; the data bytes follow.
+    transaction(0, false);
+    if (device == nullptr) {
+      _now += _bitNanos; // stop
+      _busNanos += _bitNanos;
+      return 0;
+    }
+    _rx.resize(quantity);
+    device->onRead(_rx.data(), quantity, _now);
+    uint64_t data = (9ull * quantity + 1) * _bitNanos;
+    _now += data;
+    _busNanos += data;
+    _bytes += quantity;
+    return quantity;
+  }
+
+  int available() const { return static_cast<int>(_rx.size() - _rxIndex); }
+
+  uint8_t read() { return _rxIndex < _rx.size() ? _rx[_rxIndex++] : 0xFF; }
+  /// @}
+
+  private:
+  SimulatedDevice* find(uint8_t address) const {
+    for (SimulatedDevice* device : mDevices) {
+      if (device->address() == address) { return device; }
+    }
+    return nullptr;
+  }
+
+  // Accounts a start, the address byte, n data bytes and optionally a stop.
+  void transaction(size_t n, bool stop) {
+    uint64_t bits = 1 + 9 * (1 + n) + (stop ? 1 : 0);
+    _now += bits * _bitNanos;
+    _busNanos += bits * _bitNanos;
+    _transactions++;
+    _bytes += static_cast<uint32_t>(1 + n);
+  }
+
+  std::vector<SimulatedDevice*> mDevices;
+  std::vector<uint8_t> _tx;
+  std::vector<uint8_t> _rx;
+  size_t _rxIndex        = 0;
+  uint8_t _txAddress     = 0;
+  uint64_t _bitNanos     = 0;
+  uint64_t _now          = 0;
+  uint32_t _transactions = 0;
+  uint32_t _bytes        = 0;
+  uint64_t _busNanos     = 0;
+};
+
+/**
+ * \brief Simulated interrupt-driven I2C controller: an asynchronous backend for TransactionQueue.
+ *
+ * start() only records the transaction. It goes out on the SimulatedWire when the virtual clock is advanced through
+ * this object, and its completion is then reported as the transfer-complete interrupt would. Work the CPU does in
+ * the meantime is modelled by advancing the clock, so it overlaps with the bus traffic. A start latency can be set
+ * to model the interrupt and DMA set-up time before each transaction.
+ */
+class SimulatedAsyncI2C {
+  public:
+  /** \brief Constructs a controller.
+   *  \param wire Bus the transactions run on, and the virtual clock */
+  explicit SimulatedAsyncI2C(SimulatedWire& wire) : mWire(wire) {}
+
+  /** \brief Sets the time from start() until the transaction begins on the bus.
+   *  \param nanos Latency in nanoseconds (default 0) */
+  void setStartLatencyNanos(uint64_t nanos) { _latency = nanos; }
+
+  /** \brief Checks whether a transaction is waiting or on the bus.
+   *  \return true if busy */
+  bool busy() const { return mActive != nullptr; }
+
+  /** \brief Gets the number of transactions completed.
+   *  \return Transaction count */
+  uint32_t completed() const { return _completed; }
+
+  /** \brief Advances the virtual clock, running the transactions due in that time and reporting their completions.
+   *
+   *  A transaction that starts within the interval runs to its end, so the clock can finish slightly past it.
+   *  \param micros Microseconds to advance */
+  void advanceMicros(uint32_t micros) {
+    uint64_t target = mWire.nanos() + static_cast<uint64_t>(micros) * 1000;
+    while (mActive != nullptr && _startAt <= target) { run(); }
+    if (mWire.nanos() < target) { mWire.advanceNanos(target - mWire.nanos()); }
+  }
+
+  /** \brief Runs transactions, including any submitted by completion callbacks, until none is left. */
+  void runUntilIdle() {
+    while (mActive != nullptr) { run(); }
+  }
+
+  /// \name Asynchronous backend interface
+  /// @{
+  void start(I2CTransaction& transaction, CompletionFunction done, void* context) {
+    mActive  = &transaction;
+    _done    = done;
+    _context = context;
+    _startAt = mWire.nanos() + _latency;
+  }
+  /// @}
+
+  private:
+  void run() {
+    if (mWire.nanos() < _startAt) { mWire.advanceNanos(_startAt - mWire.nanos()); }
+    Status status = execute(*mActive);
+    mActive       = nullptr;
+    _completed++;
+    // May start the next transaction.
+    _done(_context, status);
+  }
+
+  Status execute(I2CTransaction& t) {
+    mWire.beginTransmission(t.address);
+    mWire.write(t.pointer);
+    mWire.write(t.payload, t.writeLength);
+    if (t.readLength == 0) { return statusFromEndTransmission(mWire.endTransmission()); }
+    Status status = statusFromEndTransmission(mWire.endTransmission(false));
+    if (status != Status::OK) { return status; }
+    uint8_t received = mWire.requestFrom(t.address, t.readLength);
+    for (uint8_t i = 0; i < received; i++) { t.data[i] = mWire.read(); }
+    return received < t.readLength ? Status::SHORT_READ : Status::OK;
+  }
+
+  SimulatedWire& mWire;
+  I2CTransaction* mActive  = nullptr;
+  CompletionFunction _done = nullptr;
+  void* _context           = nullptr;
+  uint64_t _startAt        = 0;
+  uint64_t _latency        = 0;
+  uint32_t _completed      = 0;
+};
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_SIMULATOR_H
@@ -0,0 +1,120 @@
+/***************************************************
+ This is a library for the ADS1X15 I2C ADC.
+
+ Written by Chris Barr, 2022.
+ ****************************************************/
+
+#ifndef ADS1X15_STREAM_READER_H
+#define ADS1X15_STREAM_READER_H
+
+#include "ADS1X15.h"
+#include "ADS1X15RingBuffer.h"
+
+namespace ADS1X15 {
+
+/** \brief A conversion result with the time its data-ready event was seen. */
+struct Sample {
+  uint32_t timestamp; ///< Time of the data-ready event, in the caller's clock units (e.g. micros())
+  int16_t value;      ///< Conversion result
+};
+
+/**
+ * \brief Continuous-mode acquisition into a lock-free sample buffer.
+ *
+ * start() puts the ADC in continuous mode with ALERT/RDY in data-ready mode. Every data-ready event should then
+ * call onDataReady(), which reads the conversion and pushes a timestamped Sample into a fixed-capacity SPSC ring
+ * buffer. The consumer takes samples out with pop() or drain() at its own pace; while the buffer has room no
+ * sample is lost, however long the consumer is busy.
+ *
+ * onDataReady() performs an I2C read. Call it from the ALERT/RDY ISR only where the WIRE implementation may be used
+ * in interrupt context; otherwise call it from a high-priority task or thread woken by the ISR.
+ *
+ * \tparam ADC Driver type (e.g. ADS1115<TwoWire>)
+ * \tparam Capacity Number of samples buffered; a power of two (at most 128 on AVR)
+ */
+template <typename ADC, size_t Capacity> class StreamReader {
+  public:
+  /** \brief Constructs a reader for an ADC.
+   *  \param ads ADC to read */
+  explicit StreamReader(ADC& ads) : mAds(ads) {}
+
+  /** \brief Starts continuous conversions on a single-ended channel.
+   *  \param channel ADC channel (0-3) */
+  void start(uint8_t channel) { mAds.startSingleEndedReading(channel, /*continuous=*/true); }
+
+  /** \brief Starts continuous conversions on a differential pair.
+   *  \param pair Differential input pair */
+  void start(DifferentialPair pair) { mAds.startDifferentialReading(pair, /*continuous=*/true); }
+
+  /** \brief Starts continuous conversions from a scan entry; its continuous flag is forced on.
+   *  \param entry Input, gain and rate to convert */
+  void start(const ScanEntry& entry) {
+    mAds.startReading(ScanEntry{static_cast<uint16_t>(entry.config & ~ADS1X15_REG_CONFIG_MODE_MASK)});
+  }
+
+  /** \brief Producer: reads the new conversion and buffers it. Call once per data-ready event.
+   *  \param timestamp Time of the data-ready event (e.g. micros() captured in the ISR)
+   *  \return false if the sample was lost to a full buffer or a bus error */
+  bool onDataReady(uint32_t timestamp) {
+    ReadResult r = mAds.tryGetLastConversionResults();
+    if (!r.ok()) {
+      _readErrors.increment();
+      return false;
+    }
+    if (!_buffer.push(Sample{timestamp, r.value})) {
+      _overruns.increment();
+      return false;
+    }
+    return true;
+  }
+
+  /** \brief Consumer: takes the oldest sample.
+   *  \param sample Receives the sample
+   *  \return false if no sample was waiting */
+  bool pop(Sample& sample) { return _buffer.pop(sample); }
+
+  /** \brief Consumer: takes up to n of the oldest samples.
+   *  \param out Destination array
+   *  \param n Maximum number of samples to copy
+   *  \return Number of samples copied */
+  size_t drain(Sample* out, size_t n) { return _buffer.drain(out, n); }
+
+  /** \brief Consumer: takes up to n of the oldest samples as calibrated microvolts, without their timestamps.
+   *  \param out Destination array
+   *  \param n Maximum number of values to write
+   *  \param calibration Coefficients for the input and gain being streamed (e.g. from CalibrationTable::get())
+   *  \return Number of values written */
+  size_t drainMicrovolts(int32_t* out, size_t n, const Calibration& calibration) {
+    size_t count = 0;
+    Sample sample;
+    while (count < n && _buffer.pop(sample)) { out[count++] = calibration.microvolts(sample.value); }
+    return count;
+  }
+
+  /** \brief Gets the number of samples waiting.
+   *  \return Number of samples */
+  size_t available() const { return _buffer.size(); }
+
+  /** \brief Gets the number of samples dropped because the buffer was full.
+   *  \return Overrun count */
+  uint32_t overruns() const { return _overruns.load(); }
+
+  /** \brief Gets the number of data-ready events whose conversion could not be read.
+   *  \return Read error count */
+  uint32_t readErrors() const { return _readErrors.load(); }
+
+  /** \brief Gets the buffer capacity.
+   *  \return Capacity in samples */
+  static constexpr size_t capacity() { return Capacity; }
+
+  private:
+  ADC& mAds;
+  SpscRingBuffer<Sample, Capacity> _buffer;
+  // Written only by the producer; read by the consumer without tearing.
+  detail::SharedCounter _overruns;
+  detail::SharedCounter _readErrors;
+};
+
+} // namespace ADS1X15
+
+#endif // ADS1X15_STREAM_READER_H
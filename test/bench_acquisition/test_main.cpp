@@ -0,0 +1,101 @@
+/**
+ * Scaling benchmark for the multi-bus AcquisitionEngine.
+ *
+ * Runs 1, 2 and 3 simulated buses with four ADS1115 chips each at 860 SPS and
+ * 1 MHz, with one consumer merging the stream. Reports, per configuration, the
+ * aggregate sample rate in bus (virtual) time, which is what real buses would
+ * deliver, and the host rate at which the merged stream was consumed.
+ * Run with: pio test -e native_bench
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <thread>
+
+#include "ADS1X15.h"
+#include "ADS1X15Acquisition.h"
+#include "ADS1X15Simulator.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+constexpr size_t CHIPS        = 4;
+constexpr uint32_t RUN_MILLIS = 300;
+
+using Driver = ADS1X15::ADS1115<ADS1X15::SimulatedWire>;
+
+uint32_t steadyMicros() {
+    using namespace std::chrono;
+    return static_cast<uint32_t>(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+struct Bus {
+    ADS1X15::SimulatedWire wire{1000000};
+    std::deque<ADS1X15::SimulatedDevice> chips;
+    std::deque<Driver> drivers;
+
+    Bus() {
+        for (size_t d = 0; d < CHIPS; d++) {
+            chips.emplace_back(ADS1X15::ADS1115Traits{}, static_cast<uint8_t>(0x48 + d));
+            wire.attach(chips.back());
+            drivers.emplace_back(wire);
+            drivers.back().begin(static_cast<uint8_t>(0x48 + d));
+        }
+    }
+};
+
+// Returns the aggregate samples per second of bus time.
+template <size_t Buses> double run() {
+    std::deque<Bus> buses(Buses);
+    ADS1X15::AcquisitionEngine<Driver, Buses, CHIPS, 4096> engine(steadyMicros);
+    const ADS1X15::ScanEntry entry =
+        ADS1X15::ScanEntry::singleEnded(0, ADS1X15::Gain::TWO_2048MV, ADS1X15::Rate::ADS1115_860SPS);
+    for (size_t b = 0; b < Buses; b++) {
+        for (Driver& d : buses[b].drivers) { engine.addDevice(b, d, entry); }
+    }
+
+    engine.start();
+    auto start    = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::milliseconds(RUN_MILLIS);
+    ADS1X15::AcquiredSample s;
+    uint32_t lastTimestamp = 0;
+    bool ordered           = true;
+    while (std::chrono::steady_clock::now() < deadline) {
+        while (engine.next(s)) {
+            ordered       = ordered && (engine.merged() == 1 || static_cast<int32_t>(s.timestamp - lastTimestamp) >= 0);
+            lastTimestamp = s.timestamp;
+        }
+        std::this_thread::yield();
+    }
+    engine.stop();
+    double hostSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double aggregate = 0;
+    for (size_t b = 0; b < Buses; b++) {
+        aggregate += engine.stats(b).produced / (buses[b].wire.nanos() / 1e9);
+    }
+    ADS1X15::AcquisitionStats totals = engine.totals();
+    std::printf("%zu bus(es): %.0f samples/s of bus time, %.0f merged samples/s of host time, %u dropped, %u stalls\n",
+                Buses, aggregate, engine.merged() / hostSeconds, totals.dropped, totals.stalls);
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(totals.readErrors, 0u);
+    return aggregate;
+}
+
+} // namespace
+
+TEST(BenchAcquisition, ThroughputScalesWithBuses) {
+    double one   = run<1>();
+    double two   = run<2>();
+    double three = run<3>();
+    // The buses run independently, so each one adds a full bus worth of samples.
+    EXPECT_GT(two, 1.9 * one);
+    EXPECT_GT(three, 2.85 * one);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
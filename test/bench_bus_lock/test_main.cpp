@@ -0,0 +1,121 @@
+/**
+ * Lock overhead and contention benchmark for the bus-lock policy.
+ *
+ * Measures the host time per continuous-mode sample with NoBusLock and with
+ * MutexBusLock (uncontended), then runs one thread per chip against a shared
+ * simulated bus and checks that no read returns another chip's data.
+ * Run with: pio test -e native_bench
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ADS1X15.h"
+#include "ADS1X15BusLock.h"
+#include "ADS1X15Simulator.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+constexpr uint32_t SAMPLES        = 200000;
+constexpr uint32_t THREAD_SAMPLES = 20000;
+constexpr size_t CHIPS            = 4;
+
+using Unlocked = ADS1X15::ADS1115<ADS1X15::SimulatedWire>;
+using Locked   = ADS1X15::ADS1115<ADS1X15::SimulatedWire, ADS1X15::NoInstrumentation, ADS1X15::MutexBusLock>;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void attach(ADS1X15::NoBusLock&, std::mutex&) {}
+void attach(ADS1X15::MutexBusLock& lock, std::mutex& mutex) { lock.attach(mutex); }
+
+// Host nanoseconds per bare CONVERSION read in continuous mode: the cheapest transaction, so lock cost shows most.
+template <typename Driver> double nanosPerSample() {
+    ADS1X15::SimulatedWire bus(1000000);
+    ADS1X15::SimulatedDevice dev{ADS1X15::ADS1115Traits{}};
+    bus.attach(dev);
+    Driver ads(bus);
+    std::mutex mutex;
+    attach(ads.busLock(), mutex);
+    ads.begin();
+    ads.setDataRate(ADS1X15::Rate::ADS1115_860SPS);
+    ads.startSingleEndedReading(0, /*continuous=*/true);
+
+    int32_t sum = 0;
+    auto start  = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < SAMPLES; i++) { sum += ads.getLastConversionResults(); }
+    double seconds = secondsSince(start);
+    EXPECT_EQ(sum, 0);
+    return seconds * 1e9 / SAMPLES;
+}
+
+} // namespace
+
+TEST(BenchBusLock, UncontendedOverhead) {
+    double plain  = nanosPerSample<Unlocked>();
+    double locked = nanosPerSample<Locked>();
+    std::printf("bus lock: %.1f ns/sample unlocked, %.1f ns/sample with MutexBusLock (+%.1f ns)\n", plain, locked,
+                locked - plain);
+}
+
+TEST(BenchBusLock, ThreadsSharingOneBus) {
+    ADS1X15::SimulatedWire bus(1000000);
+    std::mutex mutex;
+    std::deque<ADS1X15::SimulatedDevice> devices;
+    std::deque<Locked> drivers;
+    for (size_t i = 0; i < CHIPS; i++) {
+        devices.emplace_back(ADS1X15::ADS1115Traits{}, static_cast<uint8_t>(0x48 + i));
+        bus.attach(devices.back());
+        for (uint8_t ch = 0; ch < 4; ch++) {
+            devices.back().setInputVoltage(ADS1X15::MUX_BY_CHANNEL[ch], 0.1 * (4 * i + ch + 1));
+        }
+        drivers.emplace_back(bus);
+        drivers.back().busLock().attach(mutex);
+        drivers.back().begin(static_cast<uint8_t>(0x48 + i));
+        drivers.back().setGain(ADS1X15::Gain::TWO_2048MV);
+    }
+
+    std::atomic<uint32_t> corrupted(0);
+    std::atomic<uint32_t> failed(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < CHIPS; i++) {
+        threads.emplace_back([&, i] {
+            while (!go) {}
+            for (uint32_t n = 0; n < THREAD_SAMPLES; n++) {
+                uint8_t ch            = static_cast<uint8_t>(n % 4);
+                int16_t expected      = static_cast<int16_t>(std::lround(0.1 * (4 * i + ch + 1) / 2.048 * 32768));
+                ADS1X15::ReadResult r = drivers[i].tryReadADCSingleEnded(ch, 1000000);
+                if (!r.ok()) {
+                    failed++;
+                } else if (r.value != expected) {
+                    corrupted++;
+                }
+            }
+        });
+    }
+    auto start = std::chrono::steady_clock::now();
+    go         = true;
+    for (std::thread& t : threads) { t.join(); }
+    double seconds = secondsSince(start);
+
+    uint32_t total = static_cast<uint32_t>(CHIPS) * THREAD_SAMPLES;
+    std::printf("%zu threads: %u single-shot reads in %.3f s host time (%.0f ns/read), %u corrupted, %u failed\n",
+                CHIPS, total, seconds, seconds * 1e9 / total, corrupted.load(), failed.load());
+    EXPECT_EQ(corrupted.load(), 0u);
+    EXPECT_EQ(failed.load(), 0u);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
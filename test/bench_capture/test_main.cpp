@@ -0,0 +1,112 @@
+/**
+ * Throughput and size benchmark for the binary capture format.
+ *
+ * Encodes a four-channel capture into 512-byte blocks (one SD card sector
+ * each), decodes it again, and compares its size with the same samples written
+ * as CSV lines. Run with: pio test -e native_bench
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "ADS1X15.h"
+#include "ADS1X15CaptureDecoder.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+constexpr uint32_t SAMPLES = 1000000;
+
+struct Input {
+    uint8_t channel;
+    int16_t count;
+    uint32_t timestamp;
+};
+
+// Slow signals plus a few counts of noise, at 860 SPS.
+std::vector<Input> makeCapture() {
+    std::vector<Input> input(SAMPLES);
+    uint32_t x = 12345;
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        x             = x * 1103515245u + 12345u;
+        int16_t count = static_cast<int16_t>(12000.0 * std::sin(i / 3000.0) + static_cast<int32_t>((x >> 16) % 9) - 4);
+        input[i]      = Input{static_cast<uint8_t>(i % 4), count, i * 1163u + (x >> 28)};
+    }
+    return input;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+TEST(BenchCapture, EncodeDecodeThroughput) {
+    using ADS1X15::ScanEntry;
+    std::vector<Input> input = makeCapture();
+
+    ADS1X15::CaptureEncoder<512> encoder;
+    for (uint8_t ch = 0; ch < 4; ch++) {
+        ScanEntry entry = ScanEntry::singleEnded(ch, ADS1X15::Gain::ONE_4096MV, ADS1X15::Rate::ADS1115_860SPS);
+        encoder.defineChannel(0x48, entry);
+    }
+    std::vector<uint8_t> stream;
+    stream.reserve(SAMPLES * 4);
+    auto flush = [&] {
+        size_t n = encoder.flush();
+        stream.insert(stream.end(), encoder.data(), encoder.data() + n);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (const Input& s : input) {
+        if (!encoder.add(s.channel, s.count, s.timestamp)) {
+            flush();
+            encoder.add(s.channel, s.count, s.timestamp);
+        }
+    }
+    flush();
+    double encodeSeconds = secondsSince(start);
+
+    ADS1X15::CaptureDecoder decoder(512);
+    ADS1X15::CapturedSample sample;
+    size_t decoded = 0;
+    bool matches   = true;
+    start          = std::chrono::steady_clock::now();
+    for (size_t pos = 0; pos < stream.size(); pos += 4096) {
+        decoder.feed(stream.data() + pos, std::min<size_t>(4096, stream.size() - pos));
+        while (decoder.next(sample)) {
+            matches = matches && sample.count == input[decoded].count && sample.timestamp == input[decoded].timestamp;
+            decoded++;
+        }
+    }
+    double decodeSeconds = secondsSince(start);
+
+    // The same samples as "address,mux,gain,rate,count,timestamp" lines.
+    size_t csvBytes = 0;
+    char line[64];
+    for (const Input& s : input) {
+        csvBytes += static_cast<size_t>(
+            std::snprintf(line, sizeof(line), "72,%u,1,7,%d,%lu\n", s.channel, s.count, (unsigned long)s.timestamp));
+    }
+
+    double bytesPerSample = static_cast<double>(stream.size()) / SAMPLES;
+    std::printf("capture: %.2f bytes/sample (CSV %.2f, %.1fx smaller), %u blocks\n", bytesPerSample,
+                static_cast<double>(csvBytes) / SAMPLES, static_cast<double>(csvBytes) / stream.size(),
+                encoder.blocks());
+    std::printf("encode %.1f Msamples/s, decode %.1f Msamples/s (%.1f MB/s of capture)\n",
+                SAMPLES / encodeSeconds / 1e6, SAMPLES / decodeSeconds / 1e6, stream.size() / decodeSeconds / 1e6);
+
+    EXPECT_EQ(decoded, SAMPLES);
+    EXPECT_TRUE(matches);
+    EXPECT_EQ(decoder.corruptBlocks(), 0u);
+    EXPECT_LT(bytesPerSample, 5.0);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
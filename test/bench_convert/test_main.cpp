@@ -0,0 +1,95 @@
+/**
+ * Benchmark for the batch count-to-volts conversions.
+ *
+ * Compares per-element computeVolts()/computeMicrovolts() calls with the batch
+ * kernels over a buffer of samples. Run with: pio test -e native_bench
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "ADS1X15.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+struct NullWire {
+    void begin() {}
+    void beginTransmission(uint8_t) {}
+    void write(uint8_t) {}
+    void endTransmission() {}
+    void requestFrom(uint8_t, uint8_t) {}
+    uint8_t read() { return 0; }
+};
+
+constexpr size_t SAMPLES = 4096;
+constexpr int ROUNDS     = 2000;
+
+template <typename F> double nanosPerSample(F&& body) {
+    body(); // warm up
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++) { body(); }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (static_cast<double>(ROUNDS) * SAMPLES);
+}
+
+std::vector<int16_t> makeCounts() {
+    std::vector<int16_t> counts(SAMPLES);
+    uint32_t x = 12345;
+    for (auto& c : counts) {
+        x = x * 1103515245u + 12345u;
+        c = static_cast<int16_t>(x >> 16);
+    }
+    return counts;
+}
+
+} // namespace
+
+TEST(BenchConvert, VoltsScalarVersusBatch) {
+    NullWire wire;
+    ADS1X15::ADS1115<NullWire> ads(wire);
+    ads.setGain(ADS1X15::Gain::ONE_4096MV);
+    std::vector<int16_t> counts = makeCounts();
+    std::vector<float> scalar(SAMPLES), batch(SAMPLES);
+
+    double scalarNs = nanosPerSample([&] {
+        for (size_t i = 0; i < SAMPLES; i++) { scalar[i] = ads.computeVolts(counts[i]); }
+        asm volatile("" : : "r"(scalar.data()) : "memory");
+    });
+    double batchNs = nanosPerSample([&] {
+        ads.computeVolts(counts.data(), batch.data(), SAMPLES);
+        asm volatile("" : : "r"(batch.data()) : "memory");
+    });
+
+    std::printf("computeVolts: scalar %.3f ns/sample, batch %.3f ns/sample (%.1fx)\n", scalarNs, batchNs,
+                scalarNs / batchNs);
+    EXPECT_EQ(scalar, batch);
+}
+
+TEST(BenchConvert, MicrovoltsScalarVersusBatch) {
+    NullWire wire;
+    ADS1X15::ADS1115<NullWire> ads(wire);
+    std::vector<int16_t> counts = makeCounts();
+    std::vector<int32_t> scalar(SAMPLES), batch(SAMPLES);
+
+    double scalarNs = nanosPerSample([&] {
+        for (size_t i = 0; i < SAMPLES; i++) { scalar[i] = ads.computeMicrovolts(counts[i]); }
+        asm volatile("" : : "r"(scalar.data()) : "memory");
+    });
+    double batchNs = nanosPerSample([&] {
+        for (size_t i = 0; i < SAMPLES; i++) { batch[i] = counts[i]; }
+        ads.computeMicrovolts(batch.data(), SAMPLES);
+        asm volatile("" : : "r"(batch.data()) : "memory");
+    });
+
+    std::printf("computeMicrovolts: scalar %.3f ns/sample, batch (incl. copy) %.3f ns/sample (%.1fx)\n", scalarNs,
+                batchNs, scalarNs / batchNs);
+    EXPECT_EQ(scalar, batch);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
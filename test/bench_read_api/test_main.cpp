@@ -0,0 +1,205 @@
+/**
+ * Bus cost benchmark for every read API.
+ *
+ * Runs each API against SimulatedWire/SimulatedDevice at 100 kHz, 400 kHz and
+ * 1 MHz and reports, per sample: I2C transactions, bytes on the wire, bus time
+ * and total virtual time, plus the achievable sample rate. Everything runs on
+ * the simulator's virtual clock, so the numbers are deterministic.
+ *
+ * Results are printed as JSON; set ADS1X15_BENCH_JSON=<path> to also write them
+ * to a file. Run with: pio test -e native_bench
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "ADS1X15.h"
+#include "ADS1X15Simulator.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+constexpr uint32_t SAMPLES     = 200;
+constexpr uint32_t BUS_SPEEDS[] = {100000, 400000, 1000000};
+
+ADS1X15::SimulatedWire* g_bus = nullptr;
+void busDelay(uint32_t micros) { g_bus->advanceMicros(micros); }
+uint32_t busMicros() { return g_bus->micros(); }
+
+struct Result {
+    std::string api;
+    std::string chip;
+    uint32_t rateSps;
+    uint32_t busHz;
+    double transactionsPerSample;
+    double bytesPerSample;
+    double busMicrosPerSample;
+    double periodMicrosPerSample;
+};
+
+std::vector<Result> g_results;
+
+struct Chip1015 {
+    using Traits = ADS1X15::ADS1015Traits;
+    template <typename W> using Driver = ADS1X15::ADS1015<W>;
+    static constexpr const char* name() { return "ADS1015"; }
+    static constexpr uint32_t sps() { return 3300; }
+    static ADS1X15::ADS1015Rate rate() { return ADS1X15::Rate::ADS1015_3300SPS; }
+};
+
+struct Chip1115 {
+    using Traits = ADS1X15::ADS1115Traits;
+    template <typename W> using Driver = ADS1X15::ADS1115<W>;
+    static constexpr const char* name() { return "ADS1115"; }
+    static constexpr uint32_t sps() { return 860; }
+    static ADS1X15::ADS1115Rate rate() { return ADS1X15::Rate::ADS1115_860SPS; }
+};
+
+// Runs setup and one warm-up sample, then sample() SAMPLES times, and records the per-sample bus cost.
+template <typename Chip, typename Setup, typename SampleFn>
+Result measure(const char* api, uint32_t busHz, Setup setup, SampleFn sample) {
+    ADS1X15::SimulatedWire bus(busHz);
+    ADS1X15::SimulatedDevice device(typename Chip::Traits{});
+    bus.attach(device);
+    device.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_0, 1.0);
+    device.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_DIFF_0_1, 0.25);
+    g_bus = &bus;
+
+    typename Chip::template Driver<ADS1X15::SimulatedWire> ads(bus);
+    ads.begin();
+    ads.setDataRate(Chip::rate());
+    ads.setDelayFunction(busDelay);
+    ads.setClockFunction(busMicros);
+    setup(ads, bus, device);
+    sample(ads, bus, device); // settle the pointer and register caches
+
+    bus.resetStats();
+    uint64_t start = bus.nanos();
+    for (uint32_t i = 0; i < SAMPLES; i++) { sample(ads, bus, device); }
+    uint64_t elapsed = bus.nanos() - start;
+
+    Result r;
+    r.api                   = api;
+    r.chip                  = Chip::name();
+    r.rateSps               = Chip::sps();
+    r.busHz                 = busHz;
+    r.transactionsPerSample = static_cast<double>(bus.transactions()) / SAMPLES;
+    r.bytesPerSample        = static_cast<double>(bus.bytes()) / SAMPLES;
+    r.busMicrosPerSample    = static_cast<double>(bus.busNanos()) / 1000.0 / SAMPLES;
+    r.periodMicrosPerSample = static_cast<double>(elapsed) / 1000.0 / SAMPLES;
+    g_results.push_back(r);
+    return r;
+}
+
+// Waits on the virtual clock for the device's next conversion, as an ALERT/RDY interrupt would.
+void waitForDataReady(ADS1X15::SimulatedWire& bus, ADS1X15::SimulatedDevice& device) {
+    uint64_t next = device.nextCompletionNanos();
+    if (next > bus.nanos()) { bus.advanceNanos(next - bus.nanos()); }
+}
+
+auto noSetup = [](auto&, ADS1X15::SimulatedWire&, ADS1X15::SimulatedDevice&) {};
+
+template <typename Chip> void runAll() {
+    for (uint32_t hz : BUS_SPEEDS) {
+        measure<Chip>("readADCSingleEnded", hz, noSetup,
+                      [](auto& ads, ADS1X15::SimulatedWire&, ADS1X15::SimulatedDevice&) { ads.readADCSingleEnded(0); });
+
+        measure<Chip>("readADCDifferential", hz, noSetup,
+                      [](auto& ads, ADS1X15::SimulatedWire&, ADS1X15::SimulatedDevice&) {
+                          ads.readADCDifferential(ADS1X15::DifferentialPair::PAIR_01);
+                      });
+
+        // Back-to-back polling: start, poll conversionComplete() until done, then read.
+        measure<Chip>("startSingleEndedReading+poll", hz, noSetup,
+                      [](auto& ads, ADS1X15::SimulatedWire&, ADS1X15::SimulatedDevice&) {
+                          ads.startSingleEndedReading(0, false);
+                          while (!ads.conversionComplete()) {}
+                          ads.getLastConversionResults();
+                      });
+
+        // Data-ready driven: one conversion-register read per sample.
+        measure<Chip>(
+            "continuous",
+            hz,
+            [](auto& ads, ADS1X15::SimulatedWire&, ADS1X15::SimulatedDevice&) {
+                ads.startSingleEndedReading(0, true);
+            },
+            [](auto& ads, ADS1X15::SimulatedWire& bus, ADS1X15::SimulatedDevice& device) {
+                waitForDataReady(bus, device);
+                ads.getLastConversionResults();
+            });
+
+        // Comparator in continuous mode: each alert is serviced by reading the conversion (clearing the latch).
+        measure<Chip>(
+            "comparator",
+            hz,
+            [](auto& ads, ADS1X15::SimulatedWire&, ADS1X15::SimulatedDevice&) {
+                ads.startComparatorSingleEnded(0, ads.computeCount(0.5f));
+            },
+            [](auto& ads, ADS1X15::SimulatedWire& bus, ADS1X15::SimulatedDevice& device) {
+                waitForDataReady(bus, device);
+                ads.getLastConversionResults();
+            });
+    }
+}
+
+std::string toJson(const std::vector<Result>& results) {
+    std::string json = "{\n  \"benchmarks\": [\n";
+    char line[512];
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        std::snprintf(line, sizeof(line),
+                      "    {\"api\": \"%s\", \"chip\": \"%s\", \"rate_sps\": %u, \"bus_hz\": %u, "
+                      "\"transactions_per_sample\": %.3f, \"bytes_per_sample\": %.3f, \"bus_us_per_sample\": %.3f, "
+                      "\"period_us_per_sample\": %.3f, \"achievable_sps\": %.1f}%s\n",
+                      r.api.c_str(), r.chip.c_str(), r.rateSps, r.busHz, r.transactionsPerSample, r.bytesPerSample,
+                      r.busMicrosPerSample, r.periodMicrosPerSample, 1e6 / r.periodMicrosPerSample,
+                      i + 1 < results.size() ? "," : "");
+        json += line;
+    }
+    json += "  ]\n}\n";
+    return json;
+}
+
+const Result& find(const char* api, const char* chip, uint32_t busHz) {
+    for (const Result& r : g_results) {
+        if (r.api == api && r.chip == chip && r.busHz == busHz) { return r; }
+    }
+    static Result none{};
+    return none;
+}
+
+} // namespace
+
+TEST(BenchReadApi, AllApis) {
+    g_results.clear();
+    runAll<Chip1015>();
+    runAll<Chip1115>();
+
+    std::string json = toJson(g_results);
+    std::fputs(json.c_str(), stdout);
+    if (const char* path = std::getenv("ADS1X15_BENCH_JSON")) {
+        if (FILE* f = std::fopen(path, "w")) {
+            std::fputs(json.c_str(), f);
+            std::fclose(f);
+        }
+    }
+
+    // Regression guards on the cached paths: a data-ready read is a single 3-byte transaction.
+    for (uint32_t hz : BUS_SPEEDS) {
+        EXPECT_DOUBLE_EQ(find("continuous", "ADS1115", hz).transactionsPerSample, 1.0);
+        EXPECT_DOUBLE_EQ(find("continuous", "ADS1115", hz).bytesPerSample, 3.0);
+        EXPECT_DOUBLE_EQ(find("comparator", "ADS1015", hz).transactionsPerSample, 1.0);
+    }
+    // Blocking reads cannot exceed the data rate, and continuous mode keeps up with it.
+    EXPECT_LE(1e6 / find("readADCSingleEnded", "ADS1115", 400000).periodMicrosPerSample, 860.0);
+    EXPECT_NEAR(1e6 / find("continuous", "ADS1115", 400000).periodMicrosPerSample, 860.0, 2.0);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -4,11 +4,34 @@
  * Uses a MockWire struct to simulate I2C without hardware.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <deque>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 #include "ADS1X15.h"
+#include "ADS1X15Acquisition.h"
+#include "ADS1X15AsyncI2C.h"
+#include "ADS1X15AutoRange.h"
+#include "ADS1X15BusLock.h"
+#include "ADS1X15Calibration.h"
+#include "ADS1X15CaptureDecoder.h"
+#include "ADS1X15DeviceGroup.h"
+#include "ADS1X15Filter.h"
+#include "ADS1X15Instrumentation.h"
+#if defined(__linux__)
+#include "ADS1X15LinuxI2C.h"
+#endif
+#include "ADS1X15SampleClock.h"
+#include "ADS1X15ScanSequencer.h"
+#include "ADS1X15Simulator.h"
+#include "ADS1X15StreamReader.h"
 #include "gtest/gtest.h"
 
 // ===========================================================================
@@ -50,11 +73,43 @@ struct MockWire {
     }
 };
 
+// MockWireRepeatedStart — adds endTransmission(bool) and buffered write(),
+// so the driver takes its repeated-start/buffered code paths.
+struct MockWireRepeatedStart : MockWire {
+    std::vector<bool> stop_flags; // sendStop argument of each endTransmission()
+    int buffered_write_count = 0;
+
+    using MockWire::write;
+    size_t write(const uint8_t* data, size_t len) {
+        ++buffered_write_count;
+        written.insert(written.end(), data, data + len);
+        return len;
+    }
+    uint8_t endTransmission(bool sendStop = true) {
+        stop_flags.push_back(sendStop);
+        ++end_transmission_count;
+        return 0;
+    }
+};
+
+// MockWireStatus — endTransmission()/requestFrom() return Arduino-style
+// status codes, so bus errors can be injected.
+struct MockWireStatus : MockWire {
+    uint8_t end_code = 0;          // returned by endTransmission()
+    uint8_t request_received = 2;  // returned by requestFrom()
+
+    uint8_t endTransmission() {
+        ++end_transmission_count;
+        return end_code;
+    }
+    uint8_t requestFrom(uint8_t /*addr*/, uint8_t /*count*/) { return request_received; }
+};
+
 // ===========================================================================
 // Section 1: computeVolts
 //
-// Formula: count * (gainToRange() / (32768 >> _bitshift))
-// ADS1015: _bitshift=4, divisor=2048. ADS1115: _bitshift=0, divisor=32768.
+// Formula: count * (gainToRange() / Chip::fullScaleCounts())
+// ADS1015: divisor=2048. ADS1115: divisor=32768.
 // Default gain: TWOTHIRDS_6144MV → range=6.144V.
 // ===========================================================================
 
@@ -103,7 +158,7 @@ TEST(ComputeVolts, ADS1115_DefaultGain_NegativeFullScale) {
 // ===========================================================================
 // Section 2: computeCount
 //
-// Formula: int16_t(volts * (32768 >> _bitshift) / gainToRange())
+// Formula: int16_t(volts * Chip::fullScaleCounts() / gainToRange())
 // ===========================================================================
 
 TEST(ComputeCount, ADS1015_DefaultGain_ZeroVolts) {
@@ -226,6 +281,8 @@ TEST(GetLastConversionResults, ADS1115_NegativeOne) {
 //                endTransmission().
 // readRegister:  beginTransmission(addr), write(reg), endTransmission(),
 //                requestFrom(addr, 2), read() << 8 | read().
+//                The pointer write is skipped when the pointer already
+//                selects reg (see Section 12).
 //
 // Tested indirectly via startSingleEndedReading (3× writeRegister) and
 // conversionComplete (1× readRegister).
@@ -385,7 +442,7 @@ TEST(ChannelGuard, ValidChannel0_ReturnsConversionResult) {
 // Section 7: Comparator threshold (startComparatorSingleEnded)
 //
 // Register write order: LOTHRESH(0x02), HITHRESH(0x03), CONFIG(0x01).
-// HITHRESH = static_cast<uint16_t>(threshold) << _bitshift.
+// HITHRESH = static_cast<uint16_t>(threshold) << Chip::shift().
 // ===========================================================================
 
 TEST(Comparator, RegisterWriteOrder_LOTHRESH_HITHRESH_CONFIG) {
@@ -455,6 +512,74 @@ TEST(Comparator, InvalidChannel_NoI2C) {
     EXPECT_TRUE(wire.written.empty());
 }
 
+TEST(Comparator, Config_DefaultsMatchStartComparatorSingleEnded) {
+    MockWire legacyWire, wire;
+    ADS1X15::ADS1115<MockWire> legacy(legacyWire), ads(wire);
+    legacy.begin();
+    ads.begin();
+    legacy.startComparatorSingleEnded(2, 1000);
+    EXPECT_EQ(ads.startComparator(ADS1X15::ComparatorConfig::singleEnded(2, -32768, 1000)), ADS1X15::Status::OK);
+    EXPECT_EQ(wire.written, legacyWire.written);
+}
+
+TEST(Comparator, Config_AllFieldsReachConfigRegister) {
+    constexpr ADS1X15::ComparatorConfig c =
+        ADS1X15::ComparatorConfig::differential(ADS1X15::DifferentialPair::PAIR_23, -100, 200)
+            .withMode(ADS1X15::ComparatorMode::WINDOW)
+            .withPolarity(ADS1X15::AlertPolarity::ACTIVE_HIGH)
+            .withLatch(false)
+            .withQueue(ADS1X15::ComparatorQueue::FOUR_CONVERSIONS);
+    static_assert(c.mux() == ADS1X15::ADS1X15_REG_CONFIG_MUX_DIFF_2_3, "mux");
+    static_assert(!c.latching(), "latch");
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    ads.begin();
+    ads.setGain(ADS1X15::Gain::FOUR_1024MV);
+    ads.setDataRate(ADS1X15::Rate::ADS1015_920SPS);
+    wire.reset();
+    EXPECT_EQ(ads.startComparator(c), ADS1X15::Status::OK);
+    ASSERT_EQ(wire.written.size(), 9u);
+    EXPECT_EQ(wire.written[1], 0xF9); // LOTHRESH: -100 << 4 = 0xF9C0
+    EXPECT_EQ(wire.written[2], 0xC0);
+    EXPECT_EQ(wire.written[4], 0x0C); // HITHRESH: 200 << 4 = 0x0C80
+    EXPECT_EQ(wire.written[5], 0x80);
+    uint16_t config = (static_cast<uint16_t>(wire.written[7]) << 8) | wire.written[8];
+    // No OS bit; DIFF_2_3 | FOUR_1024MV | continuous | 920 SPS | WINDOW | ACTVHI | NONLAT | 4CONV
+    EXPECT_EQ(config, 0x3000 | 0x0600 | 0x0000 | 0x0060 | 0x0010 | 0x0008 | 0x0000 | 0x0002);
+}
+
+TEST(Comparator, Config_UnorderedThresholds_NoI2C) {
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    ads.begin();
+    wire.reset();
+    EXPECT_EQ(ads.startComparator(ADS1X15::ComparatorConfig::singleEnded(0, 100, 100)),
+              ADS1X15::Status::INVALID_ARGUMENT);
+    // Both clamp to 2047 on the ADS1015.
+    EXPECT_EQ(ads.startComparator(ADS1X15::ComparatorConfig::singleEnded(0, 3000, 4000)),
+              ADS1X15::Status::INVALID_ARGUMENT);
+    EXPECT_EQ(ads.setComparatorThresholds(5, -5), ADS1X15::Status::INVALID_ARGUMENT);
+    EXPECT_TRUE(wire.written.empty());
+}
+
+TEST(Comparator, SetThresholds_WritesOnlyChangedRegister) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ads.startComparator(ADS1X15::ComparatorConfig::singleEnded(0, 100, 200));
+    wire.reset();
+    EXPECT_EQ(ads.setComparatorThresholds(100, 300), ADS1X15::Status::OK);
+    ASSERT_EQ(wire.written.size(), 3u);
+    EXPECT_EQ(wire.written[0], 0x03); // HITHRESH only
+    wire.reset();
+    ads.setGain(ADS1X15::Gain::ONE_4096MV);
+    EXPECT_EQ(ads.setComparatorThresholdsVolts(0.5f, 1.0f), ADS1X15::Status::OK);
+    ASSERT_EQ(wire.written.size(), 6u);
+    uint16_t lothresh = (static_cast<uint16_t>(wire.written[1]) << 8) | wire.written[2];
+    EXPECT_EQ(lothresh, ADS1X15::ADS1115<MockWire>::countToRegister(ads.computeCount(0.5f)));
+    EXPECT_NEAR(lothresh, 4000, 1); // 0.5 V / 4.096 V * 32768
+}
+
 // ===========================================================================
 // Section 8: Differential reading (startDifferentialReading)
 //
@@ -529,6 +654,2920 @@ TEST(I2CProtocol, CustomAddress_UsedInTransmissions) {
     }
 }
 
+// ===========================================================================
+// Section 11: Shadow register cache
+//
+// HITHRESH/LOTHRESH are only rewritten when the cached value differs from
+// the one required. CONFIG is always written as OS=1 starts the conversion.
+// ===========================================================================
+
+TEST(RegisterCache, SecondReading_OnlyWritesConfig) {
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    ads.begin();
+    ads.startSingleEndedReading(0, false);
+    wire.reset();
+    ads.startSingleEndedReading(1, false);
+    ASSERT_EQ(wire.written.size(), 3u);
+    EXPECT_EQ(wire.written[0], 0x01); // CONFIG
+    uint16_t config = (static_cast<uint16_t>(wire.written[1]) << 8) | wire.written[2];
+    EXPECT_EQ(config, 0xD180);
+}
+
+TEST(RegisterCache, Invalidate_RewritesThresholds) {
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    ads.begin();
+    ads.startSingleEndedReading(0, false);
+    ads.invalidateRegisterCache();
+    wire.reset();
+    ads.startSingleEndedReading(0, false);
+    EXPECT_EQ(wire.written.size(), 9u);
+}
+
+TEST(RegisterCache, Begin_InvalidatesCache) {
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    ads.begin();
+    ads.startSingleEndedReading(0, false);
+    ads.begin();
+    wire.reset();
+    ads.startSingleEndedReading(0, false);
+    EXPECT_EQ(wire.written.size(), 9u);
+}
+
+TEST(RegisterCache, Comparator_ThenReading_RestoresRdyThresholds) {
+    // The comparator changes both thresholds, so switching back to RDY mode
+    // must rewrite them.
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    ads.begin();
+    ads.startSingleEndedReading(0, false);
+    ads.startComparatorSingleEnded(0, 100);
+    wire.reset();
+    ads.startSingleEndedReading(0, false);
+    ASSERT_EQ(wire.written.size(), 9u);
+    EXPECT_EQ(wire.written[0], 0x03); // HITHRESH
+    EXPECT_EQ(wire.written[3], 0x02); // LOTHRESH
+}
+
+TEST(RegisterCache, Comparator_SameThreshold_OnlyWritesConfig) {
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    ads.begin();
+    ads.startComparatorSingleEnded(0, 100);
+    wire.reset();
+    ads.startComparatorSingleEnded(1, 100);
+    ASSERT_EQ(wire.written.size(), 3u);
+    EXPECT_EQ(wire.written[0], 0x01); // CONFIG
+}
+
+TEST(RegisterCache, Resync_ReadsBackRegisters) {
+    // After resync the chip reports RDY-mode thresholds, so no threshold
+    // writes are needed.
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    ads.begin();
+    wire.queueWord(0x8583); // CONFIG
+    wire.queueWord(0x0000); // LOTHRESH
+    wire.queueWord(0x8000); // HITHRESH
+    ads.resyncRegisterCache();
+    EXPECT_EQ(wire.written.size(), 3u); // three pointer writes
+    wire.reset();
+    ads.startSingleEndedReading(0, false);
+    EXPECT_EQ(wire.written.size(), 3u);
+}
+
+// ===========================================================================
+// Section 12: Address pointer tracking and repeated start
+//
+// Every register write moves the chip's pointer, so after starting a
+// conversion the CONFIG poll needs no pointer write. Only a change of
+// register costs a pointer write, which uses a repeated start when the
+// WIRE type supports endTransmission(false).
+// ===========================================================================
+
+TEST(PointerTracking, PollAfterStart_NoPointerWrite) {
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    ads.begin();
+    ads.startSingleEndedReading(0, false);
+    wire.reset();
+    wire.queueWord(0x8000);
+    EXPECT_TRUE(ads.conversionComplete());
+    EXPECT_TRUE(wire.written.empty());
+    EXPECT_TRUE(wire.transmitted_addrs.empty());
+}
+
+TEST(PointerTracking, ConsecutiveConversionReads_BareRead) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    wire.queueWord(0x1234);
+    wire.queueWord(0x5678);
+    EXPECT_EQ(ads.getLastConversionResults(), 0x1234);
+    ASSERT_EQ(wire.written.size(), 1u);
+    EXPECT_EQ(wire.written[0], 0x00); // CONVERSION pointer
+    EXPECT_EQ(ads.getLastConversionResults(), 0x5678);
+    EXPECT_EQ(wire.written.size(), 1u);
+}
+
+TEST(PointerTracking, RegisterChange_WritesPointer) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ads.startSingleEndedReading(0, false);
+    wire.reset();
+    wire.queueWord(0x8000);
+    wire.queueWord(0x0042);
+    EXPECT_TRUE(ads.conversionComplete());
+    EXPECT_EQ(ads.getLastConversionResults(), 0x42);
+    ASSERT_EQ(wire.written.size(), 1u);
+    EXPECT_EQ(wire.written[0], 0x00); // CONVERSION pointer
+}
+
+TEST(PointerTracking, Invalidate_RewritesPointer) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    wire.queueWord(0x0001);
+    ads.getLastConversionResults();
+    ads.invalidateRegisterCache();
+    wire.reset();
+    wire.queueWord(0x0001);
+    ads.getLastConversionResults();
+    EXPECT_EQ(wire.written.size(), 1u);
+}
+
+TEST(PointerTracking, RepeatedStart_UsedForPointerWrite) {
+    MockWireRepeatedStart wire;
+    ADS1X15::ADS1115<MockWireRepeatedStart> ads(wire);
+    ads.begin();
+    wire.queueWord(0x0001);
+    ads.getLastConversionResults();
+    ASSERT_EQ(wire.stop_flags.size(), 1u);
+    EXPECT_FALSE(wire.stop_flags[0]);
+}
+
+TEST(PointerTracking, BufferedWrite_UsedForRegisterWrite) {
+    MockWireRepeatedStart wire;
+    ADS1X15::ADS1015<MockWireRepeatedStart> ads(wire);
+    ads.begin();
+    ads.startSingleEndedReading(0, false);
+    EXPECT_EQ(wire.buffered_write_count, 3);
+    ASSERT_EQ(wire.written.size(), 9u);
+    uint16_t config = (static_cast<uint16_t>(wire.written[7]) << 8) | wire.written[8];
+    EXPECT_EQ(config, 0xC180);
+    for (bool stop : wire.stop_flags) {
+        EXPECT_TRUE(stop);
+    }
+}
+
+// ===========================================================================
+// Section 13: ScanEntry and ScanSequencer
+//
+// ScanEntry folds mux/gain/rate into a CONFIG word at compile time.
+// ScanSequencer::poll() reads CONFIG once per call while busy; on completion
+// it reads CONVERSION and writes the next entry's CONFIG.
+// ===========================================================================
+
+namespace {
+constexpr ADS1X15::ScanEntry SCAN_LIST[] = {
+    ADS1X15::ScanEntry::singleEnded(0, ADS1X15::Gain::ONE_4096MV, ADS1X15::Rate::ADS1115_860SPS),
+    ADS1X15::ScanEntry::singleEnded(3, ADS1X15::Gain::TWOTHIRDS_6144MV, ADS1X15::Rate::ADS1115_8SPS),
+    ADS1X15::ScanEntry::differential(
+        ADS1X15::DifferentialPair::PAIR_23, ADS1X15::Gain::SIXTEEN_256MV, ADS1X15::Rate::ADS1115_128SPS),
+};
+
+// Queue "busy" for one poll, then "done" and a result for the next.
+void queueConversion(MockWire& wire, uint16_t result) {
+    wire.queueWord(0x0000); // CONFIG: OS=0, busy
+    wire.queueWord(0x8000); // CONFIG: OS=1, done
+    wire.queueWord(result); // CONVERSION
+}
+} // namespace
+
+static_assert(SCAN_LIST[0].config == 0xC3E0, "ScanEntry config must be computed at compile time");
+static_assert(SCAN_LIST[2].gain() == ADS1X15::Gain::SIXTEEN_256MV, "ScanEntry gain accessor");
+
+TEST(ScanEntry, MatchesStartSingleEndedReading) {
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    ads.begin();
+    ads.setGain(ADS1X15::Gain::ONE_4096MV);
+    wire.reset();
+    ads.startSingleEndedReading(0, false);
+    uint16_t config = (static_cast<uint16_t>(wire.written[7]) << 8) | wire.written[8];
+    EXPECT_EQ(config, ADS1X15::ScanEntry::singleEnded(0, ADS1X15::Gain::ONE_4096MV, ADS1X15::Rate::ADS1015_1600SPS)
+                          .config);
+}
+
+TEST(ScanSequencer, StartWritesFirstEntry) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<MockWire>, 3> scan(ads, SCAN_LIST);
+    wire.reset();
+    scan.start();
+    ASSERT_EQ(wire.written.size(), 9u);
+    uint16_t config = (static_cast<uint16_t>(wire.written[7]) << 8) | wire.written[8];
+    EXPECT_EQ(config, SCAN_LIST[0].config);
+}
+
+TEST(ScanSequencer, PollWhileBusy_DoesNotAdvance) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<MockWire>, 3> scan(ads, SCAN_LIST);
+    scan.start();
+    wire.reset();
+    wire.queueWord(0x0000);
+    EXPECT_FALSE(scan.poll());
+    EXPECT_TRUE(wire.written.empty()); // CONFIG poll needs no pointer write
+    EXPECT_EQ(scan.frameCount(), 0u);
+}
+
+TEST(ScanSequencer, FullPass_PublishesFrame) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<MockWire>, 3> scan(ads, SCAN_LIST);
+    scan.start();
+    queueConversion(wire, 100);
+    queueConversion(wire, 200);
+    queueConversion(wire, static_cast<uint16_t>(-300));
+    int completed = 0;
+    for (int i = 0; i < 6; ++i) {
+        if (scan.poll()) { ++completed; }
+        EXPECT_EQ(completed, i == 5 ? 1 : 0);
+    }
+    EXPECT_EQ(scan.frameCount(), 1u);
+    EXPECT_EQ(scan.result(0), 100);
+    EXPECT_EQ(scan.result(1), 200);
+    EXPECT_EQ(scan.result(2), -300);
+    EXPECT_FLOAT_EQ(scan.resultVolts(0), 100 * 4.096f / 32768);
+    EXPECT_FLOAT_EQ(scan.resultVolts(2), -300 * 0.256f / 32768);
+}
+
+TEST(ScanSequencer, SteadyState_OneConfigWritePerConversion) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<MockWire>, 3> scan(ads, SCAN_LIST);
+    scan.start();
+    wire.reset();
+    wire.queueWord(0x8000); // CONFIG: done
+    wire.queueWord(0x0001); // CONVERSION
+    scan.poll();
+    // Pointer write for CONVERSION, then a 3-byte CONFIG write for entry 1.
+    ASSERT_EQ(wire.written.size(), 4u);
+    EXPECT_EQ(wire.written[0], 0x00);
+    EXPECT_EQ(wire.written[1], 0x01);
+    uint16_t config = (static_cast<uint16_t>(wire.written[2]) << 8) | wire.written[3];
+    EXPECT_EQ(config, SCAN_LIST[1].config);
+}
+
+TEST(ScanSequencer, FrameStableDuringNextPass) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<MockWire>, 3> scan(ads, SCAN_LIST);
+    scan.start();
+    for (uint16_t v : {1, 2, 3, 4}) {
+        wire.queueWord(0x8000);
+        wire.queueWord(v);
+    }
+    for (int i = 0; i < 4; ++i) {
+        scan.poll();
+    }
+    // Fourth conversion belongs to the second pass; the first frame is intact.
+    EXPECT_EQ(scan.frameCount(), 1u);
+    EXPECT_EQ(scan.result(0), 1);
+    EXPECT_EQ(scan.result(1), 2);
+    EXPECT_EQ(scan.result(2), 3);
+}
+
+TEST(ScanSequencer, BusError_NothingPublished) {
+    // An absent chip reads 0xFFFF, whose OS bit looks like a finished conversion.
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> ads(wire);
+    ads.begin();
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<MockWireStatus>, 3> scan(ads, SCAN_LIST);
+    scan.start();
+    wire.request_received = 0;
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_FALSE(scan.poll());
+    }
+    EXPECT_EQ(scan.frameCount(), 0u);
+    EXPECT_EQ(scan.status(), ADS1X15::Status::SHORT_READ);
+    EXPECT_EQ(scan.busErrors(), 6u);
+}
+
+TEST(ScanSequencer, FailedRead_RetriedOnNextPoll) {
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> ads(wire);
+    ads.begin();
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<MockWireStatus>, 3> scan(ads, SCAN_LIST);
+    scan.start();
+    wire.queueWord(0x8000);
+    wire.end_code = 2; // the CONVERSION pointer write is NAKed
+    EXPECT_FALSE(scan.poll());
+    EXPECT_EQ(scan.status(), ADS1X15::Status::NAK);
+    wire.end_code = 0;
+    for (uint16_t v : {0x42, 2, 3}) {
+        wire.queueWord(0x8000);
+        wire.queueWord(v);
+    }
+    EXPECT_FALSE(scan.poll());
+    EXPECT_FALSE(scan.poll());
+    EXPECT_TRUE(scan.poll());
+    EXPECT_EQ(scan.status(), ADS1X15::Status::OK);
+    EXPECT_EQ(scan.result(0), 0x42);
+    EXPECT_EQ(scan.result(2), 3);
+}
+
+TEST(ScanSequencer, FailedStart_ReissuedByPoll) {
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> ads(wire);
+    ads.begin();
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<MockWireStatus>, 3> scan(ads, SCAN_LIST);
+    wire.end_code = 2;
+    scan.start();
+    EXPECT_EQ(scan.status(), ADS1X15::Status::NAK);
+    wire.end_code = 0;
+    wire.reset();
+    wire.queueWord(0x8000); // stale "done" from before the failed start
+    EXPECT_FALSE(scan.poll());
+    EXPECT_EQ(wire.read_queue.size(), 2u); // not polled
+    ASSERT_GE(wire.written.size(), 3u);
+    size_t n        = wire.written.size();
+    uint16_t config = (static_cast<uint16_t>(wire.written[n - 2]) << 8) | wire.written[n - 1];
+    EXPECT_EQ(config, SCAN_LIST[0].config);
+    EXPECT_EQ(scan.status(), ADS1X15::Status::OK);
+}
+
+TEST(ScanSequencer, Stopped_PollDoesNothing) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<MockWire>, 3> scan(ads, SCAN_LIST);
+    wire.reset();
+    EXPECT_FALSE(scan.poll());
+    EXPECT_TRUE(wire.transmitted_addrs.empty());
+    EXPECT_FALSE(scan.running());
+}
+
+// ===========================================================================
+// Section 14: Conversion-time-aware waiting
+//
+// With a delay function set, blocking reads sleep for the minimum
+// conversion time (nominal period / 1.1), then poll with a back-off that
+// starts at period / 64 and doubles up to period / 4.
+// ===========================================================================
+
+namespace {
+std::vector<uint32_t> g_delays;
+void recordDelay(uint32_t micros) { g_delays.push_back(micros); }
+} // namespace
+
+static_assert(ADS1X15::conversionPeriodMicros(ADS1X15::Rate::ADS1115_8SPS) == 125000, "ADS1115 8 SPS");
+static_assert(ADS1X15::conversionPeriodMicros(ADS1X15::Rate::ADS1015_3300SPS) == 303, "ADS1015 3300 SPS");
+static_assert(ADS1X15::conversionTimeMinMicros(ADS1X15::Rate::ADS1115_8SPS) == 113636, "-10% tolerance");
+static_assert(ADS1X15::conversionTimeMaxMicros(ADS1X15::Rate::ADS1115_8SPS) == 138913, "+10% tolerance");
+
+TEST(WaitStrategy, ConversionPeriod_DependsOnChip) {
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads1015(wire);
+    ADS1X15::ADS1115<MockWire> ads1115(wire);
+    ads1015.setDataRate(ADS1X15::Rate::ADS1015_128SPS);
+    ads1115.setDataRate(ADS1X15::Rate::ADS1115_8SPS); // same DR bits
+    EXPECT_EQ(ads1015.getConversionPeriodMicros(), 7813u);
+    EXPECT_EQ(ads1115.getConversionPeriodMicros(), 125000u);
+}
+
+TEST(WaitStrategy, DelayFunction_SleepsThenBacksOff) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ads.setDataRate(ADS1X15::Rate::ADS1115_8SPS);
+    ads.setDelayFunction(recordDelay);
+    g_delays.clear();
+    wire.queueWord(0x0000); // busy
+    wire.queueWord(0x0000); // busy
+    wire.queueWord(0x8000); // done
+    wire.queueWord(0x1234); // CONVERSION
+    EXPECT_EQ(ads.readADCSingleEnded(0), 0x1234);
+    std::vector<uint32_t> expected = {113636, 1953, 3906};
+    EXPECT_EQ(g_delays, expected);
+}
+
+TEST(WaitStrategy, DelayFunction_BackoffCapped) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ads.setDataRate(ADS1X15::Rate::ADS1115_8SPS);
+    ads.setDelayFunction(recordDelay);
+    g_delays.clear();
+    for (int i = 0; i < 8; ++i) {
+        wire.queueWord(0x0000);
+    }
+    wire.queueWord(0x8000);
+    wire.queueWord(0x0001);
+    ads.readADCDifferential(ADS1X15::DifferentialPair::PAIR_01);
+    ASSERT_EQ(g_delays.size(), 9u);
+    for (size_t i = 1; i < g_delays.size(); ++i) {
+        EXPECT_LE(g_delays[i], 2u * 125000u / 4u);
+    }
+}
+
+TEST(WaitStrategy, DelayFunction_ShortPeriod_MinimumBackoff) {
+    // ADS1015 3300 SPS: period/64 = 4us, raised to the 20us floor.
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    ads.begin();
+    ads.setDataRate(ADS1X15::Rate::ADS1015_3300SPS);
+    ads.setDelayFunction(recordDelay);
+    g_delays.clear();
+    wire.queueWord(0x0000);
+    wire.queueWord(0x8000);
+    wire.queueWord(0x0010);
+    EXPECT_EQ(ads.readADCSingleEnded(1), 1);
+    std::vector<uint32_t> expected = {275, 20};
+    EXPECT_EQ(g_delays, expected);
+}
+
+TEST(WaitStrategy, DelayFunction_UsesRateOfStartedConversion) {
+    // The scan entry's 860 SPS sets the timing, not the driver's 8 SPS.
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ads.setDataRate(ADS1X15::Rate::ADS1115_8SPS);
+    ads.setDelayFunction(recordDelay);
+    g_delays.clear();
+    wire.queueWord(0x0000); // busy
+    wire.queueWord(0x8000); // done
+    ads.startReading(ADS1X15::ScanEntry::singleEnded(0, ADS1X15::Gain::ONE_4096MV, ADS1X15::Rate::ADS1115_860SPS));
+    ads.waitForConversion();
+    std::vector<uint32_t> expected = {ADS1X15::conversionTimeMinMicros(ADS1X15::Rate::ADS1115_860SPS), 20};
+    EXPECT_EQ(g_delays, expected);
+}
+
+// ===========================================================================
+// Section 15: Bounded reads (tryRead*)
+//
+// Bus errors from endTransmission()/requestFrom() are reported, and a
+// conversion that never completes returns TIMEOUT instead of hanging.
+// ===========================================================================
+
+namespace {
+uint32_t g_fakeMicros = 0;
+uint32_t fakeClock() { return g_fakeMicros += 1000; } // each call advances 1ms
+} // namespace
+
+TEST(TryRead, Success_ReturnsValue) {
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> ads(wire);
+    ads.begin();
+    wire.queueWord(0x0000); // busy
+    wire.queueWord(0x8000); // done
+    wire.queueWord(0x1234);
+    ADS1X15::ReadResult r = ads.tryReadADCSingleEnded(2, 1000000);
+    EXPECT_TRUE(r.ok());
+    EXPECT_EQ(r.value, 0x1234);
+}
+
+TEST(TryRead, InvalidChannel_NoI2C) {
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> ads(wire);
+    ads.begin();
+    wire.reset();
+    ADS1X15::ReadResult r = ads.tryReadADCSingleEnded(4, 1000);
+    EXPECT_EQ(r.status, ADS1X15::Status::INVALID_ARGUMENT);
+    EXPECT_TRUE(wire.transmitted_addrs.empty());
+}
+
+TEST(TryRead, AddressNak_StopsAtFirstWrite) {
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> ads(wire);
+    ads.begin();
+    wire.reset();
+    wire.end_code = 2; // NAK on address
+    ADS1X15::ReadResult r = ads.tryReadADCDifferential(ADS1X15::DifferentialPair::PAIR_01, 1000);
+    EXPECT_EQ(r.status, ADS1X15::Status::NAK);
+    EXPECT_EQ(r.value, 0);
+    EXPECT_EQ(wire.transmitted_addrs.size(), 1u);
+}
+
+TEST(TryRead, FailedWrite_InvalidatesCache) {
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> ads(wire);
+    ads.begin();
+    ads.startSingleEndedReading(0, false);
+    wire.end_code = 3; // NAK on data
+    ads.startSingleEndedReading(0, false);
+    wire.end_code = 0;
+    wire.reset();
+    // CONFIG write failed, so its shadow and the pointer are unknown; the
+    // thresholds were untouched and stay cached.
+    ads.startSingleEndedReading(0, false);
+    EXPECT_EQ(wire.written.size(), 3u);
+    wire.queueWord(0x8000);
+    ads.conversionComplete();
+    EXPECT_EQ(wire.written.size(), 3u); // pointer known again after the write
+}
+
+TEST(TryRead, ShortRead_Reported) {
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> ads(wire);
+    ads.begin();
+    wire.request_received = 0;
+    ADS1X15::ReadResult r = ads.tryReadADCSingleEnded(0, 1000);
+    EXPECT_EQ(r.status, ADS1X15::Status::SHORT_READ);
+}
+
+TEST(TryRead, BusTimeoutCode_MapsToTimeout) {
+    EXPECT_EQ(ADS1X15::statusFromEndTransmission(0), ADS1X15::Status::OK);
+    EXPECT_EQ(ADS1X15::statusFromEndTransmission(2), ADS1X15::Status::NAK);
+    EXPECT_EQ(ADS1X15::statusFromEndTransmission(3), ADS1X15::Status::NAK);
+    EXPECT_EQ(ADS1X15::statusFromEndTransmission(4), ADS1X15::Status::BUS_ERROR);
+    EXPECT_EQ(ADS1X15::statusFromEndTransmission(5), ADS1X15::Status::TIMEOUT);
+}
+
+TEST(TryRead, NeverCompletes_TimesOutWithClock) {
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> ads(wire);
+    ads.begin();
+    ads.setClockFunction(fakeClock);
+    for (int i = 0; i < 100; ++i) {
+        wire.queueWord(0x0000); // always busy
+    }
+    ADS1X15::ReadResult r = ads.tryReadADCSingleEnded(0, 5000);
+    EXPECT_EQ(r.status, ADS1X15::Status::TIMEOUT);
+    // 5 polls at 1ms per clock call.
+    EXPECT_EQ(wire.read_queue.size(), 2u * 95u);
+}
+
+TEST(TryRead, NeverCompletes_TimesOutWithoutClock) {
+    // Without a clock each poll is assumed to cost ADS1X15_POLL_ESTIMATE_US.
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> ads(wire);
+    ads.begin();
+    for (int i = 0; i < 100; ++i) {
+        wire.queueWord(0x0000);
+    }
+    ADS1X15::ReadResult r = ads.tryReadADCSingleEnded(0, 10 * ADS1X15::ADS1X15_POLL_ESTIMATE_US);
+    EXPECT_EQ(r.status, ADS1X15::Status::TIMEOUT);
+    EXPECT_EQ(wire.read_queue.size(), 2u * 90u);
+}
+
+TEST(TryRead, WaitForConversion_CountsDelays) {
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> ads(wire);
+    ads.begin();
+    ads.setDataRate(ADS1X15::Rate::ADS1115_8SPS);
+    ads.setDelayFunction(recordDelay);
+    g_delays.clear();
+    for (int i = 0; i < 100; ++i) {
+        wire.queueWord(0x0000);
+    }
+    ads.startSingleEndedReading(0, false);
+    // 113636us minimum wait, then each poll adds 100us and each back-off its
+    // own length. The last back-off is cut short at the deadline.
+    EXPECT_EQ(ads.tryWaitForConversion(120000), ADS1X15::Status::TIMEOUT);
+    std::vector<uint32_t> expected = {113636, 1953, 3906, 205};
+    EXPECT_EQ(g_delays, expected);
+}
+
+TEST(TryRead, WaitForConversion_ShortDeadline_ClampsFirstSleep) {
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> ads(wire);
+    ads.begin();
+    ads.setDataRate(ADS1X15::Rate::ADS1115_8SPS);
+    ads.setDelayFunction(recordDelay);
+    g_delays.clear();
+    for (int i = 0; i < 10; ++i) {
+        wire.queueWord(0x0000);
+    }
+    ads.startSingleEndedReading(0, false);
+    EXPECT_EQ(ads.tryWaitForConversion(100), ADS1X15::Status::TIMEOUT);
+    std::vector<uint32_t> expected = {100};
+    EXPECT_EQ(g_delays, expected);
+}
+
+// ===========================================================================
+// Section 16: SpscRingBuffer and StreamReader
+//
+// The ring buffer is lock-free for one producer and one consumer; the
+// threaded tests drive the producer from a separate std::thread.
+// ===========================================================================
+
+TEST(SpscRingBuffer, PushPopFifo) {
+    ADS1X15::SpscRingBuffer<int, 4> ring;
+    EXPECT_TRUE(ring.empty());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.push(i));
+    }
+    EXPECT_FALSE(ring.push(99)); // full
+    EXPECT_EQ(ring.size(), 4u);
+    int v = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.pop(v));
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_FALSE(ring.pop(v));
+}
+
+TEST(SpscRingBuffer, DrainWrapsAround) {
+    ADS1X15::SpscRingBuffer<int, 4> ring;
+    int out[8];
+    for (int round = 0; round < 5; ++round) {
+        ring.push(round * 10);
+        ring.push(round * 10 + 1);
+        ring.push(round * 10 + 2);
+        ASSERT_EQ(ring.drain(out, 2), 2u);
+        EXPECT_EQ(out[0], round * 10);
+        EXPECT_EQ(out[1], round * 10 + 1);
+        ASSERT_EQ(ring.drain(out, 8), 1u);
+        EXPECT_EQ(out[0], round * 10 + 2);
+    }
+}
+
+TEST(SpscRingBuffer, ThreadedProducer_NoLossNoReorder) {
+    constexpr int COUNT = 100000;
+    ADS1X15::SpscRingBuffer<int, 64> ring;
+    std::thread producer([&ring] {
+        for (int i = 0; i < COUNT; ++i) {
+            while (!ring.push(i)) { std::this_thread::yield(); }
+        }
+    });
+    int expected = 0;
+    int out[16];
+    while (expected < COUNT) {
+        size_t n = ring.drain(out, 16);
+        if (n == 0) { std::this_thread::yield(); }
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(out[i], expected++);
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(StreamReader, Start_ContinuousDataReadyConfig) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ADS1X15::StreamReader<ADS1X15::ADS1115<MockWire>, 16> reader(ads);
+    wire.reset();
+    reader.start(1);
+    ASSERT_EQ(wire.written.size(), 9u);
+    EXPECT_EQ(wire.written[1], 0x80); // HITHRESH MSB: RDY mode
+    uint16_t config = (static_cast<uint16_t>(wire.written[7]) << 8) | wire.written[8];
+    EXPECT_EQ(config & ADS1X15::ADS1X15_REG_CONFIG_MODE_MASK, ADS1X15::ADS1X15_REG_CONFIG_MODE_CONTIN);
+    EXPECT_EQ(config & ADS1X15::ADS1X15_REG_CONFIG_MUX_MASK, ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_1);
+}
+
+TEST(StreamReader, StartScanEntry_ForcesContinuous) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ADS1X15::StreamReader<ADS1X15::ADS1115<MockWire>, 16> reader(ads);
+    wire.reset();
+    reader.start(SCAN_LIST[0]);
+    uint16_t config = (static_cast<uint16_t>(wire.written[7]) << 8) | wire.written[8];
+    EXPECT_EQ(config, SCAN_LIST[0].config & ~ADS1X15::ADS1X15_REG_CONFIG_MODE_MASK);
+}
+
+TEST(StreamReader, DataReady_BuffersTimestampedSamples) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ADS1X15::StreamReader<ADS1X15::ADS1115<MockWire>, 4> reader(ads);
+    reader.start(0);
+    wire.queueWord(0x0010);
+    wire.queueWord(0x0020);
+    EXPECT_TRUE(reader.onDataReady(1000));
+    EXPECT_TRUE(reader.onDataReady(2000));
+    ADS1X15::Sample out[4];
+    ASSERT_EQ(reader.drain(out, 4), 2u);
+    EXPECT_EQ(out[0].timestamp, 1000u);
+    EXPECT_EQ(out[0].value, 0x10);
+    EXPECT_EQ(out[1].timestamp, 2000u);
+    EXPECT_EQ(out[1].value, 0x20);
+}
+
+TEST(StreamReader, FullBuffer_CountsOverruns) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ADS1X15::StreamReader<ADS1X15::ADS1115<MockWire>, 4> reader(ads);
+    reader.start(0);
+    for (int i = 0; i < 6; ++i) {
+        wire.queueWord(static_cast<uint16_t>(i));
+        reader.onDataReady(static_cast<uint32_t>(i));
+    }
+    EXPECT_EQ(reader.available(), 4u);
+    EXPECT_EQ(reader.overruns(), 2u);
+    ADS1X15::Sample sample;
+    ASSERT_TRUE(reader.pop(sample));
+    EXPECT_EQ(sample.value, 0); // oldest samples are kept
+}
+
+TEST(StreamReader, BusError_CountsReadErrors) {
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> ads(wire);
+    ads.begin();
+    ADS1X15::StreamReader<ADS1X15::ADS1115<MockWireStatus>, 4> reader(ads);
+    reader.start(0);
+    wire.request_received = 0;
+    EXPECT_FALSE(reader.onDataReady(0));
+    EXPECT_EQ(reader.readErrors(), 1u);
+    EXPECT_EQ(reader.available(), 0u);
+}
+
+TEST(StreamReader, ThreadedProducer_ConsumerDrainsEverything) {
+    // The producer thread stands in for the ALERT/RDY ISR.
+    constexpr int COUNT = 50000;
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.begin();
+    ADS1X15::StreamReader<ADS1X15::ADS1115<MockWire>, 32> reader(ads);
+    reader.start(0);
+    for (int i = 0; i < COUNT; ++i) {
+        wire.queueWord(static_cast<uint16_t>(i));
+    }
+    std::thread producer([&reader] {
+        for (int i = 0; i < COUNT; ++i) {
+            while (reader.available() == reader.capacity()) { std::this_thread::yield(); }
+            reader.onDataReady(static_cast<uint32_t>(i));
+        }
+    });
+    int expected = 0;
+    ADS1X15::Sample out[8];
+    while (expected < COUNT) {
+        size_t n = reader.drain(out, 8);
+        if (n == 0) { std::this_thread::yield(); }
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(out[i].value, static_cast<int16_t>(expected));
+            ASSERT_EQ(out[i].timestamp, static_cast<uint32_t>(expected));
+            ++expected;
+        }
+    }
+    producer.join();
+    EXPECT_EQ(reader.overruns(), 0u);
+}
+
+// ===========================================================================
+// Section 17: DeviceGroup
+//
+// All devices share one MockWire, so queued words are consumed in the order
+// the group polls them: device 0 first, then device 1, and so on.
+// ===========================================================================
+
+TEST(DeviceGroup, Start_WritesEachDeviceBackToBack) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> a(wire), b(wire);
+    a.begin(0x48);
+    b.begin(0x49);
+    ADS1X15::ADS1115<MockWire>* devices[] = {&a, &b};
+    ADS1X15::DeviceGroup<ADS1X15::ADS1115<MockWire>, 2> group(devices);
+    a.startSingleEndedReading(0, false); // warm the threshold caches
+    b.startSingleEndedReading(0, false);
+    wire.reset();
+    group.start(SCAN_LIST[0]);
+    ASSERT_EQ(wire.transmitted_addrs.size(), 2u);
+    EXPECT_EQ(wire.transmitted_addrs[0], 0x48);
+    EXPECT_EQ(wire.transmitted_addrs[1], 0x49);
+}
+
+TEST(DeviceGroup, Poll_CollectsInCompletionOrder) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> a(wire), b(wire), c(wire);
+    a.begin(0x48);
+    b.begin(0x49);
+    c.begin(0x4A);
+    ADS1X15::ADS1115<MockWire>* devices[] = {&a, &b, &c};
+    ADS1X15::DeviceGroup<ADS1X15::ADS1115<MockWire>, 3> group(devices);
+    EXPECT_FALSE(group.poll()); // nothing started
+    group.start(SCAN_LIST);
+
+    // Pass 1: a busy, b done, c busy.
+    wire.queueWord(0x0000);
+    wire.queueWord(0x8000);
+    wire.queueWord(0x00BB);
+    wire.queueWord(0x0000);
+    EXPECT_FALSE(group.poll());
+    // Pass 2: a busy, c done.
+    wire.queueWord(0x0000);
+    wire.queueWord(0x8000);
+    wire.queueWord(0x00CC);
+    EXPECT_FALSE(group.poll());
+    // Pass 3: a done.
+    wire.queueWord(0x8000);
+    wire.queueWord(0x00AA);
+    EXPECT_TRUE(group.poll());
+    EXPECT_TRUE(group.complete());
+    EXPECT_FALSE(group.poll()); // completion reported once
+
+    EXPECT_EQ(group.result(0), 0xAA);
+    EXPECT_EQ(group.result(1), 0xBB);
+    EXPECT_EQ(group.result(2), 0xCC);
+    EXPECT_EQ(group.completionOrder(0), 1);
+    EXPECT_EQ(group.completionOrder(1), 2);
+    EXPECT_EQ(group.completionOrder(2), 0);
+}
+
+TEST(DeviceGroup, Skew_MeasuredWithClock) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> a(wire), b(wire);
+    a.begin(0x48);
+    b.begin(0x49);
+    ADS1X15::ADS1115<MockWire>* devices[] = {&a, &b};
+    ADS1X15::DeviceGroup<ADS1X15::ADS1115<MockWire>, 2> group(devices);
+    group.setClockFunction(fakeClock); // +1000us per call
+    group.start(SCAN_LIST[0]);
+    wire.queueWord(0x8000);
+    wire.queueWord(0x0001);
+    wire.queueWord(0x8000);
+    wire.queueWord(0x0002);
+    EXPECT_TRUE(group.poll());
+    EXPECT_EQ(group.startSkewMicros(), 1000u);
+    EXPECT_EQ(group.completionSkewMicros(), 1000u);
+    EXPECT_EQ(group.completionMicros(0), 2000u);
+}
+
+TEST(DeviceGroup, FailedDevice_CompletesWithError) {
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> a(wire), b(wire);
+    a.begin(0x48);
+    b.begin(0x49);
+    ADS1X15::ADS1115<MockWireStatus>* devices[] = {&a, &b};
+    ADS1X15::DeviceGroup<ADS1X15::ADS1115<MockWireStatus>, 2> group(devices);
+    group.start(SCAN_LIST[0]);
+    wire.request_received = 0; // no device answers
+    EXPECT_TRUE(group.poll());
+    EXPECT_EQ(group.status(0), ADS1X15::Status::SHORT_READ);
+    EXPECT_EQ(group.status(1), ADS1X15::Status::SHORT_READ);
+}
+
+TEST(DeviceGroup, FailedStart_CompletesWithoutPolling) {
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> a(wire), b(wire);
+    a.begin(0x48);
+    b.begin(0x49);
+    ADS1X15::ADS1115<MockWireStatus>* devices[] = {&a, &b};
+    ADS1X15::DeviceGroup<ADS1X15::ADS1115<MockWireStatus>, 2> group(devices);
+    wire.end_code = 2; // NAK
+    group.start(SCAN_LIST[0]);
+    EXPECT_TRUE(group.complete());
+    EXPECT_EQ(group.status(0), ADS1X15::Status::NAK);
+    EXPECT_EQ(group.status(1), ADS1X15::Status::NAK);
+    wire.end_code = 0;
+    wire.queueWord(0x8000); // a stale "done" must not be read as a result
+    wire.queueWord(0x1234);
+    EXPECT_FALSE(group.poll());
+    EXPECT_EQ(wire.read_queue.size(), 4u);
+    EXPECT_EQ(group.result(0), 0);
+}
+
+// ===========================================================================
+// Section 18: Chip traits
+//
+// Resolution, count range and rate type are compile-time properties of the
+// chip. A rate for the wrong chip does not convert and so fails to compile.
+// ===========================================================================
+
+static_assert(ADS1X15::ADS1015Traits::shift() == 4, "ADS1015 shift");
+static_assert(ADS1X15::ADS1115Traits::shift() == 0, "ADS1115 shift");
+static_assert(ADS1X15::ADS1015Traits::countMax() == 2047, "ADS1015 max");
+static_assert(ADS1X15::ADS1015Traits::countMin() == -2048, "ADS1015 min");
+static_assert(ADS1X15::ADS1115Traits::countMax() == 32767, "ADS1115 max");
+static_assert(ADS1X15::ADS1115Traits::countMin() == -32768, "ADS1115 min");
+static_assert(!std::is_convertible<ADS1X15::ADS1015Rate, ADS1X15::ADS1115Rate>::value, "rates are chip-typed");
+static_assert(!std::is_convertible<ADS1X15::ADS1115Rate, ADS1X15::ADS1015Rate>::value, "rates are chip-typed");
+static_assert(ADS1X15::ScanEntry::singleEnded(0, ADS1X15::Gain::ONE_4096MV, ADS1X15::Rate::ADS1115_860SPS)
+                      .rate<ADS1X15::ADS1115Traits>() == ADS1X15::Rate::ADS1115_860SPS,
+              "scan entry round-trips its rate");
+
+TEST(ChipTraits, GetDataRate_ReturnsChipTypedRate) {
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    ads.setDataRate(ADS1X15::Rate::ADS1015_3300SPS);
+    ADS1X15::ADS1015Rate rate = ads.getDataRate();
+    EXPECT_EQ(rate, ADS1X15::Rate::ADS1015_3300SPS);
+    EXPECT_NE(rate, ADS1X15::Rate::ADS1015_128SPS);
+}
+
+TEST(ChipTraits, ADS1015_ComputeCount_ClampsTo12Bits) {
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    EXPECT_EQ(ads.computeCount(100.0f), 2047);
+    EXPECT_EQ(ads.computeCount(-100.0f), -2048);
+}
+
+TEST(ChipTraits, ADS1015_RawToCount_EveryCodeRoundTrips) {
+    for (int32_t count = -2048; count <= 2047; count++) {
+        uint16_t raw = static_cast<uint16_t>(count) << 4;
+        ASSERT_EQ(ADS1X15::ADS1015<MockWire>::rawToCount(raw), count);
+        ASSERT_EQ(ADS1X15::ADS1015<MockWire>::countToRegister(static_cast<int16_t>(count)), raw);
+    }
+}
+
+// ===========================================================================
+// Section 19: Integer voltage conversion
+//
+// computeMicrovolts/computeMillivolts are checked against an exact double
+// reference (rounded half away from zero) and against the float path, for
+// every gain and every count of both chips.
+// ===========================================================================
+
+namespace {
+const ADS1X15::Gain ALL_GAINS[] = {ADS1X15::Gain::TWOTHIRDS_6144MV, ADS1X15::Gain::ONE_4096MV,
+                                   ADS1X15::Gain::TWO_2048MV,       ADS1X15::Gain::FOUR_1024MV,
+                                   ADS1X15::Gain::EIGHT_512MV,      ADS1X15::Gain::SIXTEEN_256MV};
+const double RANGE_UV[] = {6144000.0, 4096000.0, 2048000.0, 1024000.0, 512000.0, 256000.0};
+
+template <typename ADS> void checkIntegerConversion(ADS& ads, int32_t fullScale) {
+    using Traits = typename ADS::Traits;
+    for (size_t g = 0; g < 6; g++) {
+        ads.setGain(ALL_GAINS[g]);
+        for (int32_t c = Traits::countMin(); c <= Traits::countMax(); c++) {
+            int16_t count   = static_cast<int16_t>(c);
+            double exact_uv = c * RANGE_UV[g] / fullScale;
+            int32_t uv      = ads.computeMicrovolts(count);
+            ASSERT_EQ(uv, std::llround(exact_uv)) << "gain " << g << " count " << c;
+            ASSERT_EQ(ads.computeMillivolts(count), std::llround(exact_uv / 1000.0)) << "gain " << g << " count " << c;
+            ASSERT_NEAR(uv, ads.computeVolts(count) * 1e6, 1.0) << "gain " << g << " count " << c;
+            ASSERT_EQ(ads.computeCountMicrovolts(uv), count) << "gain " << g << " count " << c;
+        }
+    }
+}
+} // namespace
+
+static_assert(ADS1X15::microvoltsPerLsbQ4<ADS1X15::ADS1115Traits>(ADS1X15::Gain::TWOTHIRDS_6144MV) == 3000,
+              "187.5 uV");
+static_assert(ADS1X15::microvoltsPerLsbQ4<ADS1X15::ADS1115Traits>(ADS1X15::Gain::SIXTEEN_256MV) == 125,
+              "7.8125 uV");
+static_assert(ADS1X15::microvoltsPerLsbQ4<ADS1X15::ADS1015Traits>(ADS1X15::Gain::TWOTHIRDS_6144MV) == 48000,
+              "3 mV");
+
+TEST(IntegerConversion, ADS1015_EveryGainEveryCount) {
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    checkIntegerConversion(ads, 2048);
+}
+
+TEST(IntegerConversion, ADS1115_EveryGainEveryCount) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    checkIntegerConversion(ads, 32768);
+}
+
+TEST(IntegerConversion, HalfMicrovoltRoundsAwayFromZero) {
+    // 187.5 uV per count at +/-6.144 V.
+    EXPECT_EQ(ADS1X15::ADS1115<MockWire>::computeMicrovolts(1, ADS1X15::Gain::TWOTHIRDS_6144MV), 188);
+    EXPECT_EQ(ADS1X15::ADS1115<MockWire>::computeMicrovolts(-1, ADS1X15::Gain::TWOTHIRDS_6144MV), -188);
+}
+
+TEST(IntegerConversion, ComputeCountMicrovolts_MatchesFloatAndClamps) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    ads.setGain(ADS1X15::Gain::ONE_4096MV);
+    for (int32_t uv = -4200000; uv <= 4200000; uv += 997) {
+        EXPECT_NEAR(ads.computeCountMicrovolts(uv), ads.computeCount(uv / 1e6f), 1) << uv;
+    }
+    EXPECT_EQ(ads.computeCountMicrovolts(INT32_MAX), 32767);
+    EXPECT_EQ(ads.computeCountMicrovolts(INT32_MIN), -32768);
+}
+
+// ===========================================================================
+// Section 20: Batch conversion
+//
+// The batch kernels must give bit-identical results to the scalar calls,
+// including the SIMD body and the scalar tail (odd lengths).
+// ===========================================================================
+
+TEST(BatchConversion, Volts_MatchesScalarForEveryCount) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    std::vector<int16_t> counts;
+    for (int32_t c = -32768; c <= 32767; c++) { counts.push_back(static_cast<int16_t>(c)); }
+    counts.push_back(5); // odd length exercises the tail loop
+    std::vector<float> volts(counts.size());
+    for (ADS1X15::Gain gain : ALL_GAINS) {
+        ads.computeVolts(counts.data(), volts.data(), counts.size(), gain);
+        for (size_t i = 0; i < counts.size(); i++) {
+            ASSERT_EQ(volts[i], ads.computeVolts(counts[i], gain)) << counts[i];
+        }
+    }
+}
+
+TEST(BatchConversion, Volts_UsesCurrentGain) {
+    MockWire wire;
+    ADS1X15::ADS1015<MockWire> ads(wire);
+    ads.setGain(ADS1X15::Gain::SIXTEEN_256MV);
+    const int16_t counts[] = {-2048, -1, 0, 1, 2047};
+    float volts[5];
+    ads.computeVolts(counts, volts, 5);
+    for (size_t i = 0; i < 5; i++) { EXPECT_EQ(volts[i], ads.computeVolts(counts[i])); }
+}
+
+TEST(BatchConversion, MicrovoltsInPlace_MatchesScalar) {
+    MockWire wire;
+    ADS1X15::ADS1115<MockWire> ads(wire);
+    for (ADS1X15::Gain gain : ALL_GAINS) {
+        std::vector<int32_t> values;
+        for (int32_t c = -32768; c <= 32767; c++) { values.push_back(c); }
+        ads.setGain(gain);
+        ads.computeMicrovolts(values.data(), values.size());
+        for (int32_t c = -32768; c <= 32767; c++) {
+            ASSERT_EQ(values[c + 32768], ads.computeMicrovolts(static_cast<int16_t>(c))) << c;
+        }
+    }
+}
+
+// ===========================================================================
+// Section 21: Simulated device
+//
+// SimulatedWire advances a virtual clock per bit on the bus; SimulatedDevice
+// converts injected inputs in the nominal period for its DR bits.
+// ===========================================================================
+
+namespace {
+ADS1X15::SimulatedWire* g_sim = nullptr;
+void simDelay(uint32_t micros) { g_sim->advanceMicros(micros); }
+uint32_t simMicros() { return g_sim->micros(); }
+} // namespace
+
+TEST(Simulator, SingleShot_BusyForConversionPeriod) {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1115Traits{});
+    bus.attach(dev);
+    dev.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_0, 1.0);
+    ADS1X15::ADS1115<ADS1X15::SimulatedWire> ads(bus);
+    ads.begin();
+    ads.setGain(ADS1X15::Gain::ONE_4096MV);
+    ads.setDataRate(ADS1X15::Rate::ADS1115_860SPS);
+    ads.startSingleEndedReading(0, false);
+    EXPECT_TRUE(dev.converting());
+    EXPECT_FALSE(ads.conversionComplete());
+    bus.advanceMicros(1163);
+    EXPECT_TRUE(ads.conversionComplete());
+    EXPECT_EQ(ads.getLastConversionResults(), 8000); // 1.0 V / 4.096 V * 32768
+    EXPECT_EQ(dev.conversions(), 1u);
+}
+
+TEST(Simulator, BlockingRead_AdvancesVirtualClock) {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1015Traits{});
+    bus.attach(dev);
+    dev.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_2, 2.5);
+    dev.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_DIFF_0_1, -0.75);
+    g_sim = &bus;
+    ADS1X15::ADS1015<ADS1X15::SimulatedWire> ads(bus);
+    ads.begin();
+    ads.setDelayFunction(simDelay);
+    EXPECT_EQ(ads.readADCSingleEnded(2), 833); // 2.5 V / 6.144 V * 2048
+    EXPECT_GE(bus.micros(), 625u);
+    EXPECT_EQ(ads.readADCDifferential(ADS1X15::DifferentialPair::PAIR_01), -250);
+}
+
+TEST(Simulator, BusTime_ScalesWithClock) {
+    ADS1X15::SimulatedWire bus(100000);
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1115Traits{});
+    bus.attach(dev);
+    bus.beginTransmission(0x48);
+    const uint8_t config[] = {0x01, 0x85, 0x83};
+    bus.write(config, 3);
+    EXPECT_EQ(bus.endTransmission(), 0);
+    // start + 4 bytes * 9 bits + stop = 38 bits at 10 us each
+    EXPECT_EQ(bus.busNanos(), 380000u);
+    EXPECT_EQ(bus.bytes(), 4u);
+    bus.resetStats();
+    bus.setClock(400000);
+    EXPECT_EQ(bus.requestFrom(0x48, 2), 2);
+    EXPECT_EQ(bus.busNanos(), 29u * 2500u); // start + 3 bytes * 9 bits + stop
+    EXPECT_EQ(bus.read(), 0x05);            // CONFIG: OS = 1 started a conversion, so it reads back busy (0)
+}
+
+TEST(Simulator, MissingDevice_Naks) {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1115Traits{}, 0x48);
+    bus.attach(dev);
+    g_sim = &bus;
+    ADS1X15::ADS1115<ADS1X15::SimulatedWire> ads(bus);
+    ads.begin(0x49);
+    ads.setClockFunction(simMicros);
+    EXPECT_EQ(ads.tryReadADCSingleEnded(0, 10000).status, ADS1X15::Status::NAK);
+}
+
+TEST(Simulator, Continuous_UpdatesEveryPeriodWithRdyPulse) {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1115Traits{});
+    bus.attach(dev);
+    dev.setInput(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_1, [](double t) { return t * 100.0; }); // 0.1 V per ms
+    ADS1X15::ADS1115<ADS1X15::SimulatedWire> ads(bus);
+    ads.begin();
+    ads.setDataRate(ADS1X15::Rate::ADS1115_250SPS);
+    ads.startSingleEndedReading(1, true);
+    uint64_t first = dev.nextCompletionNanos();
+    bus.advanceNanos(first - bus.nanos());
+    EXPECT_TRUE(dev.alertActive());
+    EXPECT_FALSE(dev.alertPinLevel()); // active low
+    bus.advanceMicros(10);
+    EXPECT_FALSE(dev.alertActive()); // ~8 us pulse
+    int16_t a = ads.getLastConversionResults();
+    bus.advanceMicros(4000);
+    int16_t b = ads.getLastConversionResults();
+    EXPECT_EQ(dev.conversions(), 2u);
+    EXPECT_NEAR(b - a, 0.4 / 6.144 * 32768, 2.0); // 4 ms later = 0.4 V higher
+}
+
+TEST(Simulator, Comparator_LatchesUntilConversionRead) {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1115Traits{});
+    bus.attach(dev);
+    double volts = 0.5;
+    dev.setInput(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_0, [&volts](double) { return volts; });
+    ADS1X15::ADS1115<ADS1X15::SimulatedWire> ads(bus);
+    ads.begin();
+    ads.setDataRate(ADS1X15::Rate::ADS1115_860SPS);
+    ads.startComparatorSingleEnded(0, ads.computeCount(1.0f));
+    bus.advanceMicros(2000);
+    EXPECT_FALSE(dev.alertActive());
+    volts = 1.5;
+    bus.advanceMicros(2000);
+    EXPECT_TRUE(dev.alertActive());
+    volts = 0.5;
+    bus.advanceMicros(2000);
+    EXPECT_TRUE(dev.alertActive()); // latched
+    ads.getLastConversionResults();
+    EXPECT_FALSE(dev.alertActive());
+}
+
+TEST(Simulator, OscillatorError_LengthensConversion) {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1115Traits{});
+    dev.setOscillatorErrorPpm(100000); // 10% slow
+    bus.attach(dev);
+    ADS1X15::ADS1115<ADS1X15::SimulatedWire> ads(bus);
+    ads.begin();
+    ads.setDataRate(ADS1X15::Rate::ADS1115_8SPS);
+    uint64_t start = bus.nanos();
+    ads.startSingleEndedReading(0, false);
+    EXPECT_NEAR(static_cast<double>(dev.nextCompletionNanos() - start), 137500000.0, 1000000.0);
+}
+
+// ===========================================================================
+// Section 22: Instrumentation
+//
+// NoInstrumentation is empty and adds no storage; CountingInstrumentation is
+// checked against the simulated bus, whose traffic is known exactly.
+// ===========================================================================
+
+static_assert(std::is_empty<ADS1X15::NoInstrumentation>::value, "default policy has no state");
+static_assert(sizeof(ADS1X15::ADS1115<MockWire>) == sizeof(ADS1X15::ADS1115<MockWire, ADS1X15::NoInstrumentation>),
+              "default policy");
+
+TEST(Instrumentation, Bucket_IsBitLengthCapped) {
+    EXPECT_EQ(ADS1X15::CountingInstrumentation::bucket(0, 8), 0);
+    EXPECT_EQ(ADS1X15::CountingInstrumentation::bucket(1, 8), 1);
+    EXPECT_EQ(ADS1X15::CountingInstrumentation::bucket(3, 8), 2);
+    EXPECT_EQ(ADS1X15::CountingInstrumentation::bucket(4, 8), 3);
+    EXPECT_EQ(ADS1X15::CountingInstrumentation::bucket(0xFFFFFFFF, 8), 7);
+}
+
+TEST(Instrumentation, CountsTrafficAndPolling) {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1115Traits{});
+    bus.attach(dev);
+    g_sim = &bus;
+    ADS1X15::ADS1115<ADS1X15::SimulatedWire, ADS1X15::CountingInstrumentation> ads(bus);
+    ads.begin();
+    ads.setDataRate(ADS1X15::Rate::ADS1115_860SPS);
+    ads.setClockFunction(simMicros);
+
+    ads.startSingleEndedReading(0, false); // HITHRESH, LOTHRESH, CONFIG
+    while (!ads.conversionComplete()) { bus.advanceMicros(500); }
+    ads.getLastConversionResults();
+
+    ADS1X15::InstrumentationCounters c = ads.instrumentation().snapshot();
+    EXPECT_EQ(c.registerWrites, 3u);
+    EXPECT_EQ(c.conversionsStarted, 1u);
+    EXPECT_EQ(c.conversionsCompleted, 1u);
+    // Busy twice, then done once the 500 us steps plus bus time pass 1163 us.
+    EXPECT_EQ(c.polls, 3u);
+    EXPECT_EQ(c.pollsPerConversion[ADS1X15::CountingInstrumentation::bucket(3, ADS1X15::POLL_HISTOGRAM_BUCKETS)], 1u);
+    EXPECT_EQ(c.registerReads, 4u);
+    EXPECT_EQ(c.pointerWrites, 1u); // the CONFIG write leaves the pointer on CONFIG; only CONVERSION needs one
+    EXPECT_EQ(c.bytesWritten, 3u * 3u + 1u);
+    EXPECT_EQ(c.bytesRead, 8u);
+    EXPECT_EQ(c.busErrors, 0u);
+    // Completion was seen ~1.2 ms after the start: bucket [1024, 2048).
+    EXPECT_EQ(c.latencyMicros[11], 1u);
+
+    ads.instrumentation().reset();
+    EXPECT_EQ(ads.instrumentation().snapshot().registerReads, 0u);
+}
+
+TEST(Instrumentation, CountsBusErrors) {
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus, ADS1X15::CountingInstrumentation> ads(wire);
+    ads.begin();
+    wire.end_code = 2;
+    EXPECT_EQ(ads.tryReadADCSingleEnded(0, 1000).status, ADS1X15::Status::NAK);
+    EXPECT_EQ(ads.instrumentation().snapshot().busErrors, 1u);
+    EXPECT_EQ(ads.instrumentation().snapshot().conversionsStarted, 0u);
+}
+
+// ===========================================================================
+// Section 23: Auto-ranging
+//
+// AutoRanger thresholds: widen above 15/16 of full scale, narrow when the value
+// would sit below 12/16 of the next narrower range, land at or below 12/16.
+// ===========================================================================
+
+namespace {
+using Ranger1115 = ADS1X15::AutoRanger<ADS1X15::ADS1115Traits>;
+
+constexpr ADS1X15::ScanEntry AUTO_RANGE_SCAN[] = {
+    ADS1X15::ScanEntry::singleEnded(0, ADS1X15::Gain::ONE_4096MV, ADS1X15::Rate::ADS1115_860SPS),
+    ADS1X15::ScanEntry::singleEnded(1, ADS1X15::Gain::ONE_4096MV, ADS1X15::Rate::ADS1115_860SPS),
+};
+
+template <typename Reader> ADS1X15::RangedSample nextSample(Reader& reader, ADS1X15::SimulatedWire& bus) {
+    ADS1X15::RangedSample sample{0, ADS1X15::Gain::TWOTHIRDS_6144MV};
+    for (int i = 0; i < 100 && !reader.poll(sample); i++) { bus.advanceMicros(200); }
+    return sample;
+}
+
+template <typename Sequencer> void nextFrame(Sequencer& seq, ADS1X15::SimulatedWire& bus) {
+    for (int i = 0; i < 100 && !seq.poll(); i++) { bus.advanceMicros(200); }
+}
+} // namespace
+
+TEST(AutoRange, ScanEntryWithGain_ReplacesOnlyPga) {
+    constexpr ADS1X15::ScanEntry e =
+        ADS1X15::ScanEntry::singleEnded(2, ADS1X15::Gain::ONE_4096MV, ADS1X15::Rate::ADS1115_475SPS);
+    constexpr ADS1X15::ScanEntry g = e.withGain(ADS1X15::Gain::EIGHT_512MV);
+    static_assert(g.gain() == ADS1X15::Gain::EIGHT_512MV, "gain replaced");
+    EXPECT_EQ(g.mux(), e.mux());
+    EXPECT_EQ(g.rate<ADS1X15::ADS1115Traits>(), e.rate<ADS1X15::ADS1115Traits>());
+    EXPECT_EQ(g.config & ~ADS1X15::ADS1X15_REG_CONFIG_PGA_MASK, e.config & ~ADS1X15::ADS1X15_REG_CONFIG_PGA_MASK);
+}
+
+TEST(AutoRange, Ranger_JumpsToNarrowestFittingGain) {
+    Ranger1115 ranger(ADS1X15::Gain::ONE_4096MV);
+    EXPECT_TRUE(ranger.update(800, ADS1X15::Gain::ONE_4096MV)); // 0.1 V
+    EXPECT_EQ(ranger.gain(), ADS1X15::Gain::SIXTEEN_256MV);
+    EXPECT_TRUE(ranger.update(-24000, ADS1X15::Gain::ONE_4096MV)); // -3.0 V: 73% is inside the band
+    EXPECT_EQ(ranger.gain(), ADS1X15::Gain::ONE_4096MV);
+}
+
+TEST(AutoRange, Ranger_SaturationRetriesAtWidestRange) {
+    Ranger1115 ranger(ADS1X15::Gain::SIXTEEN_256MV);
+    EXPECT_FALSE(ranger.update(32767, ADS1X15::Gain::SIXTEEN_256MV));
+    EXPECT_EQ(ranger.gain(), ADS1X15::Gain::TWOTHIRDS_6144MV);
+    EXPECT_FALSE(ranger.update(-32768, ADS1X15::Gain::FOUR_1024MV));
+    // Clipped at the widest range is accepted as is.
+    EXPECT_TRUE(ranger.update(32767, ADS1X15::Gain::TWOTHIRDS_6144MV));
+    EXPECT_EQ(ranger.gain(), ADS1X15::Gain::TWOTHIRDS_6144MV);
+}
+
+TEST(AutoRange, Ranger_HysteresisHoldsNearBoundaries) {
+    // At 4.096 V the band is 1.536 V (12/16 of 2.048 V) to 3.84 V (15/16 of 4.096 V).
+    Ranger1115 ranger(ADS1X15::Gain::ONE_4096MV);
+    for (double volts : {1.55, 2.1, 1.95, 3.8, 2.05, 1.6}) {
+        EXPECT_TRUE(ranger.update(static_cast<int16_t>(volts / 4.096 * 32768), ADS1X15::Gain::ONE_4096MV));
+        EXPECT_EQ(ranger.gain(), ADS1X15::Gain::ONE_4096MV) << volts;
+    }
+    // Leaving the band moves by the minimum needed, and the new gain's band contains the value.
+    ranger.update(static_cast<int16_t>(1.5 / 4.096 * 32768), ADS1X15::Gain::ONE_4096MV);
+    EXPECT_EQ(ranger.gain(), ADS1X15::Gain::TWO_2048MV);
+    ranger.update(static_cast<int16_t>(1.5 / 2.048 * 32768), ADS1X15::Gain::TWO_2048MV);
+    EXPECT_EQ(ranger.gain(), ADS1X15::Gain::TWO_2048MV);
+    ranger.update(static_cast<int16_t>(1.95 / 2.048 * 32768), ADS1X15::Gain::TWO_2048MV);
+    EXPECT_EQ(ranger.gain(), ADS1X15::Gain::ONE_4096MV);
+}
+
+TEST(AutoRange, Reader_SteadyInputSettlesWithoutReconversions) {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1115Traits{});
+    bus.attach(dev);
+    dev.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_0, 0.1);
+    ADS1X15::ADS1115<ADS1X15::SimulatedWire> ads(bus);
+    ads.begin();
+    ADS1X15::AutoRangeReader<ADS1X15::ADS1115<ADS1X15::SimulatedWire>> reader(
+        ads, ADS1X15::ScanEntry::singleEnded(0, ADS1X15::Gain::TWOTHIRDS_6144MV, ADS1X15::Rate::ADS1115_860SPS));
+    reader.start();
+
+    ADS1X15::RangedSample first = nextSample(reader, bus);
+    EXPECT_EQ(first.gain, ADS1X15::Gain::TWOTHIRDS_6144MV);
+    EXPECT_NEAR(ads.computeVolts(first.count, first.gain), 0.1f, 0.001f);
+    for (int i = 0; i < 10; i++) {
+        ADS1X15::RangedSample s = nextSample(reader, bus);
+        EXPECT_EQ(s.gain, ADS1X15::Gain::SIXTEEN_256MV);
+        EXPECT_EQ(s.count, 12800); // 0.1 V / 0.256 V * 32768
+    }
+    EXPECT_EQ(reader.reconversions(), 0u);
+    EXPECT_EQ(dev.conversions(), 11u);
+}
+
+TEST(AutoRange, Reader_SaturatedResultIsReconverted) {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1015Traits{});
+    bus.attach(dev);
+    dev.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_0, 1.0);
+    ADS1X15::ADS1015<ADS1X15::SimulatedWire> ads(bus);
+    ads.begin();
+    ADS1X15::AutoRangeReader<ADS1X15::ADS1015<ADS1X15::SimulatedWire>> reader(
+        ads, ADS1X15::ScanEntry::singleEnded(0, ADS1X15::Gain::SIXTEEN_256MV, ADS1X15::Rate::ADS1015_3300SPS));
+    reader.start();
+
+    ADS1X15::RangedSample s = nextSample(reader, bus);
+    EXPECT_EQ(reader.reconversions(), 1u);
+    EXPECT_EQ(s.gain, ADS1X15::Gain::TWOTHIRDS_6144MV);
+    EXPECT_NEAR(ads.computeVolts(s.count, s.gain), 1.0f, 0.003f);
+    EXPECT_EQ(reader.gain(), ADS1X15::Gain::TWO_2048MV);
+    EXPECT_EQ(nextSample(reader, bus).gain, ADS1X15::Gain::TWO_2048MV);
+    EXPECT_EQ(reader.reconversions(), 1u);
+}
+
+TEST(AutoRange, Reader_BusErrorLeavesGainUnchanged) {
+    // A failed read returns 0xFFFF: -1 counts, which would otherwise narrow the range.
+    MockWireStatus wire;
+    ADS1X15::ADS1115<MockWireStatus> ads(wire);
+    ads.begin();
+    ADS1X15::AutoRangeReader<ADS1X15::ADS1115<MockWireStatus>> reader(
+        ads, ADS1X15::ScanEntry::singleEnded(0, ADS1X15::Gain::TWO_2048MV, ADS1X15::Rate::ADS1115_860SPS));
+    reader.start();
+    wire.request_received = 0;
+    ADS1X15::RangedSample s{};
+    for (int i = 0; i < 3; i++) {
+        EXPECT_FALSE(reader.poll(s));
+    }
+    EXPECT_EQ(reader.status(), ADS1X15::Status::SHORT_READ);
+    EXPECT_EQ(reader.busErrors(), 3u);
+    EXPECT_EQ(reader.gain(), ADS1X15::Gain::TWO_2048MV);
+    EXPECT_EQ(reader.reconversions(), 0u);
+
+    wire.request_received = 2;
+    wire.queueWord(0x8000);
+    wire.queueWord(0x1000);
+    EXPECT_TRUE(reader.poll(s));
+    EXPECT_EQ(s.count, 0x1000);
+    EXPECT_EQ(s.gain, ADS1X15::Gain::TWO_2048MV);
+}
+
+TEST(AutoRange, Sequencer_RangesEachChannelIndependently) {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1115Traits{});
+    bus.attach(dev);
+    dev.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_0, 0.1);
+    dev.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_1, 3.0);
+    ADS1X15::ADS1115<ADS1X15::SimulatedWire> ads(bus);
+    ads.begin();
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<ADS1X15::SimulatedWire>, 2> seq(ads, AUTO_RANGE_SCAN);
+    seq.setAutoRange(0, true);
+    seq.setAutoRange(1, true);
+    seq.start();
+
+    nextFrame(seq, bus);
+    EXPECT_EQ(seq.resultGain(0), ADS1X15::Gain::ONE_4096MV);
+    nextFrame(seq, bus);
+    EXPECT_EQ(seq.resultGain(0), ADS1X15::Gain::SIXTEEN_256MV);
+    EXPECT_EQ(seq.resultGain(1), ADS1X15::Gain::ONE_4096MV);
+    EXPECT_EQ(seq.result(0), 12800);
+    EXPECT_NEAR(seq.resultVolts(0), 0.1f, 0.0001f);
+    EXPECT_NEAR(seq.resultVolts(1), 3.0f, 0.001f);
+    EXPECT_EQ(seq.reconversions(), 0u);
+}
+
+TEST(AutoRange, Sequencer_SaturatedEntryIsRedoneBeforeAdvancing) {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1115Traits{});
+    bus.attach(dev);
+    dev.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_0, 0.1);
+    dev.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_1, 5.0);
+    ADS1X15::ADS1115<ADS1X15::SimulatedWire> ads(bus);
+    ads.begin();
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<ADS1X15::SimulatedWire>, 2> seq(ads, AUTO_RANGE_SCAN);
+    seq.setAutoRange(1, true);
+    seq.start();
+
+    nextFrame(seq, bus);
+    EXPECT_EQ(seq.frameCount(), 1u);
+    EXPECT_EQ(seq.reconversions(), 1u);
+    EXPECT_EQ(dev.conversions(), 3u);
+    EXPECT_EQ(seq.resultGain(0), ADS1X15::Gain::ONE_4096MV); // fixed-gain entry is untouched
+    EXPECT_EQ(seq.resultGain(1), ADS1X15::Gain::TWOTHIRDS_6144MV);
+    EXPECT_NEAR(seq.resultVolts(1), 5.0f, 0.001f);
+}
+
+// ===========================================================================
+// Section 24: Comparator events
+//
+// The full comparator setup against the simulated ALERT/RDY pin.
+// ===========================================================================
+
+namespace {
+struct ComparatorRig {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev{ADS1X15::ADS1115Traits{}};
+    ADS1X15::ADS1115<ADS1X15::SimulatedWire> ads{bus};
+    double volts = 0.0;
+
+    ComparatorRig() {
+        bus.attach(dev);
+        dev.setInput(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_0, [this](double) { return volts; });
+        dev.setInput(ADS1X15::ADS1X15_REG_CONFIG_MUX_DIFF_0_1, [this](double) { return -volts; });
+        ads.begin();
+        ads.setGain(ADS1X15::Gain::ONE_4096MV);
+        ads.setDataRate(ADS1X15::Rate::ADS1115_860SPS);
+    }
+
+    // Holds the input for n conversion periods.
+    void hold(double v, int n = 1) {
+        volts = v;
+        bus.advanceMicros(1200 * n);
+    }
+};
+} // namespace
+
+TEST(ComparatorEvents, Window_AssertsOutsideBand) {
+    ComparatorRig rig;
+    ASSERT_EQ(rig.ads.startComparator(ADS1X15::ComparatorConfig::singleEnded(0, 8000, 16000) // 1 V to 2 V
+                                          .withMode(ADS1X15::ComparatorMode::WINDOW)
+                                          .withLatch(false)),
+              ADS1X15::Status::OK);
+    rig.hold(1.5);
+    EXPECT_FALSE(rig.dev.alertActive());
+    rig.hold(0.5);
+    EXPECT_TRUE(rig.dev.alertActive());
+    rig.hold(1.5);
+    EXPECT_FALSE(rig.dev.alertActive()); // non-latching follows the input
+    rig.hold(2.5);
+    EXPECT_TRUE(rig.dev.alertActive());
+}
+
+TEST(ComparatorEvents, Traditional_ReleasesBelowLowThreshold) {
+    ComparatorRig rig;
+    rig.ads.startComparator(ADS1X15::ComparatorConfig::singleEnded(0, 8000, 16000).withLatch(false));
+    rig.hold(2.5);
+    EXPECT_TRUE(rig.dev.alertActive());
+    rig.hold(1.5);
+    EXPECT_TRUE(rig.dev.alertActive()); // inside the hysteresis band
+    rig.hold(0.5);
+    EXPECT_FALSE(rig.dev.alertActive());
+}
+
+TEST(ComparatorEvents, Queue_NeedsSuccessiveConversions) {
+    ComparatorRig rig;
+    rig.ads.startComparator(ADS1X15::ComparatorConfig::singleEnded(0, 8000, 16000)
+                                .withLatch(false)
+                                .withQueue(ADS1X15::ComparatorQueue::FOUR_CONVERSIONS));
+    rig.hold(2.5, 3);
+    EXPECT_FALSE(rig.dev.alertActive());
+    rig.hold(2.5, 2);
+    EXPECT_TRUE(rig.dev.alertActive());
+}
+
+TEST(ComparatorEvents, ActiveHigh_Differential) {
+    ComparatorRig rig;
+    rig.ads.startComparator(ADS1X15::ComparatorConfig::differential(ADS1X15::DifferentialPair::PAIR_01, -8000, 8000)
+                                .withMode(ADS1X15::ComparatorMode::WINDOW)
+                                .withPolarity(ADS1X15::AlertPolarity::ACTIVE_HIGH));
+    rig.hold(0.5); // -0.5 V differential
+    EXPECT_FALSE(rig.dev.alertPinLevel());
+    rig.hold(1.5); // -1.5 V differential
+    EXPECT_TRUE(rig.dev.alertPinLevel());
+}
+
+TEST(ComparatorEvents, AcknowledgeAlert_ReleasesLatchInOneRead) {
+    ComparatorRig rig;
+    rig.ads.startComparator(ADS1X15::ComparatorConfig::singleEnded(0, 8000, 16000));
+    rig.hold(2.5);
+    ASSERT_TRUE(rig.dev.alertActive());
+    ADS1X15::ReadResult first = rig.ads.acknowledgeAlert();
+    EXPECT_EQ(first.status, ADS1X15::Status::OK);
+    EXPECT_EQ(first.value, 20000); // 2.5 V / 4.096 V * 32768
+    EXPECT_FALSE(rig.dev.alertActive());
+
+    rig.hold(2.5);
+    rig.hold(0.5);
+    EXPECT_TRUE(rig.dev.alertActive()); // latched through the drop
+    rig.bus.resetStats();
+    EXPECT_EQ(rig.ads.acknowledgeAlert().value, 4000);
+    EXPECT_FALSE(rig.dev.alertActive());
+    EXPECT_EQ(rig.bus.transactions(), 1u); // pointer already on CONVERSION
+    EXPECT_EQ(rig.bus.bytes(), 3u);
+}
+
+// ===========================================================================
+// Section 25: Filter stages
+//
+// Outputs are sums (input units times gain()); CicDecimator is checked against
+// the M cascaded boxcars it is equivalent to.
+// ===========================================================================
+
+namespace {
+template <typename Stage> std::vector<int32_t> runFilter(Stage& stage, const std::vector<int32_t>& input) {
+    std::vector<int32_t> outputs;
+    for (int32_t x : input) {
+        int32_t y;
+        if (stage.push(x, y)) { outputs.push_back(y); }
+    }
+    return outputs;
+}
+
+std::vector<int32_t> noiseCounts(size_t n) {
+    std::vector<int32_t> v(n);
+    uint32_t x = 7;
+    for (auto& c : v) {
+        x = x * 1103515245u + 12345u;
+        c = static_cast<int16_t>(x >> 16);
+    }
+    return v;
+}
+} // namespace
+
+TEST(Filter, MovingAverage_SlidingSum) {
+    ADS1X15::MovingAverage<4> avg;
+    std::vector<int32_t> out = runFilter(avg, {1, 2, 3, 4, 5, -32768, 32767});
+    EXPECT_EQ(out, (std::vector<int32_t>{10, 14, -32756, 8}));
+    static_assert(ADS1X15::MovingAverage<4>::gain() == 4, "gain");
+    avg.reset();
+    EXPECT_TRUE(runFilter(avg, {1, 2, 3}).empty());
+}
+
+TEST(Filter, BoxcarDecimator_OneSumPerBlock) {
+    ADS1X15::BoxcarDecimator box(3);
+    EXPECT_EQ(runFilter(box, {1, 2, 3, 4, 5, 6, 7}), (std::vector<int32_t>{6, 15}));
+    EXPECT_EQ(box.gain(), 3);
+    box.reset();
+    EXPECT_EQ(runFilter(box, {10, 10, 10}), (std::vector<int32_t>{30}));
+    EXPECT_EQ(ADS1X15::BoxcarDecimator(0).length(), 1u);
+}
+
+TEST(Filter, BoxcarDecimator_MainsLengthFromRate) {
+    using ADS1X15::BoxcarDecimator;
+    EXPECT_EQ(BoxcarDecimator::forMains(ADS1X15::Rate::ADS1015_1600SPS, ADS1X15::MAINS_50HZ).length(), 32u);
+    EXPECT_EQ(BoxcarDecimator::forMains(ADS1X15::Rate::ADS1115_250SPS, ADS1X15::MAINS_50_AND_60HZ).length(), 25u);
+    EXPECT_EQ(BoxcarDecimator::forMains(ADS1X15::Rate::ADS1115_475SPS, ADS1X15::MAINS_60HZ, 2).length(), 16u);
+    EXPECT_EQ(BoxcarDecimator::forMains(ADS1X15::Rate::ADS1115_8SPS, ADS1X15::MAINS_50HZ).length(), 1u);
+}
+
+TEST(Filter, Cic_MatchesCascadedBoxcars) {
+    constexpr uint16_t R = 8;
+    constexpr uint8_t M  = 3;
+    std::vector<int32_t> input = noiseCounts(800);
+
+    // Reference: M moving sums of length R (zero history), then every R-th value once M*R inputs have been seen.
+    std::vector<int64_t> ref(input.begin(), input.end());
+    for (uint8_t m = 0; m < M; m++) {
+        std::vector<int64_t> next(ref.size());
+        int64_t sum = 0;
+        for (size_t i = 0; i < ref.size(); i++) {
+            sum += ref[i] - (i >= R ? ref[i - R] : 0);
+            next[i] = sum;
+        }
+        ref = next;
+    }
+    std::vector<int32_t> expected;
+    for (size_t i = (M * R) - 1; i < ref.size(); i += R) { expected.push_back(static_cast<int32_t>(ref[i])); }
+
+    ADS1X15::CicDecimator<R, M> cic;
+    EXPECT_EQ(runFilter(cic, input), expected);
+    static_assert(ADS1X15::CicDecimator<R, M>::gain() == 512, "R^M");
+}
+
+TEST(Filter, Cic_DcGainIsExact) {
+    ADS1X15::CicDecimator<16, 4> cic; // 16 + 4 * 4 = 32 bits: the widest allowed
+    std::vector<int32_t> out = runFilter(cic, std::vector<int32_t>(16 * 10, -32768));
+    ASSERT_EQ(out.size(), 7u);
+    for (int32_t y : out) { EXPECT_EQ(y, -32768 * 65536); }
+}
+
+TEST(Filter, Chain_GainsMultiply) {
+    ADS1X15::FilterChain<ADS1X15::BoxcarDecimator, ADS1X15::CicDecimator<4, 2, 19>> chain(
+        ADS1X15::BoxcarDecimator(5));
+    EXPECT_EQ(chain.gain(), 5 * 16);
+    std::vector<int32_t> out = runFilter(chain, std::vector<int32_t>(5 * 4 * 3, 100));
+    EXPECT_EQ(out, (std::vector<int32_t>{100 * 80, 100 * 80}));
+}
+
+TEST(Filter, MainsAverage_RejectsHumFromContinuousMode) {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1015Traits{});
+    bus.attach(dev);
+    // 1 V plus 0.3 V of 50 Hz hum, with a phase that does not line up with the samples.
+    dev.setInput(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_0,
+                 [](double t) { return 1.0 + 0.3 * std::sin(2 * M_PI * 50 * t + 0.7); });
+    ADS1X15::ADS1015<ADS1X15::SimulatedWire> ads(bus);
+    ads.begin();
+    ads.setGain(ADS1X15::Gain::TWO_2048MV);
+    ads.setDataRate(ADS1X15::Rate::ADS1015_1600SPS);
+    ADS1X15::BoxcarDecimator mains = ADS1X15::BoxcarDecimator::forMains(ads.getDataRate(), ADS1X15::MAINS_50HZ);
+    ads.startSingleEndedReading(0, true);
+
+    int outputs = 0;
+    for (int i = 0; i < 32 * 5; i++) {
+        bus.advanceNanos(dev.nextCompletionNanos() - bus.nanos());
+        int32_t sum;
+        if (mains.push(ads.getLastConversionResults(), sum)) {
+            // Single samples swing by +/-0.3 V; the block average is within rounding of 1 V.
+            EXPECT_NEAR(ADS1X15::filteredVolts(ads, mains, sum), 1.0f, 0.001f);
+            outputs++;
+        }
+    }
+    EXPECT_EQ(outputs, 5);
+}
+
+// ===========================================================================
+// Section 26: Sample clock
+//
+// Data-ready arrivals from the simulator (oscillator error plus host latency
+// jitter) and synthetic arrival sequences.
+// ===========================================================================
+
+namespace {
+// Runs a continuous conversion with the given oscillator error, seeing each data-ready event 0-40 us late. Events
+// for which drop(i) is true are never seen. Returns the worst corrected-timestamp error over the last half of the
+// run, against the true completion time plus the mean latency.
+template <typename Drop>
+double runSampleClock(ADS1X15::SampleClock& clock, int32_t ppm, uint32_t samples, Drop drop) {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1115Traits{});
+    bus.attach(dev);
+    dev.setOscillatorErrorPpm(ppm);
+    ADS1X15::ADS1115<ADS1X15::SimulatedWire> ads(bus);
+    ads.begin();
+    ads.setDataRate(ADS1X15::Rate::ADS1115_860SPS);
+    ads.startSingleEndedReading(0, true);
+
+    uint32_t x        = 1;
+    double worstError = 0.0;
+    for (uint32_t i = 0; i < samples; i++) {
+        uint64_t completion = dev.nextCompletionNanos();
+        bus.advanceNanos(completion - bus.nanos());
+        x = x * 1103515245u + 12345u;
+        bus.advanceMicros((x >> 16) % 41);
+        if (drop(i)) { continue; }
+        uint32_t corrected = clock.onSample(bus.micros());
+        ads.getLastConversionResults();
+        if (i > samples / 2) {
+            double error = static_cast<double>(corrected) - (static_cast<double>(completion) / 1000.0 + 20.0);
+            worstError   = std::max(worstError, std::fabs(error));
+        }
+    }
+    return worstError;
+}
+} // namespace
+
+TEST(SampleClock, EstimatesOscillatorError) {
+    ADS1X15::SampleClock clock(ADS1X15::Rate::ADS1115_860SPS);
+    double worst = runSampleClock(clock, 40000, 4000, [](uint32_t) { return false; });
+    EXPECT_TRUE(clock.locked());
+    EXPECT_NEAR(clock.oscillatorErrorPpm(), 40000.0f, 100.0f);
+    EXPECT_NEAR(clock.samplesPerSecond(), 1e6f / (1163.0f * 1.04f), 0.1f);
+    EXPECT_EQ(clock.missed(), 0u);
+    EXPECT_EQ(clock.sampleIndex(), 3999u);
+    // Raw arrivals jitter by +/-20 us around the mean; nominal-period timestamps would be 180 ms out by the end.
+    EXPECT_LT(worst, 10.0);
+}
+
+TEST(SampleClock, FastOscillatorWithMissedEvents) {
+    ADS1X15::SampleClock clock(ADS1X15::Rate::ADS1115_860SPS);
+    // Drop one event in acquisition, every 97th after it, and a run of three.
+    auto drop = [](uint32_t i) { return i == 3 || (i > 20 && i % 97 == 0) || (i >= 1500 && i < 1503); };
+    double worst = runSampleClock(clock, -60000, 3000, drop);
+    uint32_t dropped = 0;
+    for (uint32_t i = 0; i < 3000; i++) { dropped += drop(i) ? 1 : 0; }
+    EXPECT_EQ(clock.missed(), dropped);
+    EXPECT_EQ(clock.sampleIndex(), 2999u);
+    EXPECT_NEAR(clock.oscillatorErrorPpm(), -60000.0f, 100.0f);
+    EXPECT_LT(worst, 10.0);
+}
+
+TEST(SampleClock, FollowsWrappingMicros) {
+    ADS1X15::SampleClock clock(1000);
+    uint32_t start = 0xFFFF0000u; // wraps after ~65 ms
+    uint32_t last  = 0;
+    for (uint32_t i = 0; i < 200; i++) {
+        uint32_t arrival = start + static_cast<uint32_t>(i * 1010);
+        last             = clock.onSample(arrival);
+        EXPECT_LE(static_cast<int32_t>(last - arrival) < 0 ? arrival - last : last - arrival, 1u);
+    }
+    EXPECT_NEAR(clock.periodMicros(), 1010.0f, 0.01f);
+    clock.reset();
+    EXPECT_FALSE(clock.locked());
+    EXPECT_EQ(clock.onSample(5), 5u);
+    EXPECT_EQ(clock.sampleIndex(), 0u);
+}
+
+// ===========================================================================
+// Section 27: Capture format
+//
+// CaptureEncoder blocks decoded by CaptureDecoder: round trips, corruption,
+// resynchronisation and size.
+// ===========================================================================
+
+namespace {
+struct CaptureInput {
+    uint8_t channel;
+    int16_t count;
+    uint32_t timestamp;
+};
+
+// Encodes samples into a byte stream of 512-byte-buffer blocks.
+std::vector<uint8_t> encodeCapture(ADS1X15::CaptureEncoder<512>& encoder, const std::vector<CaptureInput>& input) {
+    std::vector<uint8_t> stream;
+    auto flush = [&] {
+        size_t n = encoder.flush();
+        stream.insert(stream.end(), encoder.data(), encoder.data() + n);
+    };
+    for (const CaptureInput& s : input) {
+        if (!encoder.add(s.channel, s.count, s.timestamp)) {
+            flush();
+            EXPECT_TRUE(encoder.add(s.channel, s.count, s.timestamp));
+        }
+    }
+    flush();
+    return stream;
+}
+
+std::vector<ADS1X15::CapturedSample> drain(ADS1X15::CaptureDecoder& decoder) {
+    std::vector<ADS1X15::CapturedSample> out;
+    ADS1X15::CapturedSample s;
+    while (decoder.next(s)) { out.push_back(s); }
+    return out;
+}
+
+// A 4-channel scan of two devices: slow signals with noise, at 1163 us per sample.
+std::vector<CaptureInput> typicalCapture(uint32_t samples) {
+    std::vector<CaptureInput> input;
+    uint32_t x = 7;
+    for (uint32_t i = 0; i < samples; i++) {
+        x              = x * 1103515245u + 12345u;
+        int16_t signal = static_cast<int16_t>(8000.0 * std::sin(i / 400.0) + static_cast<int32_t>((x >> 16) % 9) - 4);
+        input.push_back(CaptureInput{static_cast<uint8_t>(i % 4), signal, i * 1163u + (x >> 28)});
+    }
+    return input;
+}
+
+void defineTypicalChannels(ADS1X15::CaptureEncoder<512>& encoder) {
+    using ADS1X15::ScanEntry;
+    encoder.defineChannel(0x48, ScanEntry::singleEnded(0, ADS1X15::Gain::ONE_4096MV, ADS1X15::Rate::ADS1115_860SPS));
+    encoder.defineChannel(0x48, ScanEntry::singleEnded(1, ADS1X15::Gain::ONE_4096MV, ADS1X15::Rate::ADS1115_860SPS));
+    encoder.defineChannel(0x49, ScanEntry::differential(ADS1X15::DifferentialPair::PAIR_01,
+                                                        ADS1X15::Gain::SIXTEEN_256MV, ADS1X15::Rate::ADS1115_860SPS));
+    encoder.defineChannel(0x49, ScanEntry::singleEnded(3, ADS1X15::Gain::TWO_2048MV, ADS1X15::Rate::ADS1115_860SPS));
+}
+} // namespace
+
+TEST(Capture, RoundTripInRandomChunks) {
+    ADS1X15::CaptureEncoder<512> encoder;
+    defineTypicalChannels(encoder);
+    std::vector<CaptureInput> input = typicalCapture(2000);
+    // Extremes, a backwards timestamp step and a wrap of the microsecond counter.
+    input.push_back(CaptureInput{2, INT16_MIN, 0xFFFFFFF0u});
+    input.push_back(CaptureInput{2, INT16_MAX, 0x00000010u});
+    input.push_back(CaptureInput{3, INT16_MIN, 0x00000008u});
+    input.push_back(CaptureInput{0, 0, 0x80000000u});
+    std::vector<uint8_t> stream = encodeCapture(encoder, input);
+
+    ADS1X15::CaptureDecoder decoder;
+    uint32_t x = 3;
+    for (size_t pos = 0; pos < stream.size();) {
+        x        = x * 1103515245u + 12345u;
+        size_t n = std::min<size_t>(1 + (x >> 16) % 700, stream.size() - pos);
+        decoder.feed(stream.data() + pos, n);
+        pos += n;
+    }
+
+    std::vector<ADS1X15::CapturedSample> output = drain(decoder);
+    ASSERT_EQ(output.size(), input.size());
+    for (size_t i = 0; i < input.size(); i++) {
+        EXPECT_EQ(output[i].count, input[i].count) << i;
+        EXPECT_EQ(output[i].timestamp, input[i].timestamp) << i;
+        EXPECT_EQ(output[i].address, input[i].channel < 2 ? 0x48 : 0x49) << i;
+    }
+    EXPECT_EQ(output[2].mux(), ADS1X15::ADS1X15_REG_CONFIG_MUX_DIFF_0_1);
+    EXPECT_EQ(output[2].gain(), ADS1X15::Gain::SIXTEEN_256MV);
+    EXPECT_EQ(output[3].mux(), ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_3);
+    EXPECT_EQ(output[3].rate<ADS1X15::ADS1115Traits>(), ADS1X15::Rate::ADS1115_860SPS);
+    EXPECT_EQ(decoder.blocks(), encoder.blocks());
+    EXPECT_EQ(output.back().block, encoder.blocks() - 1);
+    EXPECT_EQ(decoder.corruptBlocks(), 0u);
+    EXPECT_EQ(decoder.skippedBytes(), 0u);
+    EXPECT_EQ(decoder.lostBlocks(), 0u);
+}
+
+TEST(Capture, CorruptionCostsOneBlock) {
+    ADS1X15::CaptureEncoder<512> encoder;
+    defineTypicalChannels(encoder);
+    std::vector<CaptureInput> input = typicalCapture(1000);
+    std::vector<uint8_t> stream     = encodeCapture(encoder, input);
+    ASSERT_GE(encoder.blocks(), 4u);
+
+    std::vector<ADS1X15::CapturedSample> clean;
+    {
+        ADS1X15::CaptureDecoder decoder;
+        decoder.feed(stream.data(), stream.size());
+        clean = drain(decoder);
+    }
+
+    // Flip one payload bit in the second block, and put garbage in front of the stream.
+    size_t secondBlock = ADS1X15::CAPTURE_HEADER_SIZE + (stream[6] | (stream[7] << 8)) + ADS1X15::CAPTURE_CRC_SIZE;
+    stream[secondBlock + 40] ^= 0x10;
+    std::vector<uint8_t> garbage = {'A', 'D', 'S', 0x00, 'A', 'D', 'S', 'X', 1, 0, 0xFF, 0xFF, 0x55};
+    stream.insert(stream.begin(), garbage.begin(), garbage.end());
+
+    ADS1X15::CaptureDecoder decoder(512);
+    decoder.feed(stream.data(), stream.size());
+    std::vector<ADS1X15::CapturedSample> output = drain(decoder);
+
+    EXPECT_EQ(decoder.blocks(), encoder.blocks() - 1);
+    EXPECT_GE(decoder.corruptBlocks(), 1u);
+    EXPECT_EQ(decoder.lostBlocks(), 1u);
+    size_t firstBlockSamples = stream[garbage.size() + 8] | (stream[garbage.size() + 9] << 8);
+    size_t lost              = clean.size() - output.size();
+    ASSERT_GT(lost, 0u);
+    for (size_t i = 0; i < output.size(); i++) {
+        const ADS1X15::CapturedSample& expected = clean[i < firstBlockSamples ? i : i + lost];
+        EXPECT_EQ(output[i].count, expected.count) << i;
+        EXPECT_EQ(output[i].timestamp, expected.timestamp) << i;
+        EXPECT_NE(output[i].block, 1u);
+    }
+}
+
+TEST(Capture, ChannelLimitAndUndefinedChannel) {
+    ADS1X15::CaptureEncoder<64> encoder;
+    ADS1X15::ScanEntry entry =
+        ADS1X15::ScanEntry::singleEnded(0, ADS1X15::Gain::ONE_4096MV, ADS1X15::Rate::ADS1115_128SPS);
+    for (uint8_t i = 0; i < ADS1X15::CAPTURE_MAX_CHANNELS; i++) { EXPECT_EQ(encoder.defineChannel(0x48, entry), i); }
+    EXPECT_EQ(encoder.defineChannel(0x48, entry), ADS1X15::CAPTURE_NO_CHANNEL);
+    EXPECT_FALSE(encoder.add(ADS1X15::CAPTURE_MAX_CHANNELS, 0, 0));
+    EXPECT_EQ(encoder.flush(), 0u);
+
+    // A 64-byte block holds the header, the CRC and whatever samples fit with room for a worst-case one.
+    uint16_t added = 0;
+    while (encoder.add(static_cast<uint8_t>(added % 8), static_cast<int16_t>(added), added)) { added++; }
+    EXPECT_EQ(encoder.pending(), added);
+    size_t length = encoder.flush();
+    EXPECT_LE(length, 64u);
+    EXPECT_EQ(encoder.pending(), 0u);
+
+    ADS1X15::CaptureDecoder decoder;
+    decoder.feed(encoder.data(), length);
+    EXPECT_EQ(drain(decoder).size(), added);
+}
+
+TEST(Capture, TypicalSignalIsCompact) {
+    ADS1X15::CaptureEncoder<512> encoder;
+    defineTypicalChannels(encoder);
+    std::vector<uint8_t> stream = encodeCapture(encoder, typicalCapture(20000));
+    double bytesPerSample       = static_cast<double>(stream.size()) / 20000.0;
+    // Four channels each moving by a few counts per sample: tag, 2-byte dt and 1-2 byte dcount, plus framing.
+    EXPECT_LT(bytesPerSample, 5.0);
+}
+
+// ===========================================================================
+// Section 28: Calibration
+//
+// Calibration coefficients against computeMicrovolts() and a 64-bit
+// reference, CalibrationTable storage and blobs, and on-device calibration
+// against the simulator with an offset and gain error in the signal path.
+// ===========================================================================
+
+namespace {
+// The front end a calibration corrects: 0.4% gain error and 2.5 mV offset ahead of the ADC.
+struct CalibrationRig {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev{ADS1X15::ADS1115Traits{}};
+    ADS1X15::ADS1115<ADS1X15::SimulatedWire> ads{bus};
+    double trueVolts = 0.0;
+
+    CalibrationRig() {
+        bus.attach(dev);
+        dev.setInput(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_0, [this](double) { return trueVolts * 1.004 + 0.0025; });
+        ads.begin();
+    }
+};
+
+constexpr ADS1X15::ScanEntry CAL_ENTRY =
+    ADS1X15::ScanEntry::singleEnded(0, ADS1X15::Gain::TWO_2048MV, ADS1X15::Rate::ADS1115_860SPS);
+} // namespace
+
+TEST(Calibration, NominalMatchesComputeMicrovolts) {
+    using ADS = ADS1X15::ADS1115<MockWire>;
+    using ADS15 = ADS1X15::ADS1015<MockWire>;
+    for (ADS1X15::Gain gain : ALL_GAINS) {
+        ADS1X15::Calibration c16 = ADS1X15::Calibration::nominal<ADS1X15::ADS1115Traits>(gain);
+        ADS1X15::Calibration c12 = ADS1X15::Calibration::nominal<ADS1X15::ADS1015Traits>(gain);
+        EXPECT_GE(c16.scale, 16384);
+        EXPECT_EQ(c16.offsetCounts(), 0);
+        for (int32_t count = -32768; count <= 32767; count++) {
+            int16_t c = static_cast<int16_t>(count);
+            // Only negative halves differ: they round up here, away from zero in computeMicrovolts().
+            int32_t expected = ADS::computeMicrovolts(c, gain);
+            ASSERT_LE(std::abs(c16.microvolts(c) - expected), count < 0 ? 1 : 0) << count;
+            if (count >= -2048 && count < 2048) { ASSERT_EQ(c12.microvolts(c), ADS15::computeMicrovolts(c, gain)); }
+        }
+    }
+}
+
+TEST(Calibration, CorrectedMatchesWideReference) {
+    // Extreme offsets and gain corrections must not overflow the 32-bit multiply-add.
+    const int16_t offsets[]   = {-32768, -1234, 0, 77, 32767};
+    const float corrections[] = {0.5f, 0.9987f, 1.0f, 1.0123f, 1.9f};
+    for (ADS1X15::Gain gain : ALL_GAINS) {
+        for (int16_t offset : offsets) {
+            for (float correction : corrections) {
+                ADS1X15::Calibration c =
+                    ADS1X15::Calibration::corrected<ADS1X15::ADS1115Traits>(gain, offset, correction);
+                EXPECT_EQ(c.offsetCounts(), offset);
+                double lsb = ADS1X15::microvoltsPerLsbQ4<ADS1X15::ADS1115Traits>(gain) / 16.0 * correction;
+                EXPECT_NEAR(c.scale / std::ldexp(1.0, c.shift), lsb, lsb * 31e-6);
+                for (int32_t count = -32768; count <= 32767; count += 97) {
+                    int64_t wide = (static_cast<int64_t>(count) * c.scale + c.bias) >> c.shift;
+                    ASSERT_EQ(c.microvolts(static_cast<int16_t>(count)), wide) << count;
+                }
+                int32_t batch[2] = {-32768, 32767};
+                c.microvolts(batch, 2);
+                EXPECT_EQ(batch[0], c.microvolts(-32768));
+                EXPECT_EQ(batch[1], c.microvolts(32767));
+            }
+        }
+    }
+}
+
+TEST(Calibration, TwoPoint) {
+    ADS1X15::Calibration c = ADS1X15::Calibration::twoPoint(40, 32040, 2000000);
+    EXPECT_EQ(c.microvolts(40), 0);
+    EXPECT_EQ(c.microvolts(32040), 2000000);
+    EXPECT_EQ(c.microvolts(16040), 1000000);
+    ADS1X15::Calibration degenerate = ADS1X15::Calibration::twoPoint(5, 5, 100); // no span: 1 uV per count
+    EXPECT_EQ(degenerate.microvolts(5), 0);
+    EXPECT_EQ(degenerate.microvolts(105), 100);
+}
+
+TEST(Calibration, TableLookupAndCapacity) {
+    ADS1X15::CalibrationTable<ADS1X15::ADS1115Traits, 2> table;
+    const uint16_t mux0 = ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_0;
+    const uint16_t mux1 = ADS1X15::ADS1X15_REG_CONFIG_MUX_DIFF_0_1;
+    auto cal            = ADS1X15::Calibration::twoPoint(10, 20010, 1000000);
+
+    EXPECT_FALSE(table.contains(mux0, ADS1X15::Gain::ONE_4096MV));
+    EXPECT_EQ(table.microvolts(mux0, ADS1X15::Gain::ONE_4096MV, 8000), 1000000); // nominal
+    EXPECT_TRUE(table.set(mux0, ADS1X15::Gain::ONE_4096MV, cal));
+    EXPECT_TRUE(table.set(mux1, ADS1X15::Gain::SIXTEEN_256MV, cal.withOffset(-3)));
+    EXPECT_TRUE(table.set(mux0, ADS1X15::Gain::ONE_4096MV, cal.withOffset(20))); // replaces
+    EXPECT_FALSE(table.set(mux0, ADS1X15::Gain::TWO_2048MV, cal));               // full
+    EXPECT_EQ(table.size(), 2);
+    EXPECT_EQ(table.get(mux0, ADS1X15::Gain::ONE_4096MV).offsetCounts(), 20);
+    EXPECT_EQ(table.get(mux1, ADS1X15::Gain::SIXTEEN_256MV).offsetCounts(), -3);
+    EXPECT_FALSE(table.contains(mux1, ADS1X15::Gain::ONE_4096MV));
+    EXPECT_EQ(table.microvolts(mux0, ADS1X15::Gain::ONE_4096MV, 20020), 1000000);
+    table.clear();
+    EXPECT_EQ(table.size(), 0);
+    EXPECT_FALSE(table.contains(mux0, ADS1X15::Gain::ONE_4096MV));
+}
+
+TEST(Calibration, BlobRoundTripAndValidation) {
+    ADS1X15::CalibrationTable<ADS1X15::ADS1115Traits, 8> table;
+    for (uint8_t ch = 0; ch < 4; ch++) {
+        table.set(ADS1X15::MUX_BY_CHANNEL[ch], ALL_GAINS[ch],
+                  ADS1X15::Calibration::corrected<ADS1X15::ADS1115Traits>(ALL_GAINS[ch], ch * 7 - 10, 1.001f + ch));
+    }
+    uint8_t blob[decltype(table)::maxBlobSize()] = {};
+    EXPECT_EQ(table.serialize(blob, 10), 0u);
+    size_t length = table.serialize(blob, sizeof(blob));
+    EXPECT_EQ(length, 5u + 4u * 8u + 2u);
+
+    ADS1X15::CalibrationTable<ADS1X15::ADS1115Traits, 4> copy;
+    ASSERT_TRUE(copy.deserialize(blob, sizeof(blob)));
+    EXPECT_EQ(copy.size(), 4);
+    for (uint8_t ch = 0; ch < 4; ch++) {
+        for (int16_t count : {-20000, -1, 0, 1, 31000}) {
+            EXPECT_EQ(copy.microvolts(ADS1X15::MUX_BY_CHANNEL[ch], ALL_GAINS[ch], count),
+                      table.microvolts(ADS1X15::MUX_BY_CHANNEL[ch], ALL_GAINS[ch], count));
+        }
+    }
+
+    // Too many entries, the other chip, truncation and corruption all leave the table as it was.
+    ADS1X15::CalibrationTable<ADS1X15::ADS1115Traits, 3> small;
+    EXPECT_FALSE(small.deserialize(blob, length));
+    ADS1X15::CalibrationTable<ADS1X15::ADS1015Traits, 8> other;
+    EXPECT_FALSE(other.deserialize(blob, length));
+    EXPECT_FALSE(copy.deserialize(blob, length - 1));
+    for (size_t i = 0; i < length; i++) {
+        blob[i] ^= 0x04;
+        EXPECT_FALSE(copy.deserialize(blob, length)) << i;
+        blob[i] ^= 0x04;
+    }
+    EXPECT_EQ(copy.size(), 4);
+    EXPECT_TRUE(copy.deserialize(blob, length));
+}
+
+TEST(Calibration, OnDeviceOffsetAndGain) {
+    CalibrationRig rig;
+    ADS1X15::CalibrationTable<ADS1X15::ADS1115Traits, 4> table;
+
+    rig.trueVolts = 0.0;
+    ASSERT_EQ(ADS1X15::calibrateOffset(rig.ads, table, CAL_ENTRY), ADS1X15::Status::OK);
+    EXPECT_EQ(table.get(CAL_ENTRY).offsetCounts(), 40); // 2.5 mV / 62.5 uV
+    rig.trueVolts = 2.0;
+    ASSERT_EQ(ADS1X15::calibrateGain(rig.ads, table, CAL_ENTRY, 2000000), ADS1X15::Status::OK);
+    EXPECT_EQ(table.get(CAL_ENTRY).offsetCounts(), 40);
+
+    for (double volts : {-1.5, -0.1, 0.0, 0.3, 1.234, 2.0}) {
+        rig.trueVolts = volts;
+        rig.ads.startReading(CAL_ENTRY);
+        ASSERT_EQ(rig.ads.tryWaitForConversion(10000), ADS1X15::Status::OK);
+        int32_t raw = ADS1X15::ADS1115<ADS1X15::SimulatedWire>::computeMicrovolts(
+            rig.ads.getLastConversionResults(), CAL_ENTRY.gain());
+        int32_t calibrated = rig.ads.getLastConversionMicrovolts(table.get(CAL_ENTRY));
+        EXPECT_NEAR(calibrated, volts * 1e6, 63.0) << volts; // within one LSB
+        EXPECT_GT(std::abs(raw - volts * 1e6), 2000.0) << volts;
+    }
+}
+
+TEST(Calibration, ScanAndStreamPaths) {
+    CalibrationRig rig;
+    ADS1X15::CalibrationTable<ADS1X15::ADS1115Traits, 4> table;
+    table.set(CAL_ENTRY, ADS1X15::Calibration::twoPoint(40, 32168, 2000000));
+    rig.trueVolts = 1.0;
+
+    static constexpr ADS1X15::ScanEntry list[] = {CAL_ENTRY};
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<ADS1X15::SimulatedWire>, 1> scan(rig.ads, list);
+    scan.start();
+    while (!scan.poll()) { rig.bus.advanceMicros(100); }
+    EXPECT_NEAR(scan.resultMicrovolts(0, table), 1000000, 63);
+    EXPECT_EQ(scan.resultMicrovolts(1, table), 0);
+
+    ADS1X15::StreamReader<ADS1X15::ADS1115<ADS1X15::SimulatedWire>, 8> reader(rig.ads);
+    reader.start(CAL_ENTRY);
+    for (uint32_t i = 0; i < 5; i++) {
+        rig.bus.advanceMicros(1200);
+        reader.onDataReady(rig.bus.micros());
+    }
+    int32_t out[8];
+    ASSERT_EQ(reader.drainMicrovolts(out, 8, table.get(CAL_ENTRY)), 5u);
+    for (size_t i = 0; i < 5; i++) { EXPECT_NEAR(out[i], 1000000, 63) << i; }
+    EXPECT_EQ(reader.available(), 0u);
+}
+
+// ===========================================================================
+// Section 29: Pipelined scanning
+//
+// A four-input single-shot scan polled back-to-back on the simulated bus,
+// with and without pipelining: results, throughput and bus traffic.
+// ===========================================================================
+
+namespace {
+using Sim1015 = ADS1X15::ADS1015<ADS1X15::SimulatedWire>;
+using Sim1115 = ADS1X15::ADS1115<ADS1X15::SimulatedWire>;
+
+struct PipelineRun {
+    double resultsPerSecond;
+    double transactionsPerResult;
+    bool correct;
+};
+
+// Scans AIN0-3 at 0.5, 1.0, 1.5 and 2.0 V for the given number of frames, polling without pauses.
+template <typename Driver>
+PipelineRun runPipeline(uint32_t busHz, typename Driver::RateType rate, bool pipelined) {
+    using Traits                    = typename Driver::Traits;
+    const ADS1X15::ScanEntry list[] = {
+        ADS1X15::ScanEntry::singleEnded(0, ADS1X15::Gain::ONE_4096MV, rate),
+        ADS1X15::ScanEntry::singleEnded(1, ADS1X15::Gain::ONE_4096MV, rate),
+        ADS1X15::ScanEntry::singleEnded(2, ADS1X15::Gain::ONE_4096MV, rate),
+        ADS1X15::ScanEntry::singleEnded(3, ADS1X15::Gain::ONE_4096MV, rate),
+    };
+    ADS1X15::SimulatedWire bus(busHz);
+    ADS1X15::SimulatedDevice dev{Traits{}};
+    bus.attach(dev);
+    for (uint8_t ch = 0; ch < 4; ch++) { dev.setInputVoltage(ADS1X15::MUX_BY_CHANNEL[ch], 0.5 * (ch + 1)); }
+    Driver ads(bus);
+    ads.begin();
+    ADS1X15::ScanSequencer<Driver, 4> scan(ads, list);
+    scan.setPipelined(pipelined);
+    scan.start();
+    while (!scan.poll()) {} // first frame warms up the register cache
+
+    const uint32_t frames = 50;
+    int16_t expected[4];
+    for (size_t i = 0; i < 4; i++) {
+        expected[i] = static_cast<int16_t>(std::lround(Traits::fullScaleCounts() * 0.5 * (i + 1) / 4.096));
+    }
+    bool correct = true;
+    bus.resetStats();
+    uint64_t start = bus.nanos();
+    for (uint32_t f = 0; f < frames; f++) {
+        while (!scan.poll()) {}
+        for (size_t i = 0; i < 4; i++) { correct = correct && scan.result(i) == expected[i]; }
+    }
+    double seconds = static_cast<double>(bus.nanos() - start) / 1e9;
+    return PipelineRun{frames * 4 / seconds, bus.transactions() / (frames * 4.0), correct};
+}
+} // namespace
+
+TEST(PipelinedScan, CloserToRatedThroughput) {
+    for (uint32_t hz : {400000u, 1000000u}) {
+        PipelineRun plain = runPipeline<Sim1115>(hz, ADS1X15::Rate::ADS1115_860SPS, false);
+        PipelineRun piped = runPipeline<Sim1115>(hz, ADS1X15::Rate::ADS1115_860SPS, true);
+        EXPECT_TRUE(plain.correct);
+        EXPECT_TRUE(piped.correct);
+        // The result read overlaps the next conversion instead of delaying it, at no extra bus traffic.
+        EXPECT_GT(piped.resultsPerSecond, plain.resultsPerSecond) << hz;
+        EXPECT_LE(piped.transactionsPerResult, plain.transactionsPerResult) << hz;
+        EXPECT_LE(piped.resultsPerSecond, 860.0);
+    }
+    // Only the CONFIG write, the wake-up and the completion poll are left between conversions.
+    EXPECT_GT(runPipeline<Sim1115>(400000, ADS1X15::Rate::ADS1115_860SPS, true).resultsPerSecond, 730.0);
+    EXPECT_GT(runPipeline<Sim1115>(1000000, ADS1X15::Rate::ADS1115_860SPS, true).resultsPerSecond, 790.0);
+    EXPECT_GT(runPipeline<Sim1015>(400000, ADS1X15::Rate::ADS1015_1600SPS, true).resultsPerSecond, 1250.0);
+}
+
+TEST(PipelinedScan, FastRatesAreNotOverlapped) {
+    // At 100 kHz a result read outlasts a 3300 SPS conversion, so the sequencer reads first.
+    PipelineRun plain = runPipeline<Sim1015>(100000, ADS1X15::Rate::ADS1015_3300SPS, false);
+    PipelineRun piped = runPipeline<Sim1015>(100000, ADS1X15::Rate::ADS1015_3300SPS, true);
+    EXPECT_TRUE(piped.correct);
+    EXPECT_DOUBLE_EQ(piped.resultsPerSecond, plain.resultsPerSecond);
+    EXPECT_TRUE(runPipeline<Sim1015>(100000, ADS1X15::Rate::ADS1015_1600SPS, true).correct);
+}
+
+TEST(PipelinedScan, AutoRangedEntryStillReconverts) {
+    ADS1X15::SimulatedWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1115Traits{});
+    bus.attach(dev);
+    dev.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_0, 0.1);
+    dev.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_1, 5.0);
+    ADS1X15::ADS1115<ADS1X15::SimulatedWire> ads(bus);
+    ads.begin();
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<ADS1X15::SimulatedWire>, 2> seq(ads, AUTO_RANGE_SCAN);
+    seq.setPipelined(true);
+    seq.setAutoRange(1, true);
+    seq.start();
+
+    nextFrame(seq, bus);
+    EXPECT_EQ(seq.reconversions(), 1u);
+    EXPECT_EQ(dev.conversions(), 3u);
+    EXPECT_NEAR(seq.resultVolts(0), 0.1f, 0.001f);
+    EXPECT_NEAR(seq.resultVolts(1), 5.0f, 0.001f);
+    nextFrame(seq, bus);
+    EXPECT_EQ(seq.frameCount(), 2u);
+    EXPECT_NEAR(seq.resultVolts(0), 0.1f, 0.001f);
+    EXPECT_NEAR(seq.resultVolts(1), 5.0f, 0.001f);
+}
+
+namespace {
+// Returns scripted endTransmission() codes in order, then 0.
+struct ScriptedWire : MockWireStatus {
+    std::deque<uint8_t> end_codes;
+
+    uint8_t endTransmission() {
+        ++end_transmission_count;
+        if (end_codes.empty()) { return 0; }
+        uint8_t code = end_codes.front();
+        end_codes.pop_front();
+        return code;
+    }
+};
+
+uint16_t lastConfigWritten(const MockWire& wire) {
+    size_t n = wire.written.size();
+    return static_cast<uint16_t>(static_cast<uint16_t>(wire.written[n - 2]) << 8 | wire.written[n - 1]);
+}
+} // namespace
+
+TEST(PipelinedScan, FailedReadAfterOverlappedStart_Reconverts) {
+    ScriptedWire wire;
+    ADS1X15::ADS1115<ScriptedWire> ads(wire);
+    ads.begin();
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<ScriptedWire>, 3> scan(ads, SCAN_LIST);
+    scan.setPipelined(true);
+    scan.start();
+    wire.reset();
+    wire.end_codes = {0, 2}; // entry 1 starts, then the CONVERSION pointer write is NAKed
+    wire.queueWord(0x8000);
+    EXPECT_FALSE(scan.poll());
+    EXPECT_EQ(scan.busErrors(), 1u);
+    EXPECT_EQ(lastConfigWritten(wire), SCAN_LIST[0].config); // entry 0 converted again
+
+    for (uint16_t v : {0x42, 2, 3}) {
+        wire.queueWord(0x8000);
+        wire.queueWord(v);
+    }
+    EXPECT_FALSE(scan.poll());
+    EXPECT_FALSE(scan.poll());
+    EXPECT_TRUE(scan.poll());
+    EXPECT_EQ(scan.result(0), 0x42);
+    EXPECT_EQ(scan.result(1), 2);
+}
+
+TEST(PipelinedScan, FailedOverlappedStart_RetriedAfterRead) {
+    ScriptedWire wire;
+    ADS1X15::ADS1115<ScriptedWire> ads(wire);
+    ads.begin();
+    ADS1X15::ScanSequencer<ADS1X15::ADS1115<ScriptedWire>, 3> scan(ads, SCAN_LIST);
+    scan.setPipelined(true);
+    scan.start();
+    wire.reset();
+    wire.end_codes = {2}; // entry 1's CONFIG write is NAKed
+    wire.queueWord(0x8000);
+    wire.queueWord(0x0011);
+    EXPECT_FALSE(scan.poll());
+    EXPECT_EQ(scan.busErrors(), 1u);
+    EXPECT_EQ(lastConfigWritten(wire), SCAN_LIST[1].config);
+    EXPECT_EQ(scan.status(), ADS1X15::Status::OK);
+
+    for (uint16_t v : {0x22, 0x33}) {
+        wire.queueWord(0x8000);
+        wire.queueWord(v);
+    }
+    EXPECT_FALSE(scan.poll());
+    EXPECT_TRUE(scan.poll());
+    EXPECT_EQ(scan.result(0), 0x11);
+    EXPECT_EQ(scan.result(1), 0x22);
+}
+
+// ===========================================================================
+// Section 30: Linux i2c-dev backend
+//
+// LinuxI2C with its system calls replaced by a fake that logs every I2C_RDWR
+// call and runs its messages against the simulated bus.
+// ===========================================================================
+
+#if defined(__linux__)
+
+namespace {
+struct FakeI2CDev {
+    struct Call {
+        std::vector<uint16_t> flags;   // flags of each message
+        std::vector<uint16_t> lengths; // length of each message
+    };
+
+    ADS1X15::SimulatedWire* bus = nullptr;
+    int openError               = 0; // errno value open() fails with, or 0
+    int transferError           = 0; // errno value transfer() fails with, or 0
+    int closes                  = 0;
+    std::vector<Call> calls;
+
+    int open(const char*) { return openError != 0 ? -openError : 3; }
+    void close(int) { closes++; }
+
+    int transfer(int, i2c_rdwr_ioctl_data& data) {
+        Call call;
+        for (uint32_t i = 0; i < data.nmsgs; i++) {
+            call.flags.push_back(data.msgs[i].flags);
+            call.lengths.push_back(data.msgs[i].len);
+        }
+        calls.push_back(call);
+        if (transferError != 0) { return -transferError; }
+        for (uint32_t i = 0; i < data.nmsgs; i++) {
+            const i2c_msg& m = data.msgs[i];
+            bool last        = i + 1 == data.nmsgs;
+            if ((m.flags & I2C_M_RD) != 0) {
+                if (bus->requestFrom(static_cast<uint8_t>(m.addr), static_cast<uint8_t>(m.len)) < m.len) {
+                    return -ENXIO;
+                }
+                for (uint16_t b = 0; b < m.len; b++) { m.buf[b] = bus->read(); }
+            } else {
+                bus->beginTransmission(static_cast<uint8_t>(m.addr));
+                bus->write(m.buf, m.len);
+                if (bus->endTransmission(last) != 0) { return -ENXIO; }
+            }
+        }
+        return 0;
+    }
+};
+
+using FakeLinuxI2C = ADS1X15::BasicLinuxI2C<FakeI2CDev>;
+
+struct LinuxI2CFixture : ::testing::Test {
+    ADS1X15::SimulatedWire sim{400000};
+    ADS1X15::SimulatedDevice dev{ADS1X15::ADS1115Traits{}};
+    FakeLinuxI2C wire{"/dev/i2c-1", makeFake()};
+
+    FakeI2CDev makeFake() {
+        sim.attach(dev);
+        FakeI2CDev fake;
+        fake.bus = &sim;
+        return fake;
+    }
+};
+} // namespace
+
+TEST_F(LinuxI2CFixture, RegisterReadIsOneCombinedTransfer) {
+    ADS1X15::ADS1115<FakeLinuxI2C> ads(wire);
+    ads.begin();
+    ASSERT_TRUE(wire.isOpen());
+    ASSERT_EQ(ads.setComparatorThresholds(-100, 100), ADS1X15::Status::OK); // pointer left at HITHRESH
+    wire.syscalls().calls.clear();
+
+    bool complete = false;
+    EXPECT_EQ(ads.tryConversionComplete(complete), ADS1X15::Status::OK);
+    EXPECT_TRUE(complete);
+    ASSERT_EQ(wire.syscalls().calls.size(), 1u);
+    const FakeI2CDev::Call& call = wire.syscalls().calls[0];
+    ASSERT_EQ(call.flags.size(), 2u);
+    EXPECT_EQ(call.flags[0], 0);
+    EXPECT_EQ(call.lengths[0], 1);
+    EXPECT_EQ(call.flags[1], I2C_M_RD);
+    EXPECT_EQ(call.lengths[1], 2);
+}
+
+TEST_F(LinuxI2CFixture, RegisterWriteIsOneMessage) {
+    ADS1X15::ADS1115<FakeLinuxI2C> ads(wire);
+    ads.begin();
+    wire.syscalls().calls.clear();
+    EXPECT_EQ(ads.setComparatorThresholds(-100, 100), ADS1X15::Status::OK);
+    ASSERT_EQ(wire.syscalls().calls.size(), 2u);
+    for (const FakeI2CDev::Call& call : wire.syscalls().calls) {
+        EXPECT_EQ(call.flags, std::vector<uint16_t>{0});
+        EXPECT_EQ(call.lengths, std::vector<uint16_t>{3});
+    }
+}
+
+TEST_F(LinuxI2CFixture, OneSystemCallPerRegisterAccess) {
+    dev.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_2, 1.25);
+    ADS1X15::ADS1115<FakeLinuxI2C, ADS1X15::CountingInstrumentation> ads(wire);
+    ads.begin();
+    ads.setGain(ADS1X15::Gain::ONE_4096MV);
+    ads.instrumentation().reset();
+    uint32_t before = wire.transfers();
+
+    for (int i = 0; i < 5; i++) {
+        ads.startSingleEndedReading(2, /*continuous=*/false);
+        while (!ads.conversionComplete()) { sim.advanceMicros(100); }
+        EXPECT_EQ(ads.getLastConversionResults(), 10000);
+    }
+    ADS1X15::InstrumentationCounters c = ads.instrumentation().snapshot();
+    EXPECT_EQ(wire.transfers() - before, c.registerReads + c.registerWrites);
+    EXPECT_EQ(wire.syscalls().calls.size(), wire.transfers());
+    EXPECT_GT(c.pointerWrites, 0u);
+}
+
+TEST_F(LinuxI2CFixture, MissingDeviceReportsNak) {
+    ADS1X15::ADS1115<FakeLinuxI2C> ads(wire);
+    ads.begin(0x49);
+    EXPECT_EQ(ads.tryReadADCSingleEnded(0, 10000).status, ADS1X15::Status::NAK);
+    EXPECT_EQ(wire.lastError(), ENXIO);
+    // The pointer write is held for the read, so its NAK arrives with the read.
+    EXPECT_EQ(ads.tryGetLastConversionResults().status, ADS1X15::Status::SHORT_READ);
+}
+
+TEST_F(LinuxI2CFixture, ErrnoMapsToWireCodes) {
+    wire.begin();
+    wire.syscalls().transferError = ETIMEDOUT;
+    wire.beginTransmission(0x48);
+    wire.write(0x01);
+    EXPECT_EQ(wire.endTransmission(), 5);
+    wire.syscalls().transferError = EIO;
+    EXPECT_EQ(wire.endTransmission(), 4);
+    EXPECT_EQ(wire.requestFrom(0x48, 2), 0);
+    EXPECT_EQ(wire.available(), 0);
+    EXPECT_EQ(wire.lastError(), EIO);
+}
+
+TEST_F(LinuxI2CFixture, HeldWriteToOtherAddressGoesAlone) {
+    wire.begin();
+    wire.beginTransmission(0x48);
+    wire.write(0x00);
+    EXPECT_EQ(wire.endTransmission(false), 0);
+    EXPECT_TRUE(wire.syscalls().calls.empty());
+    wire.requestFrom(0x49, 2);
+    ASSERT_EQ(wire.syscalls().calls.size(), 2u);
+    EXPECT_EQ(wire.syscalls().calls[0].flags, std::vector<uint16_t>{0});
+    EXPECT_EQ(wire.syscalls().calls[1].flags, std::vector<uint16_t>{I2C_M_RD});
+}
+
+TEST_F(LinuxI2CFixture, FailedOpenFailsEveryTransfer) {
+    wire.syscalls().openError = EACCES;
+    ADS1X15::ADS1115<FakeLinuxI2C> ads(wire);
+    ads.begin();
+    EXPECT_FALSE(wire.isOpen());
+    EXPECT_EQ(wire.lastError(), EACCES);
+    EXPECT_EQ(ads.tryReadADCSingleEnded(0, 10000).status, ADS1X15::Status::BUS_ERROR);
+    EXPECT_EQ(wire.lastError(), EBADF);
+    EXPECT_TRUE(wire.syscalls().calls.empty());
+}
+
+TEST_F(LinuxI2CFixture, EndClosesOnce) {
+    wire.begin();
+    wire.begin();
+    wire.end();
+    wire.end();
+    EXPECT_EQ(wire.syscalls().closes, 1);
+    EXPECT_FALSE(wire.isOpen());
+}
+
+#endif // __linux__
+
+// ===========================================================================
+// Section 31: Bus locking
+//
+// The bus-lock policy must be held around every WIRE call, and several
+// threads sharing one simulated bus must never see each other's data.
+// ===========================================================================
+
+namespace {
+bool g_busLocked      = false;
+uint32_t g_busLocks   = 0;
+uint32_t g_unlockedIo = 0; // WIRE calls made without the lock
+uint32_t g_nestedLock = 0; // lock() calls while already locked
+
+struct FlagBusLock {
+    void lock() {
+        if (g_busLocked) { g_nestedLock++; }
+        g_busLocked = true;
+        g_busLocks++;
+    }
+    void unlock() { g_busLocked = false; }
+};
+
+// SimulatedWire that counts the calls made while the bus is not locked.
+struct LockCheckingWire : ADS1X15::SimulatedWire {
+    using SimulatedWire::SimulatedWire;
+    void beginTransmission(uint8_t address) {
+        check();
+        SimulatedWire::beginTransmission(address);
+    }
+    size_t write(uint8_t value) {
+        check();
+        return SimulatedWire::write(value);
+    }
+    size_t write(const uint8_t* data, size_t n) {
+        check();
+        return SimulatedWire::write(data, n);
+    }
+    uint8_t endTransmission(bool sendStop = true) {
+        check();
+        return SimulatedWire::endTransmission(sendStop);
+    }
+    uint8_t requestFrom(uint8_t address, uint8_t quantity) {
+        check();
+        return SimulatedWire::requestFrom(address, quantity);
+    }
+    uint8_t read() {
+        check();
+        return SimulatedWire::read();
+    }
+    static void check() {
+        if (!g_busLocked) { g_unlockedIo++; }
+    }
+};
+} // namespace
+
+TEST(BusLock, HeldForEveryTransaction) {
+    g_busLocked = false;
+    g_busLocks = g_unlockedIo = g_nestedLock = 0;
+    LockCheckingWire bus;
+    ADS1X15::SimulatedDevice dev(ADS1X15::ADS1115Traits{});
+    bus.attach(dev);
+    dev.setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_1, 1.0);
+    ADS1X15::ADS1115<LockCheckingWire, ADS1X15::CountingInstrumentation, FlagBusLock> ads(bus);
+    ads.begin();
+    ads.setGain(ADS1X15::Gain::ONE_4096MV);
+
+    EXPECT_EQ(ads.readADCSingleEnded(1), 8000);
+    EXPECT_EQ(ads.setComparatorThresholds(-10, 10), ADS1X15::Status::OK);
+    EXPECT_TRUE(ads.tryReadADCDifferential(ADS1X15::DifferentialPair::PAIR_01, 100000).ok());
+    ads.resyncRegisterCache();
+
+    ADS1X15::InstrumentationCounters c = ads.instrumentation().snapshot();
+    EXPECT_EQ(g_unlockedIo, 0u);
+    EXPECT_EQ(g_nestedLock, 0u);
+    EXPECT_FALSE(g_busLocked);
+    EXPECT_EQ(g_busLocks, c.registerReads + c.registerWrites);
+}
+
+TEST(BusLock, NoBusLockAddsNoStorage) {
+    using Plain  = ADS1X15::ADS1115<ADS1X15::SimulatedWire>;
+    using Locked = ADS1X15::ADS1115<ADS1X15::SimulatedWire, ADS1X15::NoInstrumentation, ADS1X15::MutexBusLock>;
+    EXPECT_EQ(sizeof(Plain), sizeof(ADS1X15::ADS1115<ADS1X15::SimulatedWire, ADS1X15::NoInstrumentation>));
+    EXPECT_GT(sizeof(Locked), sizeof(Plain));
+}
+
+TEST(BusLock, ThreadsSharingOneBusReadOnlyTheirOwnChip) {
+    using Driver = ADS1X15::ADS1115<ADS1X15::SimulatedWire, ADS1X15::NoInstrumentation, ADS1X15::MutexBusLock>;
+    const size_t chips = 4;
+    const int samples  = 2000;
+    ADS1X15::SimulatedWire bus(1000000);
+    std::mutex busMutex;
+    std::deque<ADS1X15::SimulatedDevice> devices;
+    std::deque<Driver> drivers;
+    for (size_t i = 0; i < chips; i++) {
+        devices.emplace_back(ADS1X15::ADS1115Traits{}, static_cast<uint8_t>(0x48 + i));
+        bus.attach(devices.back());
+        // Every chip and channel has its own voltage, so a read that got another transaction's data is visible.
+        for (uint8_t ch = 0; ch < 4; ch++) {
+            devices.back().setInputVoltage(ADS1X15::MUX_BY_CHANNEL[ch], 0.1 * (4 * i + ch + 1));
+        }
+        drivers.emplace_back(bus);
+        drivers.back().busLock().attach(busMutex);
+        drivers.back().begin(static_cast<uint8_t>(0x48 + i));
+        drivers.back().setGain(ADS1X15::Gain::TWO_2048MV);
+    }
+
+    std::vector<int> corrupted(chips, 0);
+    std::vector<int> failed(chips, 0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < chips; i++) {
+        threads.emplace_back([&, i] {
+            while (!go) {}
+            for (int n = 0; n < samples; n++) {
+                uint8_t ch            = static_cast<uint8_t>(n % 4);
+                int16_t expected      = static_cast<int16_t>(std::lround(0.1 * (4 * i + ch + 1) / 2.048 * 32768));
+                ADS1X15::ReadResult r = drivers[i].tryReadADCSingleEnded(ch, 1000000);
+                if (!r.ok()) {
+                    failed[i]++;
+                } else if (r.value != expected) {
+                    corrupted[i]++;
+                }
+            }
+        });
+    }
+    go = true;
+    for (std::thread& t : threads) { t.join(); }
+    for (size_t i = 0; i < chips; i++) {
+        EXPECT_EQ(failed[i], 0) << i;
+        EXPECT_EQ(corrupted[i], 0) << i;
+        EXPECT_EQ(devices[i].conversions(), static_cast<uint32_t>(samples)) << i;
+    }
+}
+
+// ===========================================================================
+// Section 32: Multi-bus acquisition
+//
+// AcquisitionEngine workers on separate simulated buses, merged into one
+// stream. Timestamps come from a shared host clock.
+// ===========================================================================
+
+namespace {
+uint32_t steadyMicros() {
+    using namespace std::chrono;
+    return static_cast<uint32_t>(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+using AcqDriver = ADS1X15::ADS1115<ADS1X15::SimulatedWire>;
+
+// One simulated bus with its chips; chip d at 0x48 + d reads 0.1 * (4 * bus + d + 1) V on AIN0.
+struct AcqBus {
+    ADS1X15::SimulatedWire wire{1000000};
+    std::deque<ADS1X15::SimulatedDevice> chips;
+    std::deque<AcqDriver> drivers;
+
+    AcqBus(size_t bus, size_t count) {
+        for (size_t d = 0; d < count; d++) {
+            chips.emplace_back(ADS1X15::ADS1115Traits{}, static_cast<uint8_t>(0x48 + d));
+            wire.attach(chips.back());
+            chips.back().setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_0, expectedVolts(bus, d));
+            drivers.emplace_back(wire);
+            drivers.back().begin(static_cast<uint8_t>(0x48 + d));
+        }
+    }
+
+    static double expectedVolts(size_t bus, size_t device) { return 0.1 * (4 * bus + device + 1); }
+};
+
+const ADS1X15::ScanEntry ACQ_ENTRY =
+    ADS1X15::ScanEntry::singleEnded(0, ADS1X15::Gain::TWO_2048MV, ADS1X15::Rate::ADS1115_860SPS);
+
+int16_t acqExpected(const ADS1X15::AcquiredSample& s) {
+    return static_cast<int16_t>(std::lround(AcqBus::expectedVolts(s.bus, s.device) / 2.048 * 32768));
+}
+
+// Takes samples until n have arrived or two seconds have passed.
+template <typename Engine> std::vector<ADS1X15::AcquiredSample> takeSamples(Engine& engine, size_t n) {
+    std::vector<ADS1X15::AcquiredSample> out;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    ADS1X15::AcquiredSample s;
+    while (out.size() < n && std::chrono::steady_clock::now() < deadline) {
+        if (engine.next(s)) {
+            out.push_back(s);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    return out;
+}
+} // namespace
+
+TEST(Acquisition, MergedStreamIsTimeOrdered) {
+    std::deque<AcqBus> buses;
+    ADS1X15::AcquisitionEngine<AcqDriver, 3, 4, 256> engine(steadyMicros);
+    for (size_t b = 0; b < 3; b++) {
+        buses.emplace_back(b, 2 + b);
+        for (AcqDriver& d : buses.back().drivers) { ASSERT_TRUE(engine.addDevice(b, d, ACQ_ENTRY)); }
+    }
+    EXPECT_FALSE(engine.addDevice(3, buses[0].drivers[0], ACQ_ENTRY));
+    engine.start();
+    EXPECT_FALSE(engine.addDevice(0, buses[0].drivers[0], ACQ_ENTRY));
+    std::vector<ADS1X15::AcquiredSample> samples = takeSamples(engine, 3000);
+    engine.stop();
+
+    ASSERT_EQ(samples.size(), 3000u);
+    size_t perBus[3] = {};
+    for (size_t i = 0; i < samples.size(); i++) {
+        if (i > 0) { EXPECT_FALSE(static_cast<int32_t>(samples[i].timestamp - samples[i - 1].timestamp) < 0) << i; }
+        ASSERT_LT(samples[i].bus, 3);
+        EXPECT_LT(samples[i].device, 2 + samples[i].bus);
+        EXPECT_EQ(samples[i].count, acqExpected(samples[i]));
+        perBus[samples[i].bus]++;
+    }
+    for (size_t b = 0; b < 3; b++) { EXPECT_GT(perBus[b], 0u) << b; }
+    ADS1X15::AcquisitionStats totals = engine.totals();
+    EXPECT_EQ(totals.dropped, 0u);
+    EXPECT_EQ(totals.readErrors, 0u);
+    EXPECT_EQ(engine.merged(), 3000u);
+
+    // Whatever was still queued comes out after stop(), in order too.
+    ADS1X15::AcquiredSample s, last = samples.back();
+    while (engine.next(s)) {
+        EXPECT_FALSE(static_cast<int32_t>(s.timestamp - last.timestamp) < 0);
+        last = s;
+    }
+    EXPECT_EQ(engine.merged(), totals.produced);
+}
+
+TEST(Acquisition, WaitBackpressureLosesNothing) {
+    AcqBus bus(0, 2);
+    ADS1X15::AcquisitionEngine<AcqDriver, 1, 2, 16> engine(steadyMicros);
+    engine.addDevice(0, bus.drivers[0], ACQ_ENTRY);
+    engine.addDevice(0, bus.drivers[1], ACQ_ENTRY);
+    engine.start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (engine.stats(0).stalls == 0 && std::chrono::steady_clock::now() < deadline) { std::this_thread::yield(); }
+    EXPECT_GT(engine.stats(0).stalls, 0u);
+    std::vector<ADS1X15::AcquiredSample> samples = takeSamples(engine, 200);
+    engine.stop();
+
+    EXPECT_EQ(samples.size(), 200u);
+    ADS1X15::AcquisitionStats stats = engine.stats(0);
+    EXPECT_EQ(stats.dropped, 0u);
+    // Every conversion read was delivered or is still queued (a held result is never read twice).
+    uint32_t reads = bus.chips[0].conversions() + bus.chips[1].conversions();
+    EXPECT_LE(stats.produced, reads);
+    EXPECT_GE(stats.produced + 2, reads);
+}
+
+TEST(Acquisition, DropBackpressureCountsDrops) {
+    AcqBus bus(0, 1);
+    ADS1X15::AcquisitionEngine<AcqDriver, 1, 1, 16> engine(steadyMicros);
+    engine.setBackpressure(ADS1X15::Backpressure::DROP);
+    engine.addDevice(0, bus.drivers[0], ACQ_ENTRY);
+    engine.start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (engine.stats(0).dropped < 10 && std::chrono::steady_clock::now() < deadline) { std::this_thread::yield(); }
+    engine.stop();
+
+    ADS1X15::AcquisitionStats stats = engine.stats(0);
+    EXPECT_GE(stats.dropped, 10u);
+    EXPECT_EQ(stats.stalls, 0u);
+    EXPECT_EQ(stats.produced, 16u);
+    ADS1X15::AcquiredSample s;
+    size_t delivered = 0;
+    while (engine.next(s)) { delivered++; }
+    EXPECT_EQ(delivered, 16u);
+}
+
+TEST(Acquisition, FailingDeviceDoesNotStallOthers) {
+    AcqBus good(0, 1);
+    AcqBus bad(1, 1);
+    bad.drivers[0].begin(0x4B); // nothing answers there
+    ADS1X15::AcquisitionEngine<AcqDriver, 2, 1, 64> engine(steadyMicros);
+    engine.addDevice(0, good.drivers[0], ACQ_ENTRY);
+    engine.addDevice(1, bad.drivers[0], ACQ_ENTRY);
+    engine.start();
+    std::vector<ADS1X15::AcquiredSample> samples = takeSamples(engine, 50);
+    engine.stop();
+
+    EXPECT_EQ(samples.size(), 50u);
+    EXPECT_GT(engine.stats(1).readErrors, 0u);
+    EXPECT_EQ(engine.stats(1).produced, 0u);
+    EXPECT_EQ(engine.stats(0).readErrors, 0u);
+}
+
+// ===========================================================================
+// Section 33: Asynchronous transaction queue
+//
+// Transaction descriptors run by the simulated interrupt-driven controller.
+// The CPU's other work is modelled by advancing the virtual clock.
+// ===========================================================================
+
+namespace {
+using AsyncQueue = ADS1X15::TransactionQueue<ADS1X15::SimulatedAsyncI2C, 16>;
+
+// Four ADS1115s on one simulated bus; chip d at 0x48 + d reads 0.1 * (d + 1) V on AIN0.
+struct AsyncRig {
+    ADS1X15::SimulatedWire wire{400000};
+    ADS1X15::SimulatedAsyncI2C controller{wire};
+    AsyncQueue queue{controller};
+    std::deque<ADS1X15::SimulatedDevice> chips;
+    std::vector<ADS1X15::ADS1115Transactions> adcs;
+
+    AsyncRig() {
+        for (uint8_t d = 0; d < 4; d++) {
+            chips.emplace_back(ADS1X15::ADS1115Traits{}, static_cast<uint8_t>(0x48 + d));
+            chips.back().setInputVoltage(ADS1X15::ADS1X15_REG_CONFIG_MUX_SINGLE_0, 0.1 * (d + 1));
+            wire.attach(chips.back());
+            adcs.emplace_back(static_cast<uint8_t>(0x48 + d));
+        }
+    }
+};
+
+struct CompletionLog {
+    std::vector<uintptr_t> order;
+    std::vector<ADS1X15::I2CTransaction> done;
+    AsyncQueue* queue      = nullptr;
+    size_t busyInCallbacks = 0;
+
+    static void record(const ADS1X15::I2CTransaction& t, void* context) {
+        CompletionLog* log = static_cast<CompletionLog*>(context);
+        log->order.push_back(t.address);
+        log->done.push_back(t);
+        if (log->queue != nullptr && log->queue->busy()) { log->busyInCallbacks++; }
+    }
+};
+
+const ADS1X15::ScanEntry ASYNC_ENTRY =
+    ADS1X15::ScanEntry::singleEnded(0, ADS1X15::Gain::TWO_2048MV, ADS1X15::Rate::ADS1115_860SPS);
+} // namespace
+
+TEST(AsyncI2C, DescriptorsEncodeRegisterAccesses) {
+    ADS1X15::ADS1115Transactions adc(0x49);
+    ADS1X15::I2CTransaction start = adc.startReading(ASYNC_ENTRY);
+    EXPECT_EQ(start.address, 0x49);
+    EXPECT_EQ(start.pointer, static_cast<uint8_t>(ADS1X15::RegisterAddress::CONFIG));
+    EXPECT_EQ(start.writeLength, 2);
+    EXPECT_EQ(start.readLength, 0);
+    EXPECT_EQ(start.payload[0], ASYNC_ENTRY.config >> 8);
+    EXPECT_EQ(start.payload[1], ASYNC_ENTRY.config & 0xFF);
+
+    ADS1X15::I2CTransaction read = adc.readConversion();
+    EXPECT_EQ(read.pointer, static_cast<uint8_t>(ADS1X15::RegisterAddress::CONVERSION));
+    EXPECT_EQ(read.writeLength, 0);
+    EXPECT_EQ(read.readLength, 2);
+
+    read.data[0] = 0xFF;
+    read.data[1] = 0xF0;
+    EXPECT_EQ(ADS1X15::ADS1115Transactions::count(read), -16);
+    EXPECT_EQ(ADS1X15::ADS1015Transactions::count(read), -1);
+    read.data[0] = 0x80;
+    EXPECT_TRUE(ADS1X15::ADS1115Transactions::conversionComplete(read));
+    read.data[0] = 0x05;
+    EXPECT_FALSE(ADS1X15::ADS1115Transactions::conversionComplete(read));
+}
+
+TEST(AsyncI2C, ConversionsCompleteInSubmissionOrder) {
+    AsyncRig rig;
+    CompletionLog log;
+    log.queue = &rig.queue;
+    for (const ADS1X15::ADS1115Transactions& adc : rig.adcs) {
+        ASSERT_TRUE(rig.queue.submit(adc.startReading(ASYNC_ENTRY, CompletionLog::record, &log)));
+    }
+    // Nothing has happened on the bus yet: submit() returns without waiting.
+    EXPECT_EQ(rig.wire.transactions(), 0u);
+    EXPECT_TRUE(rig.queue.busy());
+    EXPECT_EQ(rig.queue.pending(), 4u);
+
+    rig.controller.advanceMicros(2000);
+    for (const ADS1X15::ADS1115Transactions& adc : rig.adcs) {
+        ASSERT_TRUE(rig.queue.submit(adc.readConversion(CompletionLog::record, &log)));
+    }
+    rig.controller.runUntilIdle();
+
+    ASSERT_EQ(log.done.size(), 8u);
+    EXPECT_EQ(log.order, (std::vector<uintptr_t>{0x48, 0x49, 0x4A, 0x4B, 0x48, 0x49, 0x4A, 0x4B}));
+    for (size_t d = 0; d < 4; d++) {
+        const ADS1X15::I2CTransaction& t = log.done[4 + d];
+        EXPECT_TRUE(t.ok());
+        int16_t expected                 = static_cast<int16_t>(std::lround(0.1 * (d + 1) / 2.048 * 32768));
+        EXPECT_EQ(ADS1X15::ADS1115Transactions::count(t), expected);
+    }
+    // Each callback ran after the next transaction had been handed to the controller.
+    EXPECT_EQ(log.busyInCallbacks, 6u);
+    EXPECT_EQ(rig.queue.completed(), 8u);
+    EXPECT_EQ(rig.queue.failed(), 0u);
+    EXPECT_EQ(rig.queue.pending(), 0u);
+}
+
+TEST(AsyncI2C, BusStaysBusyWhileCpuWorks) {
+    AsyncRig rig;
+    constexpr size_t READS = 64;
+    size_t queued          = 0;
+    rig.wire.resetStats();
+    uint64_t begin = rig.wire.nanos();
+    // The CPU keeps the queue topped up between 10 us slices of other work.
+    while (rig.queue.completed() < READS) {
+        while (queued < READS && rig.queue.submit(rig.adcs[queued % 4].readConversion())) { queued++; }
+        rig.controller.advanceMicros(10);
+    }
+    uint64_t elapsed = rig.wire.nanos() - begin;
+    EXPECT_EQ(rig.queue.submitted(), READS);
+    EXPECT_EQ(rig.wire.transactions(), 2 * READS);
+    // Back-to-back transactions: the bus is idle only in the final partial slice.
+    EXPECT_GT(static_cast<double>(rig.wire.busNanos()) / elapsed, 0.98);
+
+    // Interrupt and DMA set-up latency shows up as gaps between transactions.
+    AsyncRig slow;
+    slow.controller.setStartLatencyNanos(20000);
+    for (size_t i = 0; i < 8; i++) { ASSERT_TRUE(slow.queue.submit(slow.adcs[i % 4].readConversion())); }
+    slow.wire.resetStats();
+    begin = slow.wire.nanos();
+    slow.controller.runUntilIdle();
+    EXPECT_EQ(slow.wire.nanos() - begin, slow.wire.busNanos() + 8 * 20000u);
+}
+
+TEST(AsyncI2C, FullQueueAndBusErrorsAreReported) {
+    AsyncRig rig;
+    CompletionLog log;
+    ADS1X15::ADS1115Transactions absent(0x4B + 1);
+    // One transaction in progress plus 16 waiting.
+    for (size_t i = 0; i < 17; i++) { ASSERT_TRUE(rig.queue.submit(rig.adcs[0].readConfig())); }
+    EXPECT_FALSE(rig.queue.submit(rig.adcs[0].readConfig()));
+    EXPECT_EQ(rig.queue.submitted(), 17u);
+
+    rig.controller.runUntilIdle();
+    EXPECT_EQ(rig.queue.failed(), 0u);
+
+    ASSERT_TRUE(rig.queue.submit(absent.readConversion(CompletionLog::record, &log)));
+    ASSERT_TRUE(rig.queue.submit(absent.startReading(ASYNC_ENTRY, CompletionLog::record, &log)));
+    rig.controller.runUntilIdle();
+    ASSERT_EQ(log.done.size(), 2u);
+    EXPECT_EQ(log.done[0].status, ADS1X15::Status::NAK);
+    EXPECT_EQ(log.done[1].status, ADS1X15::Status::NAK);
+    EXPECT_EQ(rig.queue.failed(), 2u);
+    EXPECT_EQ(rig.queue.completed(), 19u);
+}
+
+namespace {
+struct CountingLock {
+    int depth = 0;
+    int locks = 0;
+    void lock() {
+        depth++;
+        locks++;
+    }
+    void unlock() { depth--; }
+};
+
+using LockedQueue = ADS1X15::TransactionQueue<ADS1X15::SimulatedAsyncI2C, 4, CountingLock>;
+
+// Polls CONFIG until the conversion is done, then reads the result: a state machine run from callbacks.
+struct AsyncConversion {
+    LockedQueue* queue;
+    ADS1X15::ADS1115Transactions adc;
+    int depthInCallbacks = 0;
+    int polls            = 0;
+    int16_t result       = 0;
+    bool done            = false;
+
+    static void onStarted(const ADS1X15::I2CTransaction&, void* context) { poll(context); }
+
+    static void onConfig(const ADS1X15::I2CTransaction& t, void* context) {
+        AsyncConversion* c = static_cast<AsyncConversion*>(context);
+        c->depthInCallbacks += c->queue->lock().depth;
+        c->polls++;
+        if (ADS1X15::ADS1115Transactions::conversionComplete(t)) {
+            c->queue->submit(c->adc.readConversion(onResult, c));
+        } else {
+            poll(context);
+        }
+    }
+
+    static void onResult(const ADS1X15::I2CTransaction& t, void* context) {
+        AsyncConversion* c = static_cast<AsyncConversion*>(context);
+        c->result          = ADS1X15::ADS1115Transactions::count(t);
+        c->done            = true;
+    }
+
+    static void poll(void* context) {
+        AsyncConversion* c = static_cast<AsyncConversion*>(context);
+        c->queue->submit(c->adc.readConfig(onConfig, c));
+    }
+};
+} // namespace
+
+TEST(AsyncI2C, CallbacksCanChainTransactionsOutsideTheLock) {
+    AsyncRig rig;
+    LockedQueue queue(rig.controller);
+    AsyncConversion conversion{&queue, rig.adcs[2]};
+    ASSERT_TRUE(queue.submit(rig.adcs[2].startReading(ASYNC_ENTRY, AsyncConversion::onStarted, &conversion)));
+    rig.controller.runUntilIdle();
+    EXPECT_TRUE(conversion.done);
+    EXPECT_GT(conversion.polls, 1);
+    EXPECT_EQ(conversion.depthInCallbacks, 0);
+    EXPECT_EQ(queue.lock().depth, 0);
+    EXPECT_GT(queue.lock().locks, 0);
+    EXPECT_EQ(conversion.result, static_cast<int16_t>(std::lround(0.3 / 2.048 * 32768)));
+}
+
 // ===========================================================================
 
 int main(int argc, char** argv) {
@@ -0,0 +1,227 @@
+/**
+ * Tests for the C++20 coroutine awaitables (ADS1X15Coroutine.h).
+ *
+ * Built separately with -std=c++20: pio test -e native_test_cpp20
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#if defined(__cpp_impl_coroutine)
+
+#include "ADS1X15.h"
+#include "ADS1X15Coroutine.h"
+#include "ADS1X15Simulator.h"
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// Counts heap allocations while armed, to check that pooled tasks never allocate.
+static std::atomic<bool> gCountAllocations{false};
+static std::atomic<uint32_t> gAllocations{0};
+
+void* operator new(size_t size) {
+    if (gCountAllocations.load()) { gAllocations++; }
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) { throw std::bad_alloc(); }
+    return p;
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    if (gCountAllocations.load()) { gAllocations++; }
+    return std::malloc(size == 0 ? 1 : size);
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+using Driver = ADS1X15::ADS1115<ADS1X15::SimulatedWire>;
+using Async  = ADS1X15::AsyncAdc<Driver>;
+
+ADS1X15::SimulatedWire* gBus = nullptr;
+uint32_t busMicros() { return gBus->micros(); }
+
+int16_t expectedCount(double volts) { return static_cast<int16_t>(std::lround(volts / 2.048 * 32768)); }
+
+// Four ADS1115s on one simulated bus, each channel at its own constant voltage.
+struct Rig {
+    ADS1X15::SimulatedWire bus{1000000};
+    std::deque<ADS1X15::SimulatedDevice> chips;
+    std::deque<Driver> drivers;
+    ADS1X15::ConversionScheduler scheduler{busMicros};
+    std::deque<Async> adcs;
+
+    explicit Rig(size_t count = 4) {
+        gBus = &bus;
+        for (size_t d = 0; d < count; d++) {
+            uint8_t address = static_cast<uint8_t>(0x48 + d);
+            chips.emplace_back(ADS1X15::ADS1115Traits{}, address);
+            for (uint8_t ch = 0; ch < 4; ch++) {
+                chips.back().setInputVoltage(ADS1X15::MUX_BY_CHANNEL[ch], volts(d, ch));
+            }
+            chips.back().setInputVoltage(static_cast<uint16_t>(ADS1X15::DifferentialPair::PAIR_01), DIFF_VOLTS);
+            bus.attach(chips.back());
+            drivers.emplace_back(bus);
+            drivers.back().begin(address);
+            drivers.back().setGain(ADS1X15::Gain::TWO_2048MV);
+            drivers.back().setDataRate(ADS1X15::Rate::ADS1115_860SPS);
+            adcs.emplace_back(drivers.back(), scheduler);
+        }
+    }
+
+    static constexpr double DIFF_VOLTS = -0.05;
+
+    static double volts(size_t device, uint8_t channel) { return 0.1 * (device + 1) + 0.02 * channel; }
+
+    // Runs the scheduler until nothing is pending, advancing the bus clock when a pass resumes nothing.
+    void drain() {
+        while (scheduler.pending() > 0) {
+            if (scheduler.poll() == 0) { bus.advanceMicros(10); }
+        }
+    }
+};
+
+ADS1X15::ConversionTask readInto(Async& adc, uint8_t channel, ADS1X15::ReadResult& out) {
+    out = co_await adc.readSingleEnded(channel);
+}
+
+template <typename Task> Task pooledRead(Async& adc, uint8_t channel, ADS1X15::ReadResult& out) {
+    out = co_await adc.readSingleEnded(channel);
+}
+
+ADS1X15::ConversionTask readTwice(Async& adc, int16_t& sum, int& steps) {
+    ADS1X15::ReadResult a = co_await adc.readSingleEnded(0);
+    steps++;
+    ADS1X15::ReadResult b = co_await adc.readDifferential(ADS1X15::DifferentialPair::PAIR_01);
+    steps++;
+    sum = static_cast<int16_t>(a.value + b.value);
+}
+
+} // namespace
+
+TEST(Coroutine, AwaitedReadReturnsConversionResult) {
+    Rig rig(1);
+    ADS1X15::ReadResult result{ADS1X15::Status::TIMEOUT, 0};
+    ADS1X15::ConversionTask task = readInto(rig.adcs[0], 2, result);
+    EXPECT_FALSE(task.done());
+    EXPECT_EQ(rig.scheduler.pending(), 1u);
+    rig.drain();
+    EXPECT_TRUE(task.done());
+    EXPECT_TRUE(result.ok());
+    EXPECT_EQ(result.value, expectedCount(Rig::volts(0, 2)));
+}
+
+TEST(Coroutine, SequentialAwaitsInOneCoroutine) {
+    Rig rig(1);
+    int16_t sum = 0;
+    int steps   = 0;
+    ADS1X15::ConversionTask task = readTwice(rig.adcs[0], sum, steps);
+    rig.drain();
+    EXPECT_TRUE(task.done());
+    EXPECT_EQ(steps, 2);
+    EXPECT_EQ(sum, expectedCount(Rig::volts(0, 0)) + expectedCount(Rig::DIFF_VOLTS));
+}
+
+TEST(Coroutine, ThousandReadsOnOneThreadWithoutHeapAllocation) {
+    constexpr size_t TASKS = 1000;
+    using Pool = ADS1X15::FramePool<256, TASKS>;
+    using Task = ADS1X15::BasicConversionTask<Pool>;
+    Rig rig;
+    std::vector<ADS1X15::ReadResult> results(TASKS, ADS1X15::ReadResult{ADS1X15::Status::TIMEOUT, 0});
+    std::vector<Task> tasks;
+    tasks.reserve(TASKS);
+
+    // The simulated bus grows its transfer buffers on first use; get that out of the way.
+    for (Async& adc : rig.adcs) {
+        ADS1X15::ReadResult warmUp{ADS1X15::Status::TIMEOUT, 0};
+        ADS1X15::ConversionTask task = readInto(adc, 0, warmUp);
+        rig.drain();
+    }
+
+    gAllocations      = 0;
+    gCountAllocations = true;
+    for (size_t i = 0; i < TASKS; i++) {
+        tasks.push_back(pooledRead<Task>(rig.adcs[i % 4], static_cast<uint8_t>(i / 4 % 4), results[i]));
+    }
+    EXPECT_EQ(rig.scheduler.pending(), TASKS);
+    uint64_t start = rig.bus.nanos();
+    rig.drain();
+    gCountAllocations = false;
+    EXPECT_EQ(gAllocations.load(), 0u);
+    EXPECT_EQ(Pool::used(), TASKS);
+
+    for (size_t i = 0; i < TASKS; i++) {
+        ASSERT_TRUE(tasks[i].valid());
+        EXPECT_TRUE(tasks[i].done());
+        EXPECT_TRUE(results[i].ok());
+        EXPECT_EQ(results[i].value, expectedCount(Rig::volts(i % 4, static_cast<uint8_t>(i / 4 % 4))));
+    }
+    // The four chips convert in parallel: 250 conversions each at 860 SPS take well under a second of bus time.
+    double seconds = (rig.bus.nanos() - start) / 1e9;
+    EXPECT_LT(seconds, 250 * 1.25 / 860);
+    for (const ADS1X15::SimulatedDevice& chip : rig.chips) { EXPECT_EQ(chip.conversions(), TASKS / 4 + 1); }
+
+    tasks.clear();
+    EXPECT_EQ(Pool::used(), 0u);
+}
+
+TEST(Coroutine, ExhaustedPoolLeavesTaskUnstarted) {
+    using Pool = ADS1X15::FramePool<256, 1>;
+    using Task = ADS1X15::BasicConversionTask<Pool>;
+    Rig rig(1);
+    ADS1X15::ReadResult a{ADS1X15::Status::TIMEOUT, 0};
+    ADS1X15::ReadResult b{ADS1X15::Status::TIMEOUT, 0};
+    Task first  = pooledRead<Task>(rig.adcs[0], 0, a);
+    Task second = pooledRead<Task>(rig.adcs[0], 1, b);
+    EXPECT_TRUE(first.valid());
+    EXPECT_FALSE(second.valid());
+    EXPECT_TRUE(second.done());
+    EXPECT_EQ(rig.scheduler.pending(), 1u);
+    rig.drain();
+    EXPECT_TRUE(a.ok());
+}
+
+TEST(Coroutine, ReadyNotificationSkipsStatusPoll) {
+    Rig rig(1);
+    ADS1X15::ReadResult result{ADS1X15::Status::TIMEOUT, 0};
+    ADS1X15::ConversionTask task = readInto(rig.adcs[0], 1, result);
+    rig.bus.advanceMicros(2000);
+    rig.bus.resetStats();
+    rig.adcs[0].notifyReady();
+    EXPECT_EQ(rig.scheduler.poll(), 1u);
+    // Only the result read (pointer write + read) went on the bus, no CONFIG read for the OS bit.
+    EXPECT_EQ(rig.bus.transactions(), 2u);
+    EXPECT_TRUE(task.done());
+    EXPECT_EQ(result.value, expectedCount(Rig::volts(0, 1)));
+}
+
+TEST(Coroutine, FailedStartResumesWithError) {
+    Rig rig(1);
+    Driver absent(rig.bus);
+    absent.begin(0x4B);
+    Async adc(absent, rig.scheduler);
+    ADS1X15::ReadResult result{ADS1X15::Status::OK, 123};
+    ADS1X15::ConversionTask task = readInto(adc, 0, result);
+    EXPECT_TRUE(task.done());
+    EXPECT_FALSE(result.ok());
+    EXPECT_EQ(rig.scheduler.pending(), 0u);
+}
+
+#else
+
+TEST(Coroutine, SkippedWithoutCpp20) { GTEST_SKIP() << "Needs -std=c++20"; }
+
+#endif
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}